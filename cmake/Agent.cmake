@@ -89,6 +89,9 @@ add_library(core
   fboss/agent/NdpCache.cpp
   fboss/agent/NeighborUpdater.cpp
   fboss/agent/NeighborUpdaterImpl.cpp
+  fboss/agent/NetlinkBatch.cpp
+  fboss/agent/NeighborResolutionLimiter.cpp
+  fboss/agent/TxPacketTemplate.cpp
   fboss/agent/PortUpdateHandler.cpp
   fboss/agent/ResolvedNexthopMonitor.cpp
   fboss/agent/ResolvedNexthopProbe.cpp
@@ -125,6 +128,7 @@ target_link_libraries(core
   standalone_rib
   state
   state_utils
+  warmboot_journal
   exponential_back_off
   fboss_config_utils
   phy_cpp2
@@ -135,6 +139,16 @@ target_link_libraries(core
   ${NETLINKROUTE3}
 )
 
+add_library(warmboot_journal
+  fboss/agent/WarmBootJournal.cpp
+)
+
+target_link_libraries(warmboot_journal
+  error
+  state
+  Folly::folly
+)
+
 add_library(error
   fboss/agent/FbossError.h
 )
@@ -68,6 +68,7 @@ add_library(bcm
   fboss/agent/hw/bcm/BcmTrunkStats.cpp
   fboss/agent/hw/bcm/BcmTrunkTable.cpp
   fboss/agent/hw/bcm/BcmTxPacket.cpp
+  fboss/agent/hw/bcm/BcmTxPacketPool.cpp
   fboss/agent/hw/bcm/BcmQosUtils.cpp
   fboss/agent/hw/bcm/BcmUnit.cpp
   fboss/agent/hw/bcm/BcmWarmBootCache.cpp
@@ -23,6 +23,7 @@ target_link_libraries(standalone_rib
   ctrl_cpp2
   label_forwarding_action
   state_utils
+  interner
   Folly::folly
 )
 
@@ -69,6 +69,7 @@ target_link_libraries(state
   state_utils
   radix_tree
   phy_cpp2
+  interner
   Folly::folly
 )
 
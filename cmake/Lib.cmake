@@ -27,6 +27,16 @@ add_library(ref_map
 
 set_target_properties(ref_map PROPERTIES LINKER_LANGUAGE CXX)
 
+add_library(interner
+  fboss/lib/Interner.h
+)
+
+target_link_libraries(interner
+  Folly::folly
+)
+
+set_target_properties(interner PROPERTIES LINKER_LANGUAGE CXX)
+
 add_library(tuple_utils
   fboss/lib/TupleUtils.h
 )
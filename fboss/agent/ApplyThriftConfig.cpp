@@ -50,6 +50,7 @@
 #include <folly/Range.h>
 #include <algorithm>
 #include <cmath>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -75,6 +76,129 @@ namespace {
 const uint8_t kV6LinkLocalAddrMask{64};
 // Needed until CoPP is removed from code and put into config
 const int kAclStartPriority = 100000;
+// Space left between the priorities of ACLs numbered from scratch, so that
+// ACLs added later can be slotted in without moving the existing ones.
+const int kAclPriorityGap = 16;
+// Data plane ACLs may move up to here to make room for ACLs inserted at the
+// top. CoPP ACLs, which must come first, stay below.
+const int kAclMinPriority = kAclStartPriority / 2;
+const int kCoppAclStartPriority = kAclStartPriority / 4;
+
+/*
+ * Allocate strictly increasing priorities to ACLs in config order, given the
+ * priority each ACL currently has, if any. The longest run of existing
+ * priorities that is still in order is kept, and the other ACLs are fitted in
+ * the gaps around them. Keeping priorities stable matters because hardware
+ * can not modify a programmed ACL, so a changed priority means a remove and
+ * add. If the new ACLs do not fit, everything is renumbered from `start`.
+ */
+std::vector<int> allocateAclPriorities(
+    const std::vector<std::optional<int>>& existing,
+    int start,
+    int minPriority,
+    int maxPriority) {
+  auto usable = [&](size_t i) {
+    return existing[i] && *existing[i] >= minPriority &&
+        *existing[i] < maxPriority;
+  };
+
+  // Longest increasing subsequence of the usable existing priorities
+  std::vector<size_t> tails;
+  std::vector<int> prev(existing.size(), -1);
+  for (size_t i = 0; i < existing.size(); ++i) {
+    if (!usable(i)) {
+      continue;
+    }
+    auto tail = std::lower_bound(
+        tails.begin(), tails.end(), *existing[i], [&](size_t j, int prio) {
+          return *existing[j] < prio;
+        });
+    if (tail != tails.begin()) {
+      prev[i] = *(tail - 1);
+    }
+    if (tail == tails.end()) {
+      tails.push_back(i);
+    } else {
+      *tail = i;
+    }
+  }
+  std::vector<size_t> kept;
+  for (int i = tails.empty() ? -1 : tails.back(); i >= 0; i = prev[i]) {
+    kept.push_back(i);
+  }
+  std::reverse(kept.begin(), kept.end());
+
+  std::vector<int> priorities(existing.size());
+  // Spread the ACLs in [begin, end) evenly over (lo, hi)
+  auto spread = [&](size_t begin, size_t end, int64_t lo, int64_t hi) {
+    auto step = (hi - lo) / static_cast<int64_t>(end - begin + 1);
+    if (step == 0) {
+      return false;
+    }
+    for (auto i = begin; i < end; ++i) {
+      priorities[i] = lo + step * static_cast<int64_t>(i - begin + 1);
+    }
+    return true;
+  };
+
+  bool fits = !kept.empty();
+  size_t begin = 0;
+  for (size_t k = 0; fits && k <= kept.size(); ++k) {
+    auto end = k < kept.size() ? kept[k] : existing.size();
+    auto count = static_cast<int64_t>(end - begin);
+    if (count > 0) {
+      if (k == 0) {
+        // Leading ACLs: stack them up above the first kept ACL
+        int64_t hi = *existing[end];
+        if (hi - kAclPriorityGap * count >= minPriority) {
+          for (auto i = begin; i < end; ++i) {
+            int64_t above = end - i;
+            priorities[i] = hi - kAclPriorityGap * above;
+          }
+        } else {
+          fits = spread(begin, end, minPriority - 1, hi);
+        }
+      } else if (k == kept.size()) {
+        // Trailing ACLs: append them after the last kept ACL
+        int64_t lo = *existing[begin - 1];
+        if (lo + kAclPriorityGap * count < maxPriority) {
+          for (auto i = begin; i < end; ++i) {
+            int64_t below = i - begin + 1;
+            priorities[i] = lo + kAclPriorityGap * below;
+          }
+        } else {
+          fits = spread(begin, end, lo, maxPriority);
+        }
+      } else {
+        fits = spread(begin, end, *existing[begin - 1], *existing[end]);
+      }
+    }
+    if (k < kept.size()) {
+      priorities[end] = *existing[end];
+      begin = end + 1;
+    }
+  }
+  if (fits) {
+    return priorities;
+  }
+
+  if (!kept.empty()) {
+    XLOG(DBG2) << "No room to keep ACL priorities stable, renumbering "
+               << existing.size() << " ACLs";
+  }
+  for (size_t i = 0; i < existing.size(); ++i) {
+    int64_t priority = start + kAclPriorityGap * static_cast<int64_t>(i);
+    if (priority >= maxPriority) {
+      throw FbossError(
+          "Too many ACLs: ",
+          existing.size(),
+          " ACLs do not fit below priority ",
+          maxPriority);
+    }
+    priorities[i] = priority;
+  }
+  return priorities;
+}
 
 void updateFibFromConfig(
     facebook::fboss::RouterID vrf,
@@ -1415,20 +1539,22 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls() {
   AclMap::NodeContainer newAcls;
   bool changed = false;
   int numExistingProcessed = 0;
-  int priority = kAclStartPriority;
-  int cpuPriority = 1;
+
+  struct PendingAcl {
+    const cfg::AclEntry* config;
+    std::optional<MatchAction> action;
+  };
+  // ACLs in the order they should match. CoPP ACLs come first and are
+  // numbered separately from the rest.
+  std::vector<PendingAcl> coppAcls;
+  std::vector<PendingAcl> dataPlaneAcls;
 
   // Start with the DROP acls, these should have highest priority
-  auto acls = folly::gen::from(cfg_->acls) |
-      folly::gen::filter([](const cfg::AclEntry& entry) {
-                return entry.actionType == cfg::AclActionType::DENY;
-              }) |
-      folly::gen::map([&](const cfg::AclEntry& entry) {
-                auto acl = updateAcl(
-                    entry, priority++, &numExistingProcessed, &changed);
-                return std::make_pair(acl->getID(), acl);
-              }) |
-      folly::gen::appendTo(newAcls);
+  for (const auto& entry : cfg_->acls) {
+    if (entry.actionType == cfg::AclActionType::DENY) {
+      dataPlaneAcls.push_back(PendingAcl{&entry, std::nullopt});
+    }
+  }
 
   // Let's get a map of acls to name so we don't have to search the acl list
   // for every new use
@@ -1446,9 +1572,8 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls() {
 
   // Generates new acls from template
   auto addToAcls = [&](const cfg::TrafficPolicyConfig& policy,
-                       bool isCoppAcl = false)
-      -> const std::vector<std::pair<std::string, std::shared_ptr<AclEntry>>> {
-    std::vector<std::pair<std::string, std::shared_ptr<AclEntry>>> entries;
+                       std::vector<PendingAcl>* entries,
+                       bool isCoppAcl = false) {
     for (const auto& mta : policy.matchToAction) {
       auto a = aclByName.find(mta.matcher);
       if (a == aclByName.end()) {
@@ -1456,10 +1581,10 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls() {
             "Invalid config: No acl named ", mta.matcher, " found.");
       }
 
-      auto aclCfg = *(a->second);
+      auto aclCfg = a->second;
 
       // We've already added any DENY acls
-      if (aclCfg.actionType == cfg::AclActionType::DENY) {
+      if (aclCfg->actionType == cfg::AclActionType::DENY) {
         continue;
       }
 
@@ -1487,13 +1612,43 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls() {
       if (auto egressMirror = mta.action.egressMirror_ref()) {
         matchAction.setEgressMirror(*egressMirror);
       }
+      entries->push_back(PendingAcl{aclCfg, std::move(matchAction)});
+    }
+  };
+
+  // Add controlPlane traffic acls
+  if (cfg_->cpuTrafficPolicy_ref() &&
+      cfg_->cpuTrafficPolicy_ref()->trafficPolicy_ref()) {
+    addToAcls(
+        *cfg_->cpuTrafficPolicy_ref()->trafficPolicy_ref(), &coppAcls, true);
+  }
 
+  // Add dataPlane traffic acls
+  if (auto dataPlaneTrafficPolicy = cfg_->dataPlaneTrafficPolicy_ref()) {
+    addToAcls(*dataPlaneTrafficPolicy, &dataPlaneAcls);
+  }
+
+  auto addAcls = [&](const std::vector<PendingAcl>& pendingAcls,
+                     int startPriority,
+                     int minPriority,
+                     int maxPriority) {
+    std::vector<std::optional<int>> existing;
+    for (const auto& pendingAcl : pendingAcls) {
+      auto origAcl = orig_->getAcls()->getEntryIf(pendingAcl.config->name);
+      existing.push_back(
+          origAcl ? std::make_optional(origAcl->getPriority()) : std::nullopt);
+    }
+    auto priorities = allocateAclPriorities(
+        existing, startPriority, minPriority, maxPriority);
+
+    for (size_t i = 0; i < pendingAcls.size(); ++i) {
+      const auto& action = pendingAcls[i].action;
       auto acl = updateAcl(
-          aclCfg,
-          isCoppAcl ? cpuPriority++ : priority++,
+          *pendingAcls[i].config,
+          priorities[i],
           &numExistingProcessed,
           &changed,
-          &matchAction);
+          action ? &action.value() : nullptr);
 
       if (acl->getAclAction().has_value()) {
         const auto& inMirror = acl->getAclAction().value().getIngressMirror();
@@ -1507,24 +1662,16 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls() {
           throw FbossError("Mirror ", egMirror.value(), " is undefined");
         }
       }
-      entries.push_back(std::make_pair(acl->getID(), acl));
+      newAcls.emplace(acl->getID(), acl);
     }
-    return entries;
   };
+  addAcls(coppAcls, kCoppAclStartPriority, 1, kAclMinPriority);
+  addAcls(
+      dataPlaneAcls,
+      kAclStartPriority,
+      kAclMinPriority,
+      AclEntryFields::kMaxPriority);
 
-  // Add controlPlane traffic acls
-  if (cfg_->cpuTrafficPolicy_ref() &&
-      cfg_->cpuTrafficPolicy_ref()->trafficPolicy_ref()) {
-    folly::gen::from(
-        addToAcls(*cfg_->cpuTrafficPolicy_ref()->trafficPolicy_ref(), true)) |
-        folly::gen::appendTo(newAcls);
-  }
-
-  // Add dataPlane traffic acls
-  if (auto dataPlaneTrafficPolicy = cfg_->dataPlaneTrafficPolicy_ref()) {
-    folly::gen::from(addToAcls(*dataPlaneTrafficPolicy)) |
-        folly::gen::appendTo(newAcls);
-  }
   if (numExistingProcessed != orig_->getAcls()->size()) {
     // Some existing ACLs were removed.
     changed = true;
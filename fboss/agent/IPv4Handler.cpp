@@ -19,6 +19,7 @@
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/IPHeaderV4.h"
+#include "fboss/agent/NeighborResolutionLimiter.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/PortStats.h"
@@ -283,6 +284,11 @@ bool IPv4Handler::resolveMac(
         auto entry = vlan->getArpTable()->getEntryIf(target);
         if (entry == nullptr) {
           // No entry in ARP table, send ARP request
+          if (!sw_->getNeighborResolutionLimiter()->shouldSend(
+                  vlanID, target, sw_->stats())) {
+            // Already in flight, or rate limited
+            continue;
+          }
           auto mac = intf->getMac();
           ArpHandler::sendArpRequest(sw_, vlanID, mac, source, target);
 
@@ -14,6 +14,7 @@
 #include <folly/logging/xlog.h>
 #include "fboss/agent/DHCPv6Handler.h"
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/NeighborResolutionLimiter.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/RxPacket.h"
@@ -785,6 +786,11 @@ void IPv6Handler::resolveDestAndHandlePacket(
           auto entry = vlan->getNdpTable()->getEntryIf(target);
           if (nullptr == entry) {
             // No entry in NDP table, create a neighbor solicitation packet
+            if (!sw_->getNeighborResolutionLimiter()->shouldSend(
+                    vlanID, target, sw_->stats())) {
+              // Already in flight, or rate limited
+              continue;
+            }
             sendMulticastNeighborSolicitation(
                 sw_, target, intf->getMac(), vlan->getID());
             // Notify the updater that we sent a solicitation out
@@ -837,6 +843,11 @@ void IPv6Handler::sendMulticastNeighborSolicitations(
         auto entry = vlan->getNdpTable()->getEntryIf(target);
         if (entry == nullptr) {
           // No entry in NDP table, create a neighbor solicitation packet
+          if (!sw_->getNeighborResolutionLimiter()->shouldSend(
+                  vlanID, target, sw_->stats())) {
+            // Already in flight, or rate limited
+            continue;
+          }
           sendMulticastNeighborSolicitation(
               sw_, target, intf->getMac(), vlan->getID());
 
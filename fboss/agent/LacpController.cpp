@@ -86,6 +86,7 @@ void LacpController::stopMachines() {
     self->periodicTx_.stop();
     self->rx_.stop();
     self->selector_.stop();
+    self->machinesStopped_ = true;
   });
 }
 
@@ -111,8 +112,11 @@ void LacpController::portDown() {
 }
 
 void LacpController::received(const LACPDU& lacpdu) {
-  evb()->runInEventBaseThread(
-      [self = shared_from_this(), lacpdu]() { self->rx_.rx(lacpdu); });
+  evb()->runInEventBaseThread([self = shared_from_this(), lacpdu]() {
+    if (!self->machinesStopped_) {
+      self->rx_.rx(lacpdu);
+    }
+  });
 }
 
 ParticipantInfo LacpController::actorInfo() const {
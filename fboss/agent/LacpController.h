@@ -90,6 +90,9 @@ class LacpController : public std::enable_shared_from_this<LacpController> {
   const ParticipantInfo::SystemPriority systemPriority_{0};
 
   LacpState actorState_{LacpState::NONE};
+  // Frames may still be handed to us after the machines are stopped, since
+  // LinkAggregationManager looks us up without locking on the RX path
+  bool machinesStopped_{false};
 
   TransmitMachine tx_;
   ReceiveMachine rx_;
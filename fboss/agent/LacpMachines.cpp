@@ -143,7 +143,7 @@ const std::chrono::seconds ReceiveMachine::SLOW_EPOCH_DURATION(90);
 ReceiveMachine::ReceiveMachine(
     LacpController& controller,
     folly::EventBase* evb)
-    : folly::AsyncTimeout(evb), controller_(controller) {}
+    : LacpTimeout(evb), controller_(controller) {}
 
 ReceiveMachine::~ReceiveMachine() {}
 
@@ -374,7 +374,7 @@ const std::chrono::seconds PeriodicTransmissionMachine::LONG_PERIOD(30);
 PeriodicTransmissionMachine::PeriodicTransmissionMachine(
     LacpController& controller,
     folly::EventBase* evb)
-    : folly::AsyncTimeout(evb), controller_(controller) {}
+    : LacpTimeout(evb), controller_(controller) {}
 
 PeriodicTransmissionMachine::~PeriodicTransmissionMachine() {}
 
@@ -465,7 +465,7 @@ TransmitMachine::TransmitMachine(
     LacpController& controller,
     folly::EventBase* evb,
     LacpServicerIf* servicer)
-    : folly::AsyncTimeout(evb), controller_(controller), servicer_(servicer) {}
+    : LacpTimeout(evb), controller_(controller), servicer_(servicer) {}
 
 TransmitMachine::~TransmitMachine() {}
 
@@ -515,7 +515,7 @@ MuxMachine::MuxMachine(
     LacpController& controller,
     folly::EventBase* evb,
     LacpServicerIf* servicer)
-    : AsyncTimeout(evb), controller_(controller), servicer_(servicer) {}
+    : LacpTimeout(evb), controller_(controller), servicer_(servicer) {}
 
 MuxMachine::~MuxMachine() {}
 
@@ -9,7 +9,9 @@
  */
 #pragma once
 
-#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/io/async/HHWheelTimer.h>
+#include <chrono>
 #include <optional>
 
 #include <boost/container/flat_map.hpp>
@@ -30,7 +32,29 @@ class LacpServicerIf;
  * See IEEE 802.3AD-2000 43.4.3 for an overview of each state machine
  */
 
-class ReceiveMachine : private folly::AsyncTimeout {
+/*
+ * Timeout of a LACP state machine. Rather than each machine of each member
+ * port arming its own EventBase timer, all machines are scheduled on the LACP
+ * EventBase's timing wheel, which expires every timeout due in a tick as one
+ * batch, with no per timeout cost in the EventBase itself.
+ */
+class LacpTimeout : public folly::HHWheelTimer::Callback {
+ public:
+  explicit LacpTimeout(folly::EventBase* evb) : evb_(evb) {}
+
+  void scheduleTimeout(std::chrono::milliseconds timeout) {
+    evb_->timer().scheduleTimeout(this, timeout);
+  }
+
+ private:
+  // Invoked if the wheel is destroyed while we are scheduled. That is not an
+  // expiry, so unlike the default don't run timeoutExpired().
+  void callbackCanceled() noexcept override {}
+
+  folly::EventBase* evb_{nullptr};
+};
+
+class ReceiveMachine : private LacpTimeout {
  public:
   explicit ReceiveMachine(LacpController& controller, folly::EventBase* evb);
   ~ReceiveMachine() override;
@@ -93,7 +117,7 @@ class ReceiveMachine : private folly::AsyncTimeout {
 void toAppend(ReceiveMachine::ReceiveState state, std::string* result);
 std::ostream& operator<<(std::ostream& out, ReceiveMachine::ReceiveState s);
 
-class PeriodicTransmissionMachine : private folly::AsyncTimeout {
+class PeriodicTransmissionMachine : private LacpTimeout {
  public:
   explicit PeriodicTransmissionMachine(
       LacpController& controller,
@@ -127,7 +151,7 @@ void toAppend(
     PeriodicTransmissionMachine::PeriodicState state,
     std::string* result);
 
-class TransmitMachine : private folly::AsyncTimeout {
+class TransmitMachine : private LacpTimeout {
  public:
   TransmitMachine(
       LacpController& controller,
@@ -154,7 +178,7 @@ class TransmitMachine : private folly::AsyncTimeout {
   LacpServicerIf* servicer_{nullptr};
 };
 
-class MuxMachine : private folly::AsyncTimeout {
+class MuxMachine : private LacpTimeout {
  public:
   MuxMachine(
       LacpController& controller,
@@ -91,6 +91,21 @@ std::string LACPDU::describe() const {
       maxDelay);
 }
 
+bool LACPDU::operator==(const LACPDU& rhs) const {
+  return version == rhs.version && actorType == rhs.actorType &&
+      actorInfoLength == rhs.actorInfoLength && actorInfo == rhs.actorInfo &&
+      actorReserved == rhs.actorReserved && partnerType == rhs.partnerType &&
+      partnerInfoLength == rhs.partnerInfoLength &&
+      partnerInfo == rhs.partnerInfo &&
+      partnerReserved == rhs.partnerReserved &&
+      collectorType == rhs.collectorType &&
+      collectorLength == rhs.collectorLength && maxDelay == rhs.maxDelay &&
+      collectorReserved == rhs.collectorReserved &&
+      terminatorType == rhs.terminatorType &&
+      terminatorLength == rhs.terminatorLength &&
+      terminatorReserved == rhs.terminatorReserved;
+}
+
 LinkAggregationGroupID LinkAggregationGroupID::from(
     const ParticipantInfo& actorInfo,
     const ParticipantInfo& partnerInfo) {
@@ -125,6 +125,8 @@ struct LACPDU {
 
   std::string describe() const;
 
+  bool operator==(const LACPDU& rhs) const;
+
   static const folly::MacAddress& kSlowProtocolsDstMac() {
     static const folly::MacAddress slowProtocolsDstMac("01:80:c2:00:00:02");
     return slowProtocolsDstMac;
@@ -31,6 +31,15 @@
 #include <tuple>
 #include <utility>
 
+namespace {
+// Offsets of the actor and partner state in a .1q tagged LACP frame: 18
+// bytes of ethernet header, the subtype, the version, and the actor TLV with
+// the state as last byte of its 15 bytes of information, followed by the
+// partner TLV likewise.
+constexpr size_t kActorStateOffset = 18 + 1 + 1 + 2 + 14;
+constexpr size_t kPartnerStateOffset = kActorStateOffset + 1 + 3 + 2 + 14;
+} // namespace
+
 namespace facebook::fboss {
 
 void LinkAggregationManager::recordStatistics(
@@ -106,11 +115,17 @@ void LinkAggregationManager::handlePacket(
     std::unique_ptr<RxPacket> pkt,
     folly::io::Cursor c) {
   // TODO(samank): check this is running in RX thread?
-  folly::SharedMutexWritePriority::ReadHolder g(&controllersLock_);
+  auto portToController = rxPortToController_.load();
   auto ingressPort = pkt->getSrcPort();
 
-  auto it = portToController_.find(ingressPort);
-  if (it == portToController_.end()) {
+  std::shared_ptr<LacpController> controller;
+  if (portToController) {
+    auto it = portToController->find(ingressPort);
+    if (it != portToController->end()) {
+      controller = it->second;
+    }
+  }
+  if (!controller) {
     XLOG(ERR) << "No LACP controller found for port " << ingressPort;
     return;
   }
@@ -121,7 +136,7 @@ void LinkAggregationManager::handlePacket(
     return;
   }
 
-  it->second->received(lacpdu);
+  controller->received(lacpdu);
 }
 
 void LinkAggregationManager::stateUpdated(const StateDelta& delta) {
@@ -165,6 +180,7 @@ void LinkAggregationManager::aggregatePortAdded(
     CHECK(inserted);
     it->second->startMachines();
   }
+  publishControllers();
 }
 
 void LinkAggregationManager::aggregatePortRemoved(
@@ -175,7 +191,16 @@ void LinkAggregationManager::aggregatePortRemoved(
     CHECK_NE(it, portToController_.end());
     it->second->stopMachines();
     portToController_.erase(it);
+    // With its machines stopped, nothing transmits on the port anymore
+    sw_->getLacpEvb()->runInEventBaseThreadAndWait(
+        [this, portID = subport.portID]() { lacpFrames_.erase(portID); });
   }
+  publishControllers();
+}
+
+void LinkAggregationManager::publishControllers() {
+  rxPortToController_.store(
+      std::make_shared<const PortIDToController>(portToController_));
 }
 
 void LinkAggregationManager::aggregatePortChanged(
@@ -288,29 +313,51 @@ void LinkAggregationManager::populatePartnerPairs(
 bool LinkAggregationManager::transmit(LACPDU lacpdu, PortID portID) {
   CHECK(sw_->getLacpEvb()->inRunningEventBaseThread());
 
-  auto pkt = sw_->allocatePacket(LACPDU::LENGTH);
-  if (!pkt) {
-    XLOG(DBG4) << "Failed to allocate tx packet for LACPDU transmission";
-    return false;
-  }
-
-  folly::io::RWPrivateCursor writer(pkt->buf());
-
   folly::MacAddress cpuMac = sw_->getPlatform()->getLocalMac();
 
   auto port = sw_->getState()->getPorts()->getPortIf(portID);
   CHECK(port);
+  auto vlan = port->getIngressVlan();
+
+  // Actor and partner state change far more often than the rest of the
+  // LACPDU, so leave them out of the cached frame
+  auto stateless = lacpdu;
+  stateless.actorInfo.state = LacpState::NONE;
+  stateless.partnerInfo.state = LacpState::NONE;
+
+  auto& lacpFrame = lacpFrames_[portID];
+  if (lacpFrame.frame.empty() || lacpFrame.vlan != vlan ||
+      lacpFrame.cpuMac != cpuMac || !(lacpFrame.lacpdu == stateless)) {
+    folly::IOBuf buf(folly::IOBuf::CREATE, LACPDU::LENGTH);
+    buf.append(LACPDU::LENGTH);
+    folly::io::RWPrivateCursor writer(&buf);
+
+    TxPacket::writeEthHeader(
+        &writer,
+        LACPDU::kSlowProtocolsDstMac(),
+        cpuMac,
+        vlan,
+        LACPDU::EtherType::SLOW_PROTOCOLS);
+
+    writer.writeBE<uint8_t>(LACPDU::EtherSubtype::LACP);
+
+    stateless.to(&writer);
+
+    lacpFrame = LacpFrame{
+        vlan,
+        cpuMac,
+        stateless,
+        TxPacketTemplate(folly::ByteRange(buf.data(), buf.length()))};
+  }
 
-  TxPacket::writeEthHeader(
-      &writer,
-      LACPDU::kSlowProtocolsDstMac(),
-      cpuMac,
-      port->getIngressVlan(),
-      LACPDU::EtherType::SLOW_PROTOCOLS);
-
-  writer.writeBE<uint8_t>(LACPDU::EtherSubtype::LACP);
-
-  lacpdu.to(&writer);
+  auto pkt = lacpFrame.frame.instantiate(sw_);
+  if (!pkt) {
+    XLOG(DBG4) << "Failed to allocate tx packet for LACPDU transmission";
+    return false;
+  }
+  auto data = pkt->buf()->writableData();
+  data[kActorStateOffset] = static_cast<uint8_t>(lacpdu.actorInfo.state);
+  data[kPartnerStateOffset] = static_cast<uint8_t>(lacpdu.partnerInfo.state);
 
   // TODO(joseph5wu) Actually LACP should be multicast pkt, and using
   // OutOfPacket will actually send the packet to unicast queue.
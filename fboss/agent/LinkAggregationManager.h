@@ -11,12 +11,16 @@
 
 #include "fboss/agent/LacpTypes.h"
 #include "fboss/agent/StateObserver.h"
+#include "fboss/agent/TxPacketTemplate.h"
 #include "fboss/agent/state/AggregatePort.h"
 #include "fboss/agent/types.h"
 
 #include <boost/container/flat_map.hpp>
 
+#include <folly/MacAddress.h>
 #include <folly/SharedMutex.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
+#include <folly/container/F14Map.h>
 #include <folly/io/Cursor.h>
 
 #include <memory>
@@ -91,6 +95,8 @@ class LinkAggregationManager : public AutoRegisterStateObserver,
       const std::shared_ptr<Port>& oldPort,
       const std::shared_ptr<Port>& newPort);
 
+  void publishControllers();
+
   void updateAggregatePortStats(
       const std::shared_ptr<AggregatePort>& oldAggPort,
       const std::shared_ptr<AggregatePort>& newAggPort);
@@ -107,7 +113,22 @@ class LinkAggregationManager : public AutoRegisterStateObserver,
 
   PortIDToController portToController_;
   mutable folly::SharedMutexWritePriority controllersLock_;
+  // Copy of portToController_ republished whenever controllers are added or
+  // removed, so that frames received on the RX path find their controller
+  // without contending on controllersLock_
+  folly::atomic_shared_ptr<const PortIDToController> rxPortToController_;
   SwSwitch* sw_{nullptr};
+
+  // The LACP frame last sent out of a port, less the actor and partner
+  // state which are patched in on every send
+  struct LacpFrame {
+    VlanID vlan{0};
+    folly::MacAddress cpuMac;
+    LACPDU lacpdu;
+    TxPacketTemplate frame;
+  };
+  // Only accessed from the LACP thread
+  folly::F14FastMap<PortID, LacpFrame> lacpFrames_;
 };
 
 } // namespace facebook::fboss
@@ -151,6 +151,14 @@ void LldpManager::timeoutExpired() noexcept {
 void LldpManager::sendLldpOnAllPorts() {
   // send lldp frames through all the ports here.
   std::shared_ptr<SwitchState> state = sw_->getState();
+  // Drop the frames cached for ports which no longer exist
+  for (auto it = portFrames_.begin(); it != portFrames_.end();) {
+    if (!state->getPorts()->getPortIf(it->first)) {
+      it = portFrames_.erase(it);
+    } else {
+      ++it;
+    }
+  }
   for (const auto& port : *state->getPorts()) {
     if (port->isPortUp()) {
       sendLldpInfo(port);
@@ -326,15 +334,35 @@ void LldpManager::sendLldpInfo(const std::shared_ptr<Port>& port) {
     hostname[0] = '\0';
   }
 
-  auto pkt = LldpManager::createLldpPkt(
-      sw_,
-      cpuMac,
-      port->getIngressVlan(),
-      std::string(hostname.data()),
-      port->getName(),
-      port->getDescription(),
-      TTL_TLV_VALUE,
-      SYSTEM_CAPABILITY_ROUTER);
+  auto& portFrame = portFrames_[thisPortID];
+  std::unique_ptr<TxPacket> pkt;
+  if (!portFrame.frame.empty() && portFrame.mac == cpuMac &&
+      portFrame.vlan == port->getIngressVlan() &&
+      portFrame.hostname == hostname.data() &&
+      portFrame.portName == port->getName() &&
+      portFrame.portDesc == port->getDescription()) {
+    pkt = portFrame.frame.instantiate(sw_);
+  }
+  if (!pkt) {
+    // The frame changed, or the cached frame could not be copied into a new
+    // packet: build the frame from scratch
+    pkt = LldpManager::createLldpPkt(
+        sw_,
+        cpuMac,
+        port->getIngressVlan(),
+        std::string(hostname.data()),
+        port->getName(),
+        port->getDescription(),
+        TTL_TLV_VALUE,
+        SYSTEM_CAPABILITY_ROUTER);
+    portFrame = PortFrame{
+        cpuMac,
+        port->getIngressVlan(),
+        hostname.data(),
+        port->getName(),
+        port->getDescription(),
+        TxPacketTemplate(ByteRange(pkt->buf()->data(), pkt->buf()->length()))};
+  }
 
   // this LLDP packet HAS to exit out of the port specified here.
   sw_->sendNetworkControlPacketAsync(
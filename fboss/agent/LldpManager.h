@@ -9,10 +9,12 @@
  */
 // Copyright 2014-present Facebook. All Rights Reserved.
 #pragma once
+#include <folly/container/F14Map.h>
 #include <folly/io/async/AsyncTimeout.h>
 #include <memory>
 #include <unordered_map>
 #include "fboss/agent/Platform.h"
+#include "fboss/agent/TxPacketTemplate.h"
 #include "fboss/agent/lldp/LinkNeighborDB.h"
 #include "fboss/agent/state/Port.h"
 #include "fboss/agent/state/PortMap.h"
@@ -115,9 +117,23 @@ class LldpManager : private folly::AsyncTimeout {
   void timeoutExpired() noexcept override;
   void sendLldpInfo(const std::shared_ptr<Port>& port);
 
+  // The LLDP frame last sent out of a port, and what it was built from
+  struct PortFrame {
+    folly::MacAddress mac;
+    VlanID vlan{0};
+    std::string hostname;
+    std::string portName;
+    std::string portDesc;
+    TxPacketTemplate frame;
+  };
+
   SwSwitch* sw_{nullptr};
   std::chrono::milliseconds intervalMsecs_;
   LinkNeighborDB db_;
+  // Frames are rebuilt only when any of their fields change, and dropped
+  // once their port is gone. Only accessed from the thread sending LLDP
+  // frames.
+  folly::F14FastMap<PortID, PortFrame> portFrames_;
 };
 
 } // namespace facebook::fboss
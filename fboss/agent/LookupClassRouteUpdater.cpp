@@ -133,7 +133,7 @@ bool LookupClassRouteUpdater::belongsToSubnetInCache(
     const folly::IPAddress& ipToSearch) {
   auto it = vlan2SubnetsCache_.find(vlanID);
   if (it != vlan2SubnetsCache_.end()) {
-    auto subnetsCache = it->second;
+    const auto& subnetsCache = it->second;
     for (const auto& [ipAddress, mask] : subnetsCache) {
       if (ipToSearch.inSubnet(ipAddress, mask)) {
         return true;
@@ -162,17 +162,19 @@ void LookupClassRouteUpdater::updateSubnetsCache(
         newState->getInterfaces()->getInterfaceIf(vlan->getInterfaceID());
     if (interface) {
       for (auto address : interface->getAddresses()) {
-        subnetsCache.insert(address);
+        auto inserted = subnetsCache.insert(address).second;
 
-        if (reAddAllRoutesEnabled) {
+        if (inserted && reAddAllRoutesEnabled) {
           /*
            * When a new subnet is added to the cache, the nextHops of existing
            * routes may become eligible for caching in
            * nextHopAndVlan2Prefixes_. Furthermore, such a nextHop may have
            * classID associated with it, and in that case, the corresponding
            * route could inherit that classID. Thus, re-add all the routes.
+           * This is done once per state delta, after all port and interface
+           * changes have been processed.
            */
-          reAddAllRoutes(stateDelta);
+          reAddAllRoutesPending_ = true;
         }
       }
     }
@@ -309,11 +311,8 @@ void LookupClassRouteUpdater::processInterfaceAdded(
   for (auto& [portID, portInfo] : vlan->getPorts()) {
     std::ignore = portInfo;
     auto port = switchState->getPorts()->getPortIf(portID);
-    // routes are re-added once outside the for loop
-    processPortAdded(stateDelta, port, false /* don't re-add all routes */);
+    processPortAdded(stateDelta, port, true /* re-add all routes */);
   }
-
-  reAddAllRoutes(stateDelta);
 }
 
 void LookupClassRouteUpdater::processInterfaceRemoved(
@@ -814,8 +813,23 @@ void LookupClassRouteUpdater::updateClassIDForRouteHelper(
 
 void LookupClassRouteUpdater::updateClassIDsForRoutes(
     const std::vector<RouteAndClassID>& routesAndClassIDs) {
+  // A later update for the same route within a delta supersedes earlier ones
+  for (const auto& [ridAndCidr, classID] : routesAndClassIDs) {
+    pendingRouteClassIDs_[ridAndCidr] = classID;
+  }
+}
+
+void LookupClassRouteUpdater::schedulePendingClassIDUpdates() {
+  if (pendingRouteClassIDs_.empty()) {
+    return;
+  }
+  std::vector<RouteAndClassID> routesAndClassIDs(
+      pendingRouteClassIDs_.begin(), pendingRouteClassIDs_.end());
+  pendingRouteClassIDs_.clear();
+
   auto updateClassIDsForRoutesFn =
-      [this, routesAndClassIDs](const std::shared_ptr<SwitchState>& state)
+      [this, routesAndClassIDs = std::move(routesAndClassIDs)](
+          const std::shared_ptr<SwitchState>& state)
       -> std::shared_ptr<SwitchState> {
     auto newState{state};
 
@@ -895,20 +909,26 @@ void LookupClassRouteUpdater::stateUpdated(const StateDelta& stateDelta) {
 
   processInterfaceUpdates(stateDelta);
 
+  if (reAddAllRoutesPending_) {
+    reAddAllRoutesPending_ = false;
+    reAddAllRoutes(stateDelta);
+  }
+
   /*
    * Only RSWs connected to MH-NIC (e.g. Yosemite) need queue-per-host fix, and
    * thus have non-empty vlan2SubnetsCache_ (populated by processPortUpdates).
    * Skip the processing on other setups.
    */
-  if (vlan2SubnetsCache_.empty()) {
-    return;
-  }
+  if (!vlan2SubnetsCache_.empty()) {
+    processNeighborUpdates<folly::IPAddressV6>(stateDelta);
+    processNeighborUpdates<folly::IPAddressV4>(stateDelta);
 
-  processNeighborUpdates<folly::IPAddressV6>(stateDelta);
-  processNeighborUpdates<folly::IPAddressV4>(stateDelta);
+    processRouteUpdates<folly::IPAddressV6>(stateDelta);
+    processRouteUpdates<folly::IPAddressV4>(stateDelta);
+  }
 
-  processRouteUpdates<folly::IPAddressV6>(stateDelta);
-  processRouteUpdates<folly::IPAddressV4>(stateDelta);
+  // Stamp the classIDs computed for this delta in a single state update
+  schedulePendingClassIDUpdates();
 }
 
 } // namespace facebook::fboss
@@ -24,6 +24,10 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
   ~LookupClassRouteUpdater() override {}
 
   void stateUpdated(const StateDelta& stateDelta) override;
+  // Only touches its own caches, and queues classID changes as state updates
+  bool notifyConcurrently() const override {
+    return true;
+  }
 
  private:
   // Helper methods
@@ -145,6 +149,10 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
       std::pair<RidAndCidr, std::optional<cfg::AclLookupClass>>;
 
   // Methods for scheduling state updates
+  /*
+   * ClassID changes are accumulated while processing a delta, and applied
+   * in one state update once the whole delta has been processed.
+   */
   template <typename AddrT>
   void updateClassIDForRouteHelper(
       RouterID rid,
@@ -154,6 +162,7 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
       std::optional<cfg::AclLookupClass> classID);
   void updateClassIDsForRoutes(
       const std::vector<RouteAndClassID>& routesAndClassIDs);
+  void schedulePendingClassIDUpdates();
 
   template <typename AddrT>
   void clearClassIDsForRoutes() const;
@@ -256,6 +265,16 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
    */
   std::set<RidAndCidr> allPrefixesWithClassID_;
 
+  /*
+   * ClassIDs computed for routes while processing the current delta, yet to
+   * be applied to the switch state.
+   */
+  std::map<RidAndCidr, std::optional<cfg::AclLookupClass>>
+      pendingRouteClassIDs_;
+
+  // Set when new subnets were cached and existing routes need re-processing
+  bool reAddAllRoutesPending_{false};
+
   SwSwitch* sw_;
 
   bool inited_{false};
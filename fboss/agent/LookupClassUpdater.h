@@ -21,6 +21,11 @@ class LookupClassUpdater : public AutoRegisterStateObserver {
   ~LookupClassUpdater() override {}
 
   void stateUpdated(const StateDelta& stateDelta) override;
+  // Only touches its own caches, and queues classID changes as state updates
+  // or on the neighbor cache thread
+  bool notifyConcurrently() const override {
+    return true;
+  }
 
   int getRefCnt(
       PortID portID,
@@ -12,23 +12,132 @@
 #include "fboss/agent/L2Entry.h"
 #include "fboss/agent/MacTableUtils.h"
 #include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/state/SwitchState.h"
 
+#include <folly/io/async/EventBase.h>
+#include <gflags/gflags.h>
+
+#include <utility>
+
+DEFINE_int32(
+    mac_learning_flush_ms,
+    10,
+    "Interval (ms) over which L2 learning updates are buffered before being "
+    "applied to the switch state, 0 to apply them as soon as possible");
+DEFINE_uint32(
+    mac_learning_max_pending,
+    16384,
+    "Max MACs with buffered L2 learning updates. Once reached, buffered "
+    "updates are applied right away");
+
 namespace facebook::fboss {
 
-MacTableManager::MacTableManager(SwSwitch* sw) : sw_(sw) {}
+MacTableManager::MacTableManager(SwSwitch* sw)
+    : sw_(sw), pending_(std::make_shared<SyncedPendingUpdates>()) {}
 
 void MacTableManager::handleL2LearningUpdate(
     L2Entry l2Entry,
     L2EntryUpdateType l2EntryUpdateType) {
-  auto updateMacTableFn =
-      [l2Entry, l2EntryUpdateType](const std::shared_ptr<SwitchState>& state) {
-        return MacTableUtils::updateMacTable(state, l2Entry, l2EntryUpdateType);
-      };
-
-  sw_->updateState(
-      folly::to<std::string>("Programming : ", l2Entry.str()),
-      std::move(updateMacTableFn));
+  bool folded = false;
+  bool schedule = false;
+  bool full = false;
+  {
+    auto pending = pending_->lock();
+    auto& vlanUpdates = pending->vlans[l2Entry.getVlanID()];
+    auto it = vlanUpdates.find(l2Entry.getMac());
+    if (it == vlanUpdates.end()) {
+      vlanUpdates.emplace(
+          l2Entry.getMac(), PendingUpdate{l2Entry, l2EntryUpdateType});
+      ++pending->size;
+    } else {
+      auto& update = it->second;
+      folded = true;
+      if (l2EntryUpdateType ==
+          L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_DELETE) {
+        // Aging out undoes whatever was learned since the last flush
+        update = PendingUpdate{l2Entry, l2EntryUpdateType};
+      } else if (
+          update.updateType ==
+          L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_DELETE) {
+        update = PendingUpdate{l2Entry, l2EntryUpdateType, true};
+      }
+      // Learning a MAC already being learned doesn't change its entry
+    }
+    schedule = !std::exchange(pending->flushScheduled, true);
+    full = pending->size >= FLAGS_mac_learning_max_pending;
+  }
+
+  if (folded) {
+    sw_->stats()->macLearningFolded();
+  }
+  if (full) {
+    sw_->stats()->macLearningBackpressure();
+    flush();
+  } else if (schedule) {
+    scheduleFlush();
+  }
+}
+
+void MacTableManager::flush() {
+  flush(sw_, pending_);
+}
+
+void MacTableManager::scheduleFlush() {
+  if (FLAGS_mac_learning_flush_ms <= 0) {
+    flush();
+    return;
+  }
+  auto* evb = sw_->getBackgroundEvb();
+  evb->runInEventBaseThread([evb, sw = sw_, pending = pending_]() {
+    evb->timer().scheduleTimeoutFn(
+        [sw, pending]() { flush(sw, pending); },
+        std::chrono::milliseconds(FLAGS_mac_learning_flush_ms));
+  });
+}
+
+void MacTableManager::flush(
+    SwSwitch* sw,
+    const std::shared_ptr<SyncedPendingUpdates>& pending) {
+  folly::F14FastMap<VlanID, PendingVlanUpdates> vlans;
+  {
+    auto locked = pending->lock();
+    vlans.swap(locked->vlans);
+    locked->size = 0;
+    locked->flushScheduled = false;
+  }
+
+  for (auto& [vlanID, updates] : vlans) {
+    if (updates.empty()) {
+      continue;
+    }
+    auto vlanUpdates = std::make_shared<PendingVlanUpdates>(std::move(updates));
+    auto updateMacTableFn =
+        [vlanUpdates](const std::shared_ptr<SwitchState>& state) {
+          // Only the first update copies the MacTable, the rest modify the
+          // unpublished copy
+          auto newState = state;
+          for (const auto& [mac, update] : *vlanUpdates) {
+            if (update.replace) {
+              newState = MacTableUtils::updateMacTable(
+                  newState,
+                  update.l2Entry,
+                  L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_DELETE);
+            }
+            newState = MacTableUtils::updateMacTable(
+                newState, update.l2Entry, update.updateType);
+          }
+          return newState;
+        };
+
+    sw->updateState(
+        folly::to<std::string>(
+            "Programming ",
+            vlanUpdates->size(),
+            " L2 entries on vlan ",
+            vlanID),
+        std::move(updateMacTableFn));
+  }
 }
 
 } // namespace facebook::fboss
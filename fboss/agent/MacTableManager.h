@@ -11,24 +11,72 @@
 
 #include "fboss/agent/L2Entry.h"
 
+#include <folly/MacAddress.h>
+#include <folly/SpinLock.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+#include <memory>
+
 namespace facebook::fboss {
 
 class SwSwitch;
 
+/*
+ * Applies the L2 learning updates reported by the hardware to the MAC tables
+ * in the switch state.
+ *
+ * Updates are buffered as they arrive, with later updates for a MAC folding
+ * into the one already buffered, and applied every mac_learning_flush_ms as
+ * one state update per VLAN. This way learning and aging storms (e.g. during
+ * VM migrations) don't queue a state update and a MacTable copy per MAC. If
+ * mac_learning_max_pending MACs are buffered, they are applied right away.
+ */
 class MacTableManager {
  public:
   explicit MacTableManager(SwSwitch* sw);
 
+  /*
+   * Buffer an update. May be called from any thread.
+   */
   void handleL2LearningUpdate(
       L2Entry l2Entry,
       L2EntryUpdateType l2EntryUpdateType);
 
+  /*
+   * Schedule state updates for all buffered updates now.
+   */
+  void flush();
+
  private:
+  struct PendingUpdate {
+    L2Entry l2Entry;
+    L2EntryUpdateType updateType;
+    // Aged out and learned again since the last flush
+    bool replace{false};
+  };
+  using PendingVlanUpdates =
+      folly::F14FastMap<folly::MacAddress, PendingUpdate>;
+  struct PendingUpdates {
+    folly::F14FastMap<VlanID, PendingVlanUpdates> vlans;
+    size_t size{0};
+    bool flushScheduled{false};
+  };
+  using SyncedPendingUpdates =
+      folly::Synchronized<PendingUpdates, folly::SpinLock>;
+
   // Forbidden copy constructor and assignment operator
   MacTableManager(MacTableManager const&) = delete;
   MacTableManager& operator=(MacTableManager const&) = delete;
 
+  void scheduleFlush();
+  static void flush(
+      SwSwitch* sw,
+      const std::shared_ptr<SyncedPendingUpdates>& pending);
+
   SwSwitch* sw_{nullptr};
+  // Shared with scheduled flushes, which may run after we are destroyed
+  std::shared_ptr<SyncedPendingUpdates> pending_;
 };
 
 } // namespace facebook::fboss
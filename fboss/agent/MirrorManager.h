@@ -19,6 +19,10 @@ class MirrorManager : public AutoRegisterStateObserver {
   ~MirrorManager() override {}
 
   void stateUpdated(const StateDelta& delta) override;
+  // Mirrors are resolved in a state update of their own
+  bool notifyConcurrently() const override {
+    return true;
+  }
 
  private:
   SwSwitch* sw_;
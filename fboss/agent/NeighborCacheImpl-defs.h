@@ -18,6 +18,7 @@
 #include "fboss/agent/ArpHandler.h"
 #include "fboss/agent/IPv6Handler.h"
 #include "fboss/agent/NeighborCacheImpl.h"
+#include "fboss/agent/NeighborResolutionLimiter.h"
 #include "fboss/agent/state/ArpTable.h"
 #include "fboss/agent/state/NdpTable.h"
 #include "fboss/agent/state/NeighborEntry.h"
@@ -167,6 +168,7 @@ void NeighborCacheImpl<NTable>::setEntry(
   if (entry) {
     programEntry(entry);
   }
+  sw_->getNeighborResolutionLimiter()->resolutionDone(vlanID_, ip);
 }
 
 template <typename NTable>
@@ -336,6 +338,9 @@ bool NeighborCacheImpl<NTable>::flushEntryBlocking(AddressType ip) {
 
 template <typename NTable>
 void NeighborCacheImpl<NTable>::flushEntry(AddressType ip, bool* flushed) {
+  // let the next packet to ip trigger resolution right away
+  sw_->getNeighborResolutionLimiter()->resolutionDone(vlanID_, ip);
+
   // remove from cache
   if (!removeEntry(ip)) {
     if (flushed) {
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/NeighborResolutionLimiter.h"
+
+#include <folly/hash/Hash.h>
+#include <gflags/gflags.h>
+
+#include "fboss/agent/SwitchStats.h"
+
+DEFINE_int32(
+    neighbor_resolution_dedup_ms,
+    200,
+    "Don't send another ARP request or neighbor solicitation for the same "
+    "destination from the slow path within this interval (ms)");
+DEFINE_uint32(
+    neighbor_resolution_rate,
+    1000,
+    "Max ARP requests and neighbor solicitations per second sent from the "
+    "slow path for unresolved destinations");
+DEFINE_uint32(
+    neighbor_resolution_burst,
+    1000,
+    "Max burst of ARP requests and neighbor solicitations sent from the slow "
+    "path for unresolved destinations");
+
+namespace {
+// Purge expired in-flight entries once the table grows past this
+constexpr size_t kPurgeThreshold = 1024;
+} // namespace
+
+namespace facebook::fboss {
+
+size_t NeighborResolutionLimiter::KeyHash::operator()(const Key& key) const {
+  return folly::hash::hash_combine(
+      static_cast<uint16_t>(key.first), key.second);
+}
+
+bool NeighborResolutionLimiter::shouldSend(
+    VlanID vlan,
+    const folly::IPAddress& ip,
+    SwitchStats* stats) {
+  auto now = Clock::now();
+  auto dedupInterval =
+      std::chrono::milliseconds(FLAGS_neighbor_resolution_dedup_ms);
+  auto inFlight = inFlight_.lock();
+  auto [itr, inserted] = inFlight->try_emplace(Key{vlan, ip}, now);
+  auto lastSent = itr->second;
+  if (!inserted && now - lastSent < dedupInterval) {
+    stats->neighborResolutionDeduped();
+    return false;
+  }
+  if (!tokenBucket_.consume(
+          1, FLAGS_neighbor_resolution_rate, FLAGS_neighbor_resolution_burst)) {
+    // Nothing is in flight, so let the next packet try again
+    if (inserted) {
+      inFlight->erase(itr);
+    }
+    stats->neighborResolutionRateLimited();
+    return false;
+  }
+  itr->second = now;
+  if (inFlight->size() > kPurgeThreshold) {
+    purgeExpired(*inFlight, now);
+  }
+  return true;
+}
+
+void NeighborResolutionLimiter::resolutionDone(
+    VlanID vlan,
+    const folly::IPAddress& ip) {
+  inFlight_.lock()->erase(Key{vlan, ip});
+}
+
+void NeighborResolutionLimiter::purgeExpired(
+    InFlightMap& inFlight,
+    Clock::time_point now) const {
+  auto dedupInterval =
+      std::chrono::milliseconds(FLAGS_neighbor_resolution_dedup_ms);
+  for (auto itr = inFlight.begin(); itr != inFlight.end();) {
+    if (now - itr->second >= dedupInterval) {
+      itr = inFlight.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/IPAddress.h>
+#include <folly/SpinLock.h>
+#include <folly/Synchronized.h>
+#include <folly/TokenBucket.h>
+#include <folly/container/F14Map.h>
+
+#include <chrono>
+#include <utility>
+
+#include "fboss/agent/types.h"
+
+namespace facebook::fboss {
+
+class SwitchStats;
+
+/*
+ * Gates the ARP requests and neighbor solicitations sent from the slow path
+ * when packets are trapped to CPU for an unresolved destination.
+ *
+ * Until the neighbor cache's PENDING entry for a destination shows up in the
+ * switch state, every trapped packet for it would otherwise trigger another
+ * identical request. NeighborResolutionLimiter remembers which (VLAN, IP)
+ * pairs had a request sent recently and suppresses repeats, and caps the
+ * overall rate of requests with a token bucket. It is shared by the ARP and
+ * NDP paths and is safe to use from any thread.
+ */
+class NeighborResolutionLimiter {
+ public:
+  NeighborResolutionLimiter() {}
+
+  /*
+   * Returns true if a resolution request for ip on vlan should be sent now,
+   * in which case it is recorded as in flight. Suppressed requests are
+   * counted in stats.
+   */
+  bool shouldSend(VlanID vlan, const folly::IPAddress& ip, SwitchStats* stats);
+
+  /*
+   * Called by the neighbor caches once ip is resolved or its entry is
+   * flushed, so that a new resolution can start right away.
+   */
+  void resolutionDone(VlanID vlan, const folly::IPAddress& ip);
+
+  size_t inFlight() const {
+    return inFlight_.lock()->size();
+  }
+
+ private:
+  // no copy or assignment
+  NeighborResolutionLimiter(const NeighborResolutionLimiter&) = delete;
+  NeighborResolutionLimiter& operator=(const NeighborResolutionLimiter&) =
+      delete;
+
+  using Clock = std::chrono::steady_clock;
+  using Key = std::pair<VlanID, folly::IPAddress>;
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+  using InFlightMap = folly::F14FastMap<Key, Clock::time_point, KeyHash>;
+
+  void purgeExpired(InFlightMap& inFlight, Clock::time_point now) const;
+
+  folly::Synchronized<InFlightMap, folly::SpinLock> inFlight_;
+  folly::DynamicTokenBucket tokenBucket_;
+};
+
+} // namespace facebook::fboss
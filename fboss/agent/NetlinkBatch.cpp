@@ -0,0 +1,211 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/NetlinkBatch.h"
+
+#include <folly/ScopeGuard.h>
+#include <folly/String.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/logging/xlog.h>
+#include "fboss/agent/NlError.h"
+
+#include <vector>
+
+extern "C" {
+#include <linux/netlink.h>
+#include <netlink/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+}
+
+namespace {
+// Maximum number of request bytes packed into a single sendmsg()
+constexpr size_t kMaxChunkBytes = 32 * 1024;
+// Every ACK is charged to the receive buffer as a separate skb of up to 1KB,
+// so the number of requests sent at once is bounded as well
+constexpr size_t kMaxChunkRequests = 128;
+constexpr size_t kRecvBufBytes = 64 * 1024;
+} // namespace
+
+namespace facebook::fboss {
+
+NetlinkBatch::NetlinkBatch(
+    folly::EventBase* evb,
+    std::chrono::milliseconds ackTimeout)
+    : folly::EventHandler(evb), evb_(evb), ackTimeout_(ackTimeout) {
+  ackTimer_ = folly::AsyncTimeout::make(
+      *evb_, [this]() noexcept { ackTimedOut(); });
+  sock_ = nl_socket_alloc();
+  if (!sock_) {
+    throw FbossError("failed to allocate libnl socket");
+  }
+  SCOPE_FAIL {
+    nl_socket_free(sock_);
+  };
+  auto error = nl_connect(sock_, NETLINK_ROUTE);
+  nlCheckError(error, "failed to connect netlink socket to NETLINK_ROUTE");
+  error = nl_socket_set_nonblocking(sock_);
+  nlCheckError(error, "failed to put netlink socket in non-blocking mode");
+}
+
+NetlinkBatch::~NetlinkBatch() {
+  unregisterHandler();
+  for (auto& request : queued_) {
+    nlmsg_free(request.msg);
+  }
+  nl_close(sock_);
+  nl_socket_free(sock_);
+}
+
+void NetlinkBatch::add(struct nl_msg* msg, AckCallback callback) {
+  DCHECK(evb_->isInEventBaseThread());
+  queued_.push_back({msg, std::move(callback)});
+}
+
+void NetlinkBatch::flush() {
+  DCHECK(evb_->isInEventBaseThread());
+  if (!isHandlerRegistered()) {
+    changeHandlerFD(folly::NetworkSocket::fromFd(nl_socket_get_fd(sock_)));
+    registerHandler(folly::EventHandler::READ | folly::EventHandler::PERSIST);
+  }
+  maybeSendNextChunk();
+}
+
+void NetlinkBatch::flushAndWait() {
+  flush();
+  // ACKs are read right here, the EventBase thread is ours until we return
+  while (!inflight_.empty()) {
+    struct pollfd pfd = {};
+    pfd.fd = nl_socket_get_fd(sock_);
+    pfd.events = POLLIN;
+    auto ret = ::poll(&pfd, 1, ackTimeout_.count());
+    if (ret < 0) {
+      auto error = errno;
+      if (error == EINTR) {
+        continue;
+      }
+      XLOG(ERR) << "Failed to wait for netlink ACKs: "
+                << folly::errnoStr(error);
+      failInflight(-error);
+    } else if (ret == 0) {
+      ackTimedOut();
+      continue;
+    } else {
+      readAcks();
+    }
+    maybeSendNextChunk();
+  }
+}
+
+void NetlinkBatch::maybeSendNextChunk() {
+  if (inflight_.empty()) {
+    ackTimer_->cancelTimeout();
+    sendNextChunk();
+  }
+}
+
+void NetlinkBatch::sendNextChunk() {
+  std::vector<uint8_t> chunk;
+  chunk.reserve(kMaxChunkBytes);
+  while (!queued_.empty()) {
+    auto& request = queued_.front();
+    // Assigns the sequence number and requests an ACK
+    nl_complete_msg(sock_, request.msg);
+    auto hdr = nlmsg_hdr(request.msg);
+    auto len = NLMSG_ALIGN(hdr->nlmsg_len);
+    if (!chunk.empty() &&
+        (chunk.size() + len > kMaxChunkBytes ||
+         inflight_.size() == kMaxChunkRequests)) {
+      break;
+    }
+    auto begin = reinterpret_cast<const uint8_t*>(hdr);
+    chunk.insert(chunk.end(), begin, begin + hdr->nlmsg_len);
+    chunk.resize(chunk.size() + len - hdr->nlmsg_len, 0);
+    inflight_.emplace(hdr->nlmsg_seq, std::move(request.callback));
+    nlmsg_free(request.msg);
+    queued_.pop_front();
+  }
+  if (chunk.empty()) {
+    return;
+  }
+
+  auto ret = nl_sendto(sock_, chunk.data(), chunk.size());
+  if (ret < 0) {
+    XLOG(ERR) << "Failed to send " << inflight_.size()
+              << " netlink requests: " << nl_geterror(ret);
+    failInflight(-EIO);
+    // Nothing was sent, so no ACK will kick off the next chunk
+    evb_->runInLoop([this]() { sendNextChunk(); });
+    return;
+  }
+  XLOG(DBG3) << "Sent " << inflight_.size() << " netlink requests in "
+             << chunk.size() << " bytes";
+  ackTimer_->scheduleTimeout(ackTimeout_);
+}
+
+void NetlinkBatch::ackTimedOut() {
+  XLOG(ERR) << "Timed out waiting for the ACKs of " << inflight_.size()
+            << " netlink requests";
+  failInflight(-ETIMEDOUT);
+  // ACKs that still arrive are dropped as unknown
+  sendNextChunk();
+}
+
+void NetlinkBatch::failInflight(int error) {
+  ackTimer_->cancelTimeout();
+  auto inflight = std::move(inflight_);
+  inflight_.clear();
+  for (auto& [seq, callback] : inflight) {
+    callback(error);
+  }
+}
+
+void NetlinkBatch::handlerReady(uint16_t /* events */) noexcept {
+  readAcks();
+  maybeSendNextChunk();
+}
+
+void NetlinkBatch::readAcks() {
+  std::vector<uint8_t> buf(kRecvBufBytes);
+  while (true) {
+    auto len = ::recv(nl_socket_get_fd(sock_), buf.data(), buf.size(), 0);
+    if (len < 0) {
+      auto error = errno;
+      if (error == EAGAIN || error == EWOULDBLOCK) {
+        break;
+      }
+      if (error == EINTR) {
+        continue;
+      }
+      // ENOBUFS: ACKs were dropped, so we can't tell which requests failed
+      XLOG(ERR) << "Failed to read netlink ACKs: " << folly::errnoStr(error);
+      failInflight(-error);
+      break;
+    }
+    auto hdr = reinterpret_cast<struct nlmsghdr*>(buf.data());
+    int remaining = len;
+    for (; NLMSG_OK(hdr, remaining); hdr = NLMSG_NEXT(hdr, remaining)) {
+      if (hdr->nlmsg_type != NLMSG_ERROR) {
+        continue;
+      }
+      auto err = reinterpret_cast<struct nlmsgerr*>(NLMSG_DATA(hdr));
+      auto iter = inflight_.find(hdr->nlmsg_seq);
+      if (iter == inflight_.end()) {
+        XLOG(WARNING) << "Got netlink ACK for unknown request "
+                      << hdr->nlmsg_seq;
+        continue;
+      }
+      auto callback = std::move(iter->second);
+      inflight_.erase(iter);
+      callback(err->error);
+    }
+  }
+}
+
+} // namespace facebook::fboss
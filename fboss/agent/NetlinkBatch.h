@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Function.h>
+#include <folly/container/F14Map.h>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventHandler.h>
+
+#include <chrono>
+#include <deque>
+
+extern "C" {
+#include <netlink/msg.h>
+#include <netlink/socket.h>
+}
+
+namespace folly {
+class EventBase;
+}
+
+namespace facebook::fboss {
+
+/*
+ * Sends rtnetlink requests in batches over a nonblocking socket.
+ *
+ * Requests are built with libnl's rtnl_*_build_*_request() helpers and queued
+ * with add(). flush() packs as many queued requests as fit into a single
+ * sendmsg(), and the kernel ACKs are read asynchronously from the EventBase
+ * the batch was created for. Each request's callback is invoked with the
+ * (negative errno) error code from its ACK, or 0 on success. The next chunk
+ * is only sent once every request of the previous one has been ACKed, so the
+ * ACKs can never overflow the socket receive buffer. Requests that are not
+ * ACKed within the ACK timeout fail with -ETIMEDOUT.
+ *
+ * Must only be used from the EventBase thread.
+ */
+class NetlinkBatch : private folly::EventHandler {
+ public:
+  using AckCallback = folly::Function<void(int error)>;
+
+  explicit NetlinkBatch(
+      folly::EventBase* evb,
+      std::chrono::milliseconds ackTimeout = std::chrono::seconds(5));
+  ~NetlinkBatch() override;
+
+  /*
+   * Queue a request for sending. Takes ownership of msg.
+   */
+  void add(struct nl_msg* msg, AckCallback callback);
+
+  /*
+   * Start sending the queued requests. Returns without waiting for ACKs.
+   */
+  void flush();
+
+  /*
+   * Send all queued requests and block until each of them was ACKed or timed
+   * out, running their callbacks. Returns early only if sending failed.
+   */
+  void flushAndWait();
+
+  /*
+   * Number of requests that were queued or sent but not yet ACKed.
+   */
+  size_t pending() const {
+    return queued_.size() + inflight_.size();
+  }
+
+ private:
+  // no copy or assignment
+  NetlinkBatch(const NetlinkBatch&) = delete;
+  NetlinkBatch& operator=(const NetlinkBatch&) = delete;
+
+  void handlerReady(uint16_t events) noexcept override;
+  void readAcks();
+  void maybeSendNextChunk();
+  void sendNextChunk();
+  void ackTimedOut();
+  void failInflight(int error);
+
+  struct Request {
+    struct nl_msg* msg;
+    AckCallback callback;
+  };
+
+  folly::EventBase* evb_;
+  const std::chrono::milliseconds ackTimeout_;
+  std::unique_ptr<folly::AsyncTimeout> ackTimer_;
+  nl_sock* sock_{nullptr};
+  std::deque<Request> queued_;
+  folly::F14FastMap<uint32_t /* seq */, AckCallback> inflight_;
+};
+
+} // namespace facebook::fboss
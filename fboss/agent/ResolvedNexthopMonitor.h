@@ -38,6 +38,11 @@ class ResolvedNexthopMonitor : public AutoRegisterStateObserver {
  public:
   explicit ResolvedNexthopMonitor(SwSwitch* sw);
   void stateUpdated(const StateDelta& delta) override;
+  // The probe scheduler is only used from here, and probes start and stop on
+  // the background thread
+  bool notifyConcurrently() const override {
+    return true;
+  }
 
   bool probesScheduled() const {
     return scheduleProbes_;
@@ -22,6 +22,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <mutex>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -89,6 +90,10 @@ std::string to_string(RestartEvent type) {
       return "parent_process_started";
     case RestartEvent::PROCESS_STARTED:
       return "process_started";
+    case RestartEvent::HW_TABLES_RESTORED:
+      return "hw_tables_restored";
+    case RestartEvent::SWITCH_STATE_RESTORED:
+      return "switch_state_restored";
     case RestartEvent::INITIALIZED:
       return "initialized";
     case RestartEvent::CONFIGURED:
@@ -138,8 +143,10 @@ class RestartTimeTracker {
     }
   }
 
-  std::optional<TimePoint> newEvent(RestartEvent type) {
-    auto tp = create(type);
+  std::optional<TimePoint> newEvent(
+      RestartEvent type,
+      TimePoint now = steady_clock::now()) {
+    auto tp = create(type, now);
 
     if (tp) {
       if (lastEvent_) {
@@ -171,20 +178,22 @@ class RestartTimeTracker {
     return folly::to<std::string>(prefix_, kTotalCounterSuffix);
   }
 
-  std::optional<TimePoint> create(RestartEvent type) {
+  std::optional<TimePoint> create(RestartEvent type, TimePoint now) {
     switch (type) {
       case RestartEvent::PARENT_PROCESS_STARTED:
         return processStartTime(getppid());
       case RestartEvent::PROCESS_STARTED:
         return processStartTime(getpid());
+      case RestartEvent::HW_TABLES_RESTORED:
+      case RestartEvent::SWITCH_STATE_RESTORED:
       case RestartEvent::INITIALIZED:
       case RestartEvent::CONFIGURED:
       case RestartEvent::FIB_SYNCED:
-        return steady_clock::now();
+        return now;
       case RestartEvent::SIGNAL_RECEIVED:
       case RestartEvent::SHUTDOWN:
         if (completed_) {
-          return writeTimePointToFile(steady_clock::now(), savePath(type));
+          return writeTimePointToFile(now, savePath(type));
         } else {
           return readAndRemoveTimePointFile(savePath(type));
         }
@@ -204,28 +213,43 @@ class RestartTimeTracker {
 
 namespace restart_time {
 
-folly::Synchronized<std::unique_ptr<RestartTimeTracker>, std::mutex> impl_;
+struct Tracker {
+  std::unique_ptr<RestartTimeTracker> tracker;
+  // Events marked by the HwSwitch before init
+  std::vector<std::pair<RestartEvent, TimePoint>> pending;
+};
+
+folly::Synchronized<Tracker, std::mutex> impl_;
 
 void init(const std::string& warmBootDir, bool warmBoot) {
-  auto tracker = impl_.lock();
-  if (*tracker) {
+  auto impl = impl_.lock();
+  if (impl->tracker) {
     throw std::runtime_error("Called restart_time::init twice...");
   }
-  *tracker = std::make_unique<RestartTimeTracker>(warmBootDir, warmBoot);
+  impl->tracker = std::make_unique<RestartTimeTracker>(warmBootDir, warmBoot);
+  for (const auto& [event, tp] : impl->pending) {
+    impl->tracker->newEvent(event, tp);
+  }
+  impl->pending.clear();
 }
 
 void mark(RestartEvent event) {
-  auto tracker = impl_.lock();
-  if (*tracker) {
-    (*tracker)->newEvent(event);
+  auto impl = impl_.lock();
+  if (impl->tracker) {
+    impl->tracker->newEvent(event);
+  } else if (
+      event == RestartEvent::HW_TABLES_RESTORED ||
+      event == RestartEvent::SWITCH_STATE_RESTORED) {
+    impl->pending.emplace_back(event, steady_clock::now());
   } else {
     XLOG(ERR) << "Cannot call restart_time::mark() before restart_time::init";
   }
 }
 
 void stop() {
-  auto tracker = impl_.lock();
-  (*tracker).reset();
+  auto impl = impl_.lock();
+  impl->tracker.reset();
+  impl->pending.clear();
 }
 
 } // namespace restart_time
@@ -26,6 +26,9 @@
  * monotonicity. An implementation that uses process_time as epoch is
  * also possible, which would break the duration calculation in this
  * module.
+ *
+ * The boot type is only known once the HwSwitch has initialized, so
+ * events marked while it initializes are held until init() is called.
  */
 
 namespace facebook::fboss {
@@ -35,6 +38,9 @@ enum class RestartEvent : uint16_t {
   SHUTDOWN,
   PARENT_PROCESS_STARTED,
   PROCESS_STARTED,
+  // Warm boot only: hardware tables and switch state restored during init
+  HW_TABLES_RESTORED,
+  SWITCH_STATE_RESTORED,
   INITIALIZED,
   CONFIGURED,
   FIB_SYNCED,
@@ -9,48 +9,23 @@
  */
 
 #include "fboss/agent/RouteUpdateLogger.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/Utils.h"
 #include "fboss/agent/state/DeltaFunctions.h"
 
-namespace facebook::fboss {
+#include <folly/synchronization/Baton.h>
+#include <gflags/gflags.h>
 
-namespace {
-template <typename AddrT>
-void handleChangedRoute(
-    const RouteUpdateLoggingPrefixTracker& tracker,
-    const std::unique_ptr<RouteLogger<AddrT>>& logger,
-    const std::shared_ptr<Route<AddrT>>& oldRoute,
-    const std::shared_ptr<Route<AddrT>>& newRoute) {
-  std::vector<std::string> matchedIdentifiers;
-  auto prefix = oldRoute->prefix();
-  if (tracker.tracking(prefix, matchedIdentifiers)) {
-    logger->logChangedRoute(oldRoute, newRoute, matchedIdentifiers);
-  }
-}
+#include <algorithm>
 
-template <typename AddrT>
-void handleRemovedRoute(
-    const RouteUpdateLoggingPrefixTracker& tracker,
-    const std::unique_ptr<RouteLogger<AddrT>>& logger,
-    const std::shared_ptr<Route<AddrT>>& oldRoute) {
-  std::vector<std::string> matchedIdentifiers;
-  auto prefix = oldRoute->prefix();
-  if (tracker.tracking(prefix, matchedIdentifiers)) {
-    logger->logRemovedRoute(oldRoute, matchedIdentifiers);
-  }
-}
+DEFINE_int32(
+    route_update_log_queue_size,
+    10000,
+    "Max number of route updates queued for the route update logging thread. "
+    "Updates beyond that are dropped.");
 
-template <typename AddrT>
-void handleAddedRoute(
-    const RouteUpdateLoggingPrefixTracker& tracker,
-    const std::unique_ptr<RouteLogger<AddrT>>& logger,
-    const std::shared_ptr<Route<AddrT>>& newRoute) {
-  std::vector<std::string> matchedIdentifiers;
-  auto prefix = newRoute->prefix();
-  if (tracker.tracking(prefix, matchedIdentifiers)) {
-    logger->logAddedRoute(newRoute, matchedIdentifiers);
-  }
-}
-} // anonymous namespace
+namespace facebook::fboss {
 
 RouteUpdateLogger::RouteUpdateLogger(SwSwitch* sw)
     : RouteUpdateLogger(
@@ -65,66 +40,136 @@ RouteUpdateLogger::RouteUpdateLogger(
     std::unique_ptr<RouteLogger<folly::IPAddressV6>> routeLoggerV6,
     std::unique_ptr<MplsRouteLogger> mplsRouteLogger)
     : AutoRegisterStateObserver(sw, "RouteUpdateLogger"),
+      sw_(sw),
       routeLoggerV4_(std::move(routeLoggerV4)),
       routeLoggerV6_(std::move(routeLoggerV6)),
-      mplsRouteLogger_(std::move(mplsRouteLogger)) {}
+      mplsRouteLogger_(std::move(mplsRouteLogger)),
+      logQueue_(std::max(FLAGS_route_update_log_queue_size, 1)),
+      logThread_([this] { logThread(); }) {}
+
+RouteUpdateLogger::~RouteUpdateLogger() {
+  logQueue_.blockingWrite(LogFn());
+  logThread_.join();
+}
+
+void RouteUpdateLogger::logThread() {
+  initThread("RouteUpdateLog");
+  while (true) {
+    LogFn logFn;
+    logQueue_.blockingRead(logFn);
+    if (!logFn) {
+      return;
+    }
+    logFn();
+  }
+}
+
+void RouteUpdateLogger::enqueue(LogFn logFn) {
+  if (!logQueue_.write(std::move(logFn))) {
+    auto dropped =
+        droppedUpdates_.fetch_add(1, std::memory_order_relaxed) + 1;
+    sw_->stats()->routeUpdateLogDropped();
+    XLOG_EVERY_MS(WARNING, 1000)
+        << "Route update logging queue is full, " << dropped
+        << " updates dropped so far";
+  }
+}
+
+void RouteUpdateLogger::flush() {
+  folly::Baton<> logged;
+  logQueue_.blockingWrite([&logged] { logged.post(); });
+  logged.wait();
+}
+
+template <typename AddrT>
+void RouteUpdateLogger::logRoutesDelta(
+    const RouteTablesDelta::RoutesDeltaT<AddrT>& routesDelta,
+    RouteLogger<AddrT>* logger) {
+  // Only the route pointers are captured here, they are immutable once
+  // published. Formatting them is left to the logging thread.
+  DeltaFunctions::forEachChanged(
+      routesDelta,
+      [&](const auto& oldRoute, const auto& newRoute) {
+        std::vector<std::string> identifiers;
+        if (prefixTracker_.tracking(oldRoute->prefix(), identifiers)) {
+          enqueue([logger,
+                   oldRoute,
+                   newRoute,
+                   identifiers = std::move(identifiers)] {
+            logger->logChangedRoute(oldRoute, newRoute, identifiers);
+          });
+        }
+      },
+      [&](const auto& newRoute) {
+        std::vector<std::string> identifiers;
+        if (prefixTracker_.tracking(newRoute->prefix(), identifiers)) {
+          enqueue([logger, newRoute, identifiers = std::move(identifiers)] {
+            logger->logAddedRoute(newRoute, identifiers);
+          });
+        }
+      },
+      [&](const auto& oldRoute) {
+        std::vector<std::string> identifiers;
+        if (prefixTracker_.tracking(oldRoute->prefix(), identifiers)) {
+          enqueue([logger, oldRoute, identifiers = std::move(identifiers)] {
+            logger->logRemovedRoute(oldRoute, identifiers);
+          });
+        }
+      });
+}
 
 void RouteUpdateLogger::stateUpdated(const StateDelta& delta) {
   for (const auto& rtDelta : delta.getRouteTablesDelta()) {
-    DeltaFunctions::forEachChanged(
-        rtDelta.getRoutesV4Delta(),
-        &handleChangedRoute<folly::IPAddressV4>,
-        &handleAddedRoute<folly::IPAddressV4>,
-        &handleRemovedRoute<folly::IPAddressV4>,
-        prefixTracker_,
-        routeLoggerV4_);
-    DeltaFunctions::forEachChanged(
-        rtDelta.getRoutesV6Delta(),
-        &handleChangedRoute<folly::IPAddressV6>,
-        &handleAddedRoute<folly::IPAddressV6>,
-        &handleRemovedRoute<folly::IPAddressV6>,
-        prefixTracker_,
-        routeLoggerV6_);
+    logRoutesDelta<folly::IPAddressV4>(
+        rtDelta.getRoutesV4Delta(), routeLoggerV4_.get());
+    logRoutesDelta<folly::IPAddressV6>(
+        rtDelta.getRoutesV6Delta(), routeLoggerV6_.get());
   }
 
   auto* mplsRouteLogger = mplsRouteLogger_.get();
   CHECK(mplsRouteLogger);
   const auto labelTracker = labelTracker_.rlock();
+  auto identifiersForLabel = [&labelTracker](const auto& entry) {
+    std::set<std::string> identifiers;
+    labelTracker->getIdentifiersForLabel(entry->getID(), identifiers);
+    return std::vector<std::string>(identifiers.begin(), identifiers.end());
+  };
 
   DeltaFunctions::forEachChanged(
       delta.getLabelForwardingInformationBaseDelta(),
-      [mplsRouteLogger, &labelTracker](
-          const auto& oldEntry, const auto& newEntry) {
-        std::set<std::string> identifiers;
-        labelTracker->getIdentifiersForLabel(oldEntry->getID(), identifiers);
+      [&](const auto& oldEntry, const auto& newEntry) {
+        auto identifiers = identifiersForLabel(oldEntry);
         if (identifiers.empty()) {
           return;
         }
-        mplsRouteLogger->logChangedRoute(
-            oldEntry,
-            newEntry,
-            std::vector<std::string>(identifiers.begin(), identifiers.end()));
+        enqueue([mplsRouteLogger,
+                 oldEntry,
+                 newEntry,
+                 identifiers = std::move(identifiers)] {
+          mplsRouteLogger->logChangedRoute(oldEntry, newEntry, identifiers);
+        });
       },
-      [mplsRouteLogger, &labelTracker](const auto& addedEntry) {
-        std::set<std::string> identifiers;
-        labelTracker->getIdentifiersForLabel(addedEntry->getID(), identifiers);
+      [&](const auto& addedEntry) {
+        auto identifiers = identifiersForLabel(addedEntry);
         if (identifiers.empty()) {
           return;
         }
-        mplsRouteLogger->logAddedRoute(
-            addedEntry,
-            std::vector<std::string>(identifiers.begin(), identifiers.end()));
+        enqueue([mplsRouteLogger,
+                 addedEntry,
+                 identifiers = std::move(identifiers)] {
+          mplsRouteLogger->logAddedRoute(addedEntry, identifiers);
+        });
       },
-      [mplsRouteLogger, &labelTracker](const auto& removedEntry) {
-        std::set<std::string> identifiers;
-        labelTracker->getIdentifiersForLabel(
-            removedEntry->getID(), identifiers);
+      [&](const auto& removedEntry) {
+        auto identifiers = identifiersForLabel(removedEntry);
         if (identifiers.empty()) {
           return;
         }
-        mplsRouteLogger->logRemovedRoute(
-            removedEntry,
-            std::vector<std::string>(identifiers.begin(), identifiers.end()));
+        enqueue([mplsRouteLogger,
+                 removedEntry,
+                 identifiers = std::move(identifiers)] {
+          mplsRouteLogger->logRemovedRoute(removedEntry, identifiers);
+        });
       });
 }
 
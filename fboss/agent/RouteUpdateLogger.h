@@ -9,7 +9,9 @@
  */
 #pragma once
 
+#include <folly/Function.h>
 #include <folly/IPAddress.h>
+#include <folly/MPMCQueue.h>
 #include <folly/logging/xlog.h>
 #include "fboss/agent/RouteUpdateLoggingPrefixTracker.h"
 #include "fboss/agent/StateObserver.h"
@@ -17,7 +19,9 @@
 #include "fboss/agent/state/RouteTypes.h"
 #include "fboss/agent/state/StateDelta.h"
 
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <vector>
 
 namespace facebook::fboss {
@@ -151,6 +155,12 @@ class LabelsTracker {
  * (or more specific location with that prefix) is added, removed, or
  * changes, log that information. The logger is pluggable, but by default
  * we use GLOG.
+ *
+ * Only matching against the tracked prefixes and labels happens on the update
+ * thread. The matched old/new entries are queued and formatted and written
+ * out by a dedicated logging thread, so that logging wide prefixes does not
+ * add to the state update latency. The queue is bounded; when the logging
+ * thread cannot keep up, updates are dropped and counted instead.
  */
 class RouteUpdateLogger : public AutoRegisterStateObserver {
   // TODO(pshaikh): rename RouteUpdateLogger to FibUpdateObserver
@@ -162,9 +172,12 @@ class RouteUpdateLogger : public AutoRegisterStateObserver {
       std::unique_ptr<RouteLogger<folly::IPAddressV6>> routeLoggerV6,
       std::unique_ptr<MplsRouteLogger> mplsRouteLogger);
 
-  ~RouteUpdateLogger() override = default;
+  ~RouteUpdateLogger() override;
 
   void stateUpdated(const StateDelta& delta) override;
+  bool notifyConcurrently() const override {
+    return true;
+  }
   void startLoggingForPrefix(const RouteUpdateLoggingInstance& req);
   void stopLoggingForPrefix(
       const folly::IPAddress& network,
@@ -194,12 +207,36 @@ class RouteUpdateLogger : public AutoRegisterStateObserver {
     return mplsRouteLogger_.get();
   }
 
+  /*
+   * Block until every update queued so far has been handed to the loggers.
+   */
+  void flush();
+
+  uint64_t getDroppedUpdates() const {
+    return droppedUpdates_.load(std::memory_order_relaxed);
+  }
+
  private:
+  using LogFn = folly::Function<void()>;
+
+  template <typename AddrT>
+  void logRoutesDelta(
+      const RouteTablesDelta::RoutesDeltaT<AddrT>& routesDelta,
+      RouteLogger<AddrT>* logger);
+  void enqueue(LogFn logFn);
+  void logThread();
+
+  SwSwitch* sw_;
   RouteUpdateLoggingPrefixTracker prefixTracker_;
   folly::Synchronized<LabelsTracker> labelTracker_;
   std::unique_ptr<RouteLogger<folly::IPAddressV4>> routeLoggerV4_;
   std::unique_ptr<RouteLogger<folly::IPAddressV6>> routeLoggerV6_;
   std::unique_ptr<MplsRouteLogger> mplsRouteLogger_;
+
+  // An empty LogFn tells the logging thread to exit
+  folly::MPMCQueue<LogFn> logQueue_;
+  std::atomic<uint64_t> droppedUpdates_{0};
+  std::thread logThread_;
 };
 
 } // namespace facebook::fboss
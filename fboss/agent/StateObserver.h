@@ -14,12 +14,36 @@
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/state/StateDelta.h"
 
+#include <string>
+#include <vector>
+
 namespace facebook::fboss {
 
 class StateObserver : public boost::noncopyable {
  public:
   virtual ~StateObserver() {}
   virtual void stateUpdated(const StateDelta& delta) = 0;
+
+  /*
+   * Observers that return true are notified from the state observer thread
+   * pool, concurrently with the other observers, instead of on the update
+   * thread. Only return true if stateUpdated() does not rely on running in
+   * the update thread and does not share mutable data with other observers.
+   * The update thread still waits for every observer before it moves on to
+   * the next state update.
+   */
+  virtual bool notifyConcurrently() const {
+    return false;
+  }
+
+  /*
+   * Names of observers that must be done with a delta before this observer
+   * is notified of it. Only honored for observers notified concurrently,
+   * the others are always notified one after another on the update thread.
+   */
+  virtual std::vector<std::string> notifyAfter() const {
+    return {};
+  }
 };
 
 class AutoRegisterStateObserver : public StateObserver {
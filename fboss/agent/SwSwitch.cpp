@@ -26,6 +26,7 @@
 #include "fboss/agent/LookupClassUpdater.h"
 #include "fboss/agent/MacTableManager.h"
 #include "fboss/agent/MirrorManager.h"
+#include "fboss/agent/NeighborResolutionLimiter.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/PortStats.h"
@@ -40,6 +41,7 @@
 #include "fboss/agent/TunManager.h"
 #include "fboss/agent/TxPacket.h"
 #include "fboss/agent/Utils.h"
+#include "fboss/agent/WarmBootJournal.h"
 #include "fboss/agent/capture/PcapPkt.h"
 #include "fboss/agent/capture/PktCaptureManager.h"
 #include "fboss/agent/gen-cpp2/switch_config_types_custom_protocol.h"
@@ -53,6 +55,7 @@
 #include "fboss/agent/state/SwitchState.h"
 
 #include <fb303/ServiceData.h>
+#include <fb303/ThreadCachedServiceData.h>
 #include <folly/Demangle.h>
 #include <folly/FileUtil.h>
 #include <folly/GLog.h>
@@ -60,6 +63,8 @@
 #include <folly/MapUtil.h>
 #include <folly/SocketAddress.h>
 #include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/logging/xlog.h>
 #include <folly/system/ThreadName.h>
 #include <glog/logging.h>
@@ -68,10 +73,13 @@
 #include <thrift/lib/cpp2/async/RequestChannel.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <exception>
+#include <functional>
 #include <tuple>
+#include <unordered_map>
 
 using folly::EventBase;
 using folly::SocketAddress;
@@ -104,6 +112,14 @@ DEFINE_bool(
     false,
     "Flag to turn on logging of all updates to the FIB");
 
+DEFINE_int32(
+    state_observer_threads,
+    0,
+    "Number of threads used to notify state observers that can be notified "
+    "concurrently. With 0, all observers are notified on the update thread");
+
+DECLARE_bool(warm_boot_journal);
+
 namespace {
 
 /**
@@ -155,6 +171,7 @@ SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
       arp_(new ArpHandler(this)),
       ipv4_(new IPv4Handler(this)),
       ipv6_(new IPv6Handler(this)),
+      neighborResolutionLimiter_(new NeighborResolutionLimiter()),
       nUpdater_(new NeighborUpdater(this)),
       pcapMgr_(new PktCaptureManager(this)),
       mirrorManager_(new MirrorManager(this)),
@@ -166,6 +183,11 @@ SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
       lookupClassUpdater_(new LookupClassUpdater(this)),
       lookupClassRouteUpdater_(new LookupClassRouteUpdater(this)),
       macTableManager_(new MacTableManager(this)) {
+  if (FLAGS_state_observer_threads > 0) {
+    stateObserverExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        FLAGS_state_observer_threads,
+        std::make_shared<folly::NamedThreadFactory>("StateObserver"));
+  }
   // Create the platform-specific state directories if they
   // don't exist already.
   utilCreateDir(platform_->getVolatileStateDir());
@@ -306,11 +328,24 @@ void SwSwitch::gracefulExit() {
                       .count();
 
     folly::dynamic switchState = folly::dynamic::object;
-    // TODO - Serialize both desired and applied state to
-    // file. Right now we just serialize applied state and
-    // then rely on a route/FIB sync on warm boot to recover
-    // desired state.
-    switchState[kSwSwitch] = getAppliedState()->toFollyDynamic();
+    if (warmBootJournal_) {
+      // The journal already holds the applied state, it only needs to make
+      // it to disk. The HwSwitch warm boot helper replays it on warm boot.
+      try {
+        warmBootJournal_->sync();
+      } catch (const std::exception& ex) {
+        XLOG(ERR) << "Unable to sync warm boot journal: "
+                  << folly::exceptionStr(ex);
+        warmBootJournal_.reset();
+      }
+    }
+    if (!warmBootJournal_) {
+      // TODO - Serialize both desired and applied state to
+      // file. Right now we just serialize applied state and
+      // then rely on a route/FIB sync on warm boot to recover
+      // desired state.
+      switchState[kSwSwitch] = getAppliedState()->toFollyDynamic();
+    }
 
     steady_clock::time_point switchStateToFollyDone = steady_clock::now();
     XLOG(INFO) << "[Exit] Switch state to folly dynamic "
@@ -330,6 +365,7 @@ void SwSwitch::getProductInfo(ProductInfo& productInfo) const {
 }
 
 void SwSwitch::updateStats() {
+  flushPacketCounters();
   updateRouteStats();
   updatePortInfo();
   try {
@@ -340,6 +376,17 @@ void SwSwitch::updateStats() {
   }
 }
 
+void SwSwitch::flushPacketCounters() {
+  for (auto& switchStats : getAllThreadsSwitchStats()) {
+    switchStats.flushPacketCounters();
+  }
+}
+
+void SwSwitch::publishStats() {
+  flushPacketCounters();
+  fb303::ThreadCachedServiceData::get()->publishStats();
+}
+
 void SwSwitch::registerNeighborListener(
     std::function<void(
         const std::vector<std::string>& added,
@@ -426,11 +473,20 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
   }
   platform_->onHwInitialized(this);
 
+  if (FLAGS_warm_boot_journal) {
+    // Checkpoint before the update thread can append to the journal. It is
+    // not running yet, but updates may already be queued for it.
+    warmBootJournal_ = std::make_unique<WarmBootJournal>(
+        WarmBootJournal::path(platform_->getWarmBootDir()));
+    journalAppliedState(nullptr, initialState);
+  }
+
   // Notify the state observers of the initial state
-  updateEventBase_.runInEventBaseThread([initialStateDesired, this]() {
-    notifyStateObservers(
-        StateDelta(std::make_shared<SwitchState>(), initialStateDesired));
-  });
+  updateEventBase_.runInEventBaseThread(
+      [initialState, initialStateDesired, this]() {
+        notifyStateObservers(
+            StateDelta(std::make_shared<SwitchState>(), initialStateDesired));
+      });
 
   if (getFlags() & SwitchFlags::ENABLE_STANDALONE_RIB) {
     // ALPM is enabled for the stand-alone RIB in ConfigApplier
@@ -606,6 +662,7 @@ void SwSwitch::removeStateObserver(StateObserver* observer) {
   if (!nErased) {
     throw FbossError("State observer remove failed: observer does not exist");
   }
+  stateObserverSchedule_.reset();
 }
 
 void SwSwitch::addStateObserver(StateObserver* observer, const string& name) {
@@ -614,6 +671,97 @@ void SwSwitch::addStateObserver(StateObserver* observer, const string& name) {
     throw FbossError("State observer add failed: ", name, " already exists");
   }
   stateObservers_.emplace(observer, name);
+  stateObserverSchedule_.reset();
+}
+
+void SwSwitch::computeStateObserverSchedule() {
+  std::unordered_map<string, StateObserver*> byName;
+  for (const auto& observerName : stateObservers_) {
+    byName.emplace(observerName.second, observerName.first);
+  }
+
+  StateObserverSchedule schedule;
+  // Wave of each concurrent observer, -1 while still being computed
+  std::unordered_map<StateObserver*, int> waveOf;
+  std::function<int(StateObserver*)> computeWave =
+      [&](StateObserver* observer) -> int {
+    auto it = waveOf.find(observer);
+    if (it != waveOf.end()) {
+      if (it->second < 0) {
+        throw FbossError(
+            "State observer ",
+            stateObservers_[observer],
+            " is part of a notifyAfter() cycle");
+      }
+      return it->second;
+    }
+    waveOf[observer] = -1;
+    int wave = 0;
+    for (const auto& name : observer->notifyAfter()) {
+      auto dependency = folly::get_default(byName, name, nullptr);
+      if (!dependency) {
+        XLOG(DBG2) << "State observer " << stateObservers_[observer]
+                   << " should be notified after " << name
+                   << ", which is not registered";
+        continue;
+      }
+      // Serial observers are all done by the end of the first wave
+      wave = std::max(
+          wave,
+          dependency->notifyConcurrently() ? computeWave(dependency) + 1 : 1);
+    }
+    return waveOf[observer] = wave;
+  };
+
+  for (const auto& [observer, name] : stateObservers_) {
+    // Stat names are built once here rather than on every update
+    ScheduledStateObserver scheduled{
+        observer,
+        name,
+        folly::to<string>(
+            SwitchStats::kCounterPrefix,
+            "state_observer.",
+            name,
+            ".latency_us")};
+    if (!observer->notifyConcurrently() || !stateObserverExecutor_) {
+      schedule.serial.push_back(std::move(scheduled));
+      continue;
+    }
+    auto wave = computeWave(observer);
+    if (schedule.waves.size() <= static_cast<size_t>(wave)) {
+      schedule.waves.resize(wave + 1);
+    }
+    schedule.waves[wave].push_back(std::move(scheduled));
+  }
+  stateObserverSchedule_ =
+      std::make_shared<const StateObserverSchedule>(std::move(schedule));
+}
+
+void SwSwitch::notifyStateObserver(
+    const ScheduledStateObserver& scheduled,
+    const StateDelta& delta) {
+  auto start = steady_clock::now();
+  try {
+    scheduled.observer->stateUpdated(delta);
+  } catch (const std::exception& ex) {
+    // TODO: Figure out the best way to handle errors here.
+    XLOG(FATAL) << "error notifying " << scheduled.name
+                << " of update: " << folly::exceptionStr(ex);
+  }
+  auto duration = duration_cast<microseconds>(steady_clock::now() - start);
+  tcData().addStatValue(scheduled.latencyStat, duration.count(), fb303::AVG);
+}
+
+void SwSwitch::notifyStateObserversConcurrently(
+    const std::vector<ScheduledStateObserver>& observers,
+    const StateDelta& delta,
+    std::vector<folly::SemiFuture<folly::Unit>>* notified) {
+  for (const auto& scheduled : observers) {
+    notified->push_back(
+        folly::via(stateObserverExecutor_.get(), [&scheduled, &delta] {
+          notifyStateObserver(scheduled, delta);
+        }).semi());
+  }
 }
 
 void SwSwitch::notifyStateObservers(const StateDelta& delta) {
@@ -622,16 +770,30 @@ void SwSwitch::notifyStateObservers(const StateDelta& delta) {
     // Make sure the SwSwitch is not already being destroyed
     return;
   }
-  for (auto observerName : stateObservers_) {
-    try {
-      auto observer = observerName.first;
-      observer->stateUpdated(delta);
-    } catch (const std::exception& ex) {
-      // TODO: Figure out the best way to handle errors here.
-      XLOG(FATAL) << "error notifying " << observerName.second
-                  << " of update: " << folly::exceptionStr(ex);
-    }
+  if (!stateObserverSchedule_) {
+    computeStateObserverSchedule();
+  }
+  // Hold on to the schedule, in case an observer registers or unregisters
+  // another while being notified
+  auto schedulePtr = stateObserverSchedule_;
+  const auto& schedule = *schedulePtr;
+
+  // The first wave of concurrent observers runs while the serial ones are
+  // notified here. Concurrent observers only see delta by reference, that is
+  // fine since we wait for all of them before returning.
+  std::vector<folly::SemiFuture<folly::Unit>> notified;
+  if (!schedule.waves.empty()) {
+    notifyStateObserversConcurrently(schedule.waves[0], delta, &notified);
   }
+  for (const auto& scheduled : schedule.serial) {
+    notifyStateObserver(scheduled, delta);
+  }
+  for (size_t wave = 1; wave < schedule.waves.size(); ++wave) {
+    folly::collectAll(std::move(notified)).wait();
+    notified.clear();
+    notifyStateObserversConcurrently(schedule.waves[wave], delta, &notified);
+  }
+  folly::collectAll(std::move(notified)).wait();
 }
 
 void SwSwitch::updateState(unique_ptr<StateUpdate> update) {
@@ -746,8 +908,12 @@ void SwSwitch::handlePendingUpdates() {
 
     shared_ptr<SwitchState> intermediateState;
     XLOG(INFO) << "preparing state update " << update->getName();
+    auto start = steady_clock::now();
     try {
       intermediateState = update->applyUpdate(newDesiredState);
+      ThreadHeartbeat::callbackDone(
+          update->getName(),
+          duration_cast<microseconds>(steady_clock::now() - start));
     } catch (const std::exception& ex) {
       // Call the update's onError() function, and then immediately delete
       // it (therefore removing it from the intrusive list).  This way we won't
@@ -771,7 +937,11 @@ void SwSwitch::handlePendingUpdates() {
   // Now apply the update and notify subscribers
   if (newDesiredState != oldAppliedState) {
     // There was some change during these state updates
+    auto start = steady_clock::now();
     auto newAppliedState = applyUpdate(oldAppliedState, newDesiredState);
+    ThreadHeartbeat::callbackDone(
+        "SwSwitch::applyUpdate",
+        duration_cast<microseconds>(steady_clock::now() - start));
     // Stick the initial applied->desired in the beginning
     bool newOutOfSync = (newAppliedState != newDesiredState);
     fb303::fbData->setCounter("hw_out_of_sync", newOutOfSync);
@@ -802,25 +972,47 @@ void SwSwitch::handlePendingUpdates() {
   }
 }
 
+std::vector<ThreadProfile> SwSwitch::getThreadProfiles() const {
+  std::vector<ThreadProfile> profiles;
+  for (const auto* heartbeat :
+       {bgThreadHeartbeat_.get(),
+        updThreadHeartbeat_.get(),
+        packetTxThreadHeartbeat_.get(),
+        lacpThreadHeartbeat_.get(),
+        neighborCacheThreadHeartbeat_.get()}) {
+    if (heartbeat) {
+      profiles.push_back(heartbeat->getProfile());
+    }
+  }
+  return profiles;
+}
+
 void SwSwitch::setStateInternal(
     std::shared_ptr<SwitchState> newAppliedState,
     std::shared_ptr<SwitchState> newDesiredState) {
-  // This is one of the only two places that should ever directly access
-  // stateDontUseDirectly_.  (getState() being the other one.)
+  // This is one of the only places that should ever directly access
+  // statesDontUseDirectly_.  (getAppliedState()/getDesiredState() being the
+  // others.)
   CHECK(bool(newAppliedState));
   CHECK(bool(newDesiredState));
   CHECK(newAppliedState->isPublished());
   CHECK(newDesiredState->isPublished());
-  folly::SpinLockGuard guard(stateLock_);
-  appliedStateDontUseDirectly_.swap(newAppliedState);
-  desiredStateDontUseDirectly_.swap(newDesiredState);
+  auto newStates = std::make_shared<SwitchStates>();
+  newStates->applied = std::move(newAppliedState);
+  newStates->desired = std::move(newDesiredState);
+  statesDontUseDirectly_.store(std::move(newStates));
 }
 
 void SwSwitch::setDesiredState(std::shared_ptr<SwitchState> newDesiredState) {
   CHECK(bool(newDesiredState));
   CHECK(newDesiredState->isPublished());
-  folly::SpinLockGuard guard(stateLock_);
-  desiredStateDontUseDirectly_.swap(newDesiredState);
+  // States are only ever published from the update thread (or during init
+  // before it starts), so reading the current applied state and publishing
+  // a new snapshot does not race with another writer.
+  auto newStates = std::make_shared<SwitchStates>();
+  newStates->applied = statesDontUseDirectly_.load()->applied;
+  newStates->desired = std::move(newDesiredState);
+  statesDontUseDirectly_.store(std::move(newStates));
 }
 
 std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
@@ -845,10 +1037,10 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
 
   // Inform the HwSwitch of the change.
   //
-  // Note that at this point we have already updated the state pointer and
-  // released stateLock_, so the new state is already published and visible to
-  // other threads.  This does mean that there is a window where the new state
-  // is visible but the hardware is not using the new configuration yet.
+  // Note that at this point we have already updated the state pointer, so
+  // the new state is already published and visible to other threads.  This
+  // does mean that there is a window where the new state is visible but the
+  // hardware is not using the new configuration yet.
   //
   // We could avoid this by holding a lock and block anyone from reading the
   // state while we update the hardware.  However, updating the hardware may
@@ -871,6 +1063,7 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
   }
 
   setStateInternal(newAppliedState, newState);
+  journalAppliedState(oldState, newAppliedState);
 
   // Notifies all observers of the current state update. We notify them that
   // the state changed to "desired state", even if the whole state might not
@@ -886,6 +1079,25 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
   return newAppliedState;
 }
 
+void SwSwitch::journalAppliedState(
+    const std::shared_ptr<SwitchState>& oldState,
+    const std::shared_ptr<SwitchState>& newState) {
+  if (!warmBootJournal_ || oldState == newState) {
+    return;
+  }
+  try {
+    if (oldState) {
+      warmBootJournal_->append(StateDelta(oldState, newState));
+    } else {
+      warmBootJournal_->checkpoint(newState);
+    }
+  } catch (const std::exception& ex) {
+    // Fall back to serializing the whole state on graceful exit
+    XLOG(ERR) << "Disabling warm boot journal: " << folly::exceptionStr(ex);
+    warmBootJournal_.reset();
+  }
+}
+
 void SwSwitch::dumpBadStateUpdate(
     const std::shared_ptr<SwitchState>& oldState,
     const std::shared_ptr<SwitchState>& newState) const {
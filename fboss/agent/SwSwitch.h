@@ -22,6 +22,8 @@
 #include <folly/Range.h>
 #include <folly/SpinLock.h>
 #include <folly/ThreadLocal.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
+#include <folly/futures/Future.h>
 #include <folly/io/async/EventBase.h>
 #include <optional>
 
@@ -31,6 +33,10 @@
 #include <thread>
 #include <type_traits>
 
+namespace folly {
+class CPUThreadPoolExecutor;
+}
+
 namespace facebook::fboss {
 
 class ArpHandler;
@@ -48,11 +54,13 @@ class RxPacket;
 class SwitchState;
 class SwitchStats;
 class StateDelta;
+class NeighborResolutionLimiter;
 class NeighborUpdater;
 class RouteUpdateLogger;
 class StateObserver;
 class TunManager;
 class MirrorManager;
+class WarmBootJournal;
 class LookupClassUpdater;
 class LookupClassRouteUpdater;
 class MacTableManager;
@@ -278,7 +286,8 @@ class SwSwitch : public HwSwitch::Callback {
    * should register using this api.
    *
    * The only required method for observers is stateUpdated and observers can
-   * count on this always being called from the update thread.
+   * count on this always being called from the update thread, unless they opt
+   * in to concurrent notification (see StateObserver::notifyConcurrently()).
    */
   void registerStateObserver(StateObserver* observer, const std::string name);
   void unregisterStateObserver(StateObserver* observer);
@@ -306,6 +315,12 @@ class SwSwitch : public HwSwitch::Callback {
    */
   void publishStats();
 
+  /*
+   * Fold the packet counters every thread bumped since the last call into
+   * the thread-local stats. updateStats() and publishStats() both do this.
+   */
+  void flushPacketCounters();
+
   /*
    * Get the SwitchStats for the current thread.
    *
@@ -529,6 +544,16 @@ class SwSwitch : public HwSwitch::Callback {
     return nUpdater_.get();
   }
 
+  /**
+   * Get the NeighborResolutionLimiter object.
+   *
+   * The NeighborResolutionLimiter returned is owned by the SwSwitch, and is
+   * only valid as long as the SwSwitch object.
+   */
+  NeighborResolutionLimiter* getNeighborResolutionLimiter() {
+    return neighborResolutionLimiter_.get();
+  }
+
   /*
    * Get the PktCaptureManager object.
    */
@@ -550,6 +575,11 @@ class SwSwitch : public HwSwitch::Callback {
     return routeUpdateLogger_.get();
   }
 
+  /*
+   * Profiles of the threads with a heartbeat
+   */
+  std::vector<ThreadProfile> getThreadProfiles() const;
+
   LinkAggregationManager* getLagManager() {
     return lagManager_.get();
   }
@@ -629,8 +659,7 @@ class SwSwitch : public HwSwitch::Callback {
    * to h/w
    */
   std::shared_ptr<SwitchState> getAppliedState() const {
-    folly::SpinLockGuard guard(stateLock_);
-    return appliedStateDontUseDirectly_;
+    return statesDontUseDirectly_.load()->applied;
   }
 
   /*
@@ -652,8 +681,16 @@ class SwSwitch : public HwSwitch::Callback {
    *
    */
   std::shared_ptr<SwitchState> getDesiredState() const {
-    folly::SpinLockGuard guard(stateLock_);
-    return desiredStateDontUseDirectly_;
+    return statesDontUseDirectly_.load()->desired;
+  }
+
+  /*
+   * The applied and desired states, as published together.
+   */
+  std::pair<std::shared_ptr<SwitchState>, std::shared_ptr<SwitchState>>
+  getStates() const {
+    auto states = statesDontUseDirectly_.load();
+    return std::make_pair(states->applied, states->desired);
   }
 
   void publishRxPacket(RxPacket* packet, uint16_t ethertype);
@@ -695,13 +732,6 @@ class SwSwitch : public HwSwitch::Callback {
   SwSwitch(SwSwitch const&) = delete;
   SwSwitch& operator=(SwSwitch const&) = delete;
 
-  std::pair<std::shared_ptr<SwitchState>, std::shared_ptr<SwitchState>>
-  getStates() const {
-    folly::SpinLockGuard guard(stateLock_);
-    return std::make_pair(
-        appliedStateDontUseDirectly_, desiredStateDontUseDirectly_);
-  }
-
   /*
    * Update the current states.
    */
@@ -747,10 +777,28 @@ class SwSwitch : public HwSwitch::Callback {
       const std::shared_ptr<SwitchState>& oldState,
       const std::shared_ptr<SwitchState>& newState) const;
 
+  /*
+   * Record a newly applied state in the warm boot journal, if enabled. With
+   * no oldState the journal starts over from newState. Must be called from
+   * the update thread.
+   */
+  void journalAppliedState(
+      const std::shared_ptr<SwitchState>& oldState,
+      const std::shared_ptr<SwitchState>& newState);
+
   /*
    * Notifies all the observers that a state update occured.
    */
   void notifyStateObservers(const StateDelta& delta);
+  struct ScheduledStateObserver;
+  static void notifyStateObserver(
+      const ScheduledStateObserver& scheduled,
+      const StateDelta& delta);
+  void notifyStateObserversConcurrently(
+      const std::vector<ScheduledStateObserver>& observers,
+      const StateDelta& delta,
+      std::vector<folly::SemiFuture<folly::Unit>>* notified);
+  void computeStateObserverSchedule();
 
   void logLinkStateEvent(PortID port, bool up);
 
@@ -797,9 +845,14 @@ class SwSwitch : public HwSwitch::Callback {
    * short amounts of time when state is being applied, but otherwise should be
    * the same.
    *
+   * Both states are published together as one immutable SwitchStates
+   * snapshot. Readers (thrift threads, packet handlers, observers) only do an
+   * atomic load of the snapshot pointer, so they never contend with each
+   * other or with the update thread publishing a new snapshot, and always see
+   * an applied/desired pair that was published together.
+   *
    * BEWARE: You generally shouldn't access these states directly, even
-   * internally within SwSwitch private methods.  These should only be accessed
-   * while holding stateLock_.
+   * internally within SwSwitch private methods.
    *
    * You almost certainly should call getAppliedState() or getDesiredState() or
    * setStateInternal() instead of directly accessing these.
@@ -807,9 +860,12 @@ class SwSwitch : public HwSwitch::Callback {
    * This intentionally has an awkward name so people won't forget and try to
    * directly access this pointer.
    */
-  std::shared_ptr<SwitchState> appliedStateDontUseDirectly_;
-  std::shared_ptr<SwitchState> desiredStateDontUseDirectly_;
-  mutable folly::SpinLock stateLock_;
+  struct SwitchStates {
+    std::shared_ptr<SwitchState> applied;
+    std::shared_ptr<SwitchState> desired;
+  };
+  folly::atomic_shared_ptr<SwitchStates> statesDontUseDirectly_{
+      std::make_shared<SwitchStates>()};
 
   /*
    * A thread for performing various background tasks.
@@ -870,9 +926,33 @@ class SwSwitch : public HwSwitch::Callback {
    */
   std::map<StateObserver*, std::string> stateObservers_;
 
+  /*
+   * Order in which stateObservers_ get notified. Computed lazily on the next
+   * update after observers are added or removed, since observers register
+   * from their base class constructor, before notifyConcurrently() and
+   * notifyAfter() can be called on them.
+   */
+  struct ScheduledStateObserver {
+    StateObserver* observer;
+    std::string name;
+    // fb303 stat the observer's notification latency is added to
+    std::string latencyStat;
+  };
+  struct StateObserverSchedule {
+    // Notified one after another on the update thread
+    std::vector<ScheduledStateObserver> serial;
+    // Concurrent observers grouped by how deep they are in the notifyAfter()
+    // chains. The first wave runs alongside the serial observers, every
+    // later wave once the previous waves are done.
+    std::vector<std::vector<ScheduledStateObserver>> waves;
+  };
+  std::shared_ptr<const StateObserverSchedule> stateObserverSchedule_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> stateObserverExecutor_;
+
   std::unique_ptr<ArpHandler> arp_;
   std::unique_ptr<IPv4Handler> ipv4_;
   std::unique_ptr<IPv6Handler> ipv6_;
+  std::unique_ptr<NeighborResolutionLimiter> neighborResolutionLimiter_;
   std::unique_ptr<NeighborUpdater> nUpdater_;
   std::unique_ptr<PktCaptureManager> pcapMgr_;
   std::unique_ptr<MirrorManager> mirrorManager_;
@@ -890,6 +970,7 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<LookupClassUpdater> lookupClassUpdater_;
   std::unique_ptr<LookupClassRouteUpdater> lookupClassRouteUpdater_;
   std::unique_ptr<MacTableManager> macTableManager_;
+  std::unique_ptr<WarmBootJournal> warmBootJournal_;
 };
 
 } // namespace facebook::fboss
@@ -44,6 +44,26 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
       arpBadOp_(map, kCounterPrefix + "arp.bad_op", SUM, RATE),
       trapPktNdp_(map, kCounterPrefix + "trapped.ndp", SUM, RATE),
       ipv6NdpBad_(map, kCounterPrefix + "ipv6.ndp.bad", SUM, RATE),
+      neighborResolutionDeduped_(
+          map,
+          kCounterPrefix + "neighbor.resolution.deduped",
+          SUM,
+          RATE),
+      neighborResolutionRateLimited_(
+          map,
+          kCounterPrefix + "neighbor.resolution.rate_limited",
+          SUM,
+          RATE),
+      macLearningFolded_(
+          map,
+          kCounterPrefix + "mac_learning.folded",
+          SUM,
+          RATE),
+      macLearningBackpressure_(
+          map,
+          kCounterPrefix + "mac_learning.backpressure",
+          SUM,
+          RATE),
       ipv4Rx_(map, kCounterPrefix + "trapped.ipv4", SUM, RATE),
       ipv4TooSmall_(map, kCounterPrefix + "ipv4.too_small", SUM, RATE),
       ipv4WrongVer_(map, kCounterPrefix + "ipv4.wrong_version", SUM, RATE),
@@ -183,18 +203,122 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
           map,
           kCounterPrefix + "lldp.validate_mismatch",
           SUM,
+          RATE),
+      routeUpdateLogDropped_(
+          map,
+          kCounterPrefix + "route_update_log.dropped",
+          SUM,
           RATE) {}
 
-PortStats* FOLLY_NULLABLE SwitchStats::port(PortID portID) {
-  auto it = ports_.find(portID);
-  if (it != ports_.end()) {
-    return it->second.get();
+SwitchStats::~SwitchStats() {
+  // Don't lose what was counted since the last flush when the thread exits
+  flushPacketCounters();
+}
+
+SwitchStats::TLTimeseries* SwitchStats::packetCounterSeries(
+    PacketCounter counter) {
+  switch (counter) {
+    case PacketCounter::TRAPPED:
+      return &trapPkts_;
+    case PacketCounter::DROPS:
+      return &trapPktDrops_;
+    case PacketCounter::BOGUS:
+      return &trapPktBogus_;
+    case PacketCounter::ERRORS:
+      return &trapPktErrors_;
+    case PacketCounter::UNHANDLED:
+      return &trapPktUnhandled_;
+    case PacketCounter::TO_HOST:
+      return &trapPktToHost_;
+    case PacketCounter::TO_HOST_BYTES:
+      return &trapPktToHostBytes_;
+    case PacketCounter::FROM_HOST:
+      return &pktFromHost_;
+    case PacketCounter::FROM_HOST_BYTES:
+      return &pktFromHostBytes_;
+    case PacketCounter::ARP:
+      return &trapPktArp_;
+    case PacketCounter::ARP_UNSUPPORTED:
+      return &arpUnsupported_;
+    case PacketCounter::ARP_NOT_MINE:
+      return &arpNotMine_;
+    case PacketCounter::ARP_REQUEST_RX:
+      return &arpRequestsRx_;
+    case PacketCounter::ARP_REQUEST_TX:
+      return &arpRequestsTx_;
+    case PacketCounter::ARP_REPLY_RX:
+      return &arpRepliesRx_;
+    case PacketCounter::ARP_REPLY_TX:
+      return &arpRepliesTx_;
+    case PacketCounter::ARP_BAD_OP:
+      return &arpBadOp_;
+    case PacketCounter::NDP:
+      return &trapPktNdp_;
+    case PacketCounter::NDP_BAD:
+      return &ipv6NdpBad_;
+    case PacketCounter::DHCPV4:
+      return &dhcpV4Pkt_;
+    case PacketCounter::DHCPV4_BAD:
+      return &dhcpV4BadPkt_;
+    case PacketCounter::DHCPV4_DROP:
+      return &dhcpV4DropPkt_;
+    case PacketCounter::DHCPV6:
+      return &dhcpV6Pkt_;
+    case PacketCounter::DHCPV6_BAD:
+      return &dhcpV6BadPkt_;
+    case PacketCounter::DHCPV6_DROP:
+      return &dhcpV6DropPkt_;
+    case PacketCounter::IPV4_RX:
+      return &ipv4Rx_;
+    case PacketCounter::IPV4_TOO_SMALL:
+      return &ipv4TooSmall_;
+    case PacketCounter::IPV4_WRONG_VER:
+      return &ipv4WrongVer_;
+    case PacketCounter::IPV4_NEXTHOP:
+      return &ipv4Nexthop_;
+    case PacketCounter::IPV4_MINE:
+      return &ipv4Mine_;
+    case PacketCounter::IPV4_NO_ARP:
+      return &ipv4NoArp_;
+    case PacketCounter::IPV4_TTL_EXCEEDED:
+      return &ipv4TtlExceeded_;
+    case PacketCounter::IPV6_HOP_EXCEEDED:
+      return &ipv6HopExceeded_;
+    case PacketCounter::UDP_TOO_SMALL:
+      return &udpTooSmall_;
+    case PacketCounter::DST_LOOKUP_FAILURE_V4:
+      return &dstLookupFailureV4_;
+    case PacketCounter::DST_LOOKUP_FAILURE_V6:
+      return &dstLookupFailureV6_;
+    case PacketCounter::DST_LOOKUP_FAILURE:
+      return &dstLookupFailure_;
+    case PacketCounter::TOO_BIG:
+      return &trapPktTooBig_;
+    case PacketCounter::LLDP_RECVD:
+      return &LldpRecvdPkt_;
+    case PacketCounter::LLDP_BAD:
+      return &LldpBadPkt_;
+    case PacketCounter::LLDP_MISMATCH:
+      return &LldpValidateMisMatch_;
+    case PacketCounter::NUM_COUNTERS:
+      break;
   }
-  // Since PortStats needs portName from current switch state, let caller to
-  // decide whether it needs createPortStats function.
+  CHECK(false) << "Unknown packet counter: " << static_cast<int>(counter);
   return nullptr;
 }
 
+void SwitchStats::flushPacketCounters() {
+  auto flushed = flushedCounts_.lock();
+  for (size_t i = 0; i < kNumPacketCounters; ++i) {
+    auto count = packetCounts_[i].load(std::memory_order_relaxed);
+    if (count != (*flushed)[i]) {
+      packetCounterSeries(static_cast<PacketCounter>(i))
+          ->addValue(count - (*flushed)[i]);
+      (*flushed)[i] = count;
+    }
+  }
+}
+
 AggregatePortStats* FOLLY_NULLABLE
 SwitchStats::aggregatePort(AggregatePortID aggregatePortID) {
   auto it = aggregatePortIDToStats_.find(aggregatePortID);
@@ -207,9 +331,22 @@ PortStats* SwitchStats::createPortStats(PortID portID, std::string portName) {
       portID, std::make_unique<PortStats>(portID, portName, this));
   DCHECK(rv.second);
   const auto& it = rv.first;
+  auto index = static_cast<size_t>(portID);
+  if (index >= portIndex_.size()) {
+    portIndex_.resize(index + 1, nullptr);
+  }
+  portIndex_[index] = it->second.get();
   return it->second.get();
 }
 
+void SwitchStats::deletePortStats(PortID portID) {
+  auto index = static_cast<size_t>(portID);
+  if (index < portIndex_.size()) {
+    portIndex_[index] = nullptr;
+  }
+  ports_.erase(portID);
+}
+
 AggregatePortStats* SwitchStats::createAggregatePortStats(
     AggregatePortID id,
     std::string name) {
@@ -12,7 +12,13 @@
 #include <boost/container/flat_map.hpp>
 #include <boost/noncopyable.hpp>
 #include <fb303/ThreadCachedServiceData.h>
+#include <folly/SpinLock.h>
+#include <folly/Synchronized.h>
+#include <folly/lang/Align.h>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <vector>
 #include "fboss/agent/AggregatePortStats.h"
 #include "fboss/agent/PortStats.h"
 #include "fboss/agent/types.h"
@@ -34,11 +40,17 @@ class SwitchStats : public boost::noncopyable {
   static std::string kCounterPrefix;
 
   SwitchStats();
+  ~SwitchStats();
 
   /*
    * Return the PortStats object for the given PortID.
    */
-  PortStats* FOLLY_NULLABLE port(PortID portID);
+  PortStats* FOLLY_NULLABLE port(PortID portID) {
+    // Looked up for every packet received, so index by PortID
+    // rather than searching ports_
+    auto index = static_cast<size_t>(portID);
+    return index < portIndex_.size() ? portIndex_[index] : nullptr;
+  }
 
   AggregatePortStats* FOLLY_NULLABLE
   aggregatePort(AggregatePortID aggregatePortID);
@@ -59,131 +71,149 @@ class SwitchStats : public boost::noncopyable {
       AggregatePortID id,
       std::string name);
 
-  void deletePortStats(PortID portID) {
-    ports_.erase(portID);
-  }
+  void deletePortStats(PortID portID);
+
+  /*
+   * Fold the packet counters bumped since the last call into the exported
+   * stats. This may be called from any thread.
+   */
+  void flushPacketCounters();
 
   void trappedPkt() {
-    trapPkts_.addValue(1);
+    count(PacketCounter::TRAPPED);
   }
   void pktDropped() {
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::DROPS);
   }
   void pktBogus() {
-    trapPktBogus_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::BOGUS);
+    count(PacketCounter::DROPS);
   }
   void pktError() {
-    trapPktErrors_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::ERRORS);
+    count(PacketCounter::DROPS);
   }
   void pktUnhandled() {
-    trapPktUnhandled_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::UNHANDLED);
+    count(PacketCounter::DROPS);
   }
   void pktToHost(uint32_t bytes) {
-    trapPktToHost_.addValue(1);
-    trapPktToHostBytes_.addValue(bytes);
+    count(PacketCounter::TO_HOST);
+    count(PacketCounter::TO_HOST_BYTES, bytes);
   }
   void pktFromHost(uint32_t bytes) {
-    pktFromHost_.addValue(1);
-    pktFromHostBytes_.addValue(bytes);
+    count(PacketCounter::FROM_HOST);
+    count(PacketCounter::FROM_HOST_BYTES, bytes);
   }
 
   void arpPkt() {
-    trapPktArp_.addValue(1);
+    count(PacketCounter::ARP);
   }
   void arpUnsupported() {
-    arpUnsupported_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::ARP_UNSUPPORTED);
+    count(PacketCounter::DROPS);
   }
   void arpNotMine() {
-    arpNotMine_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::ARP_NOT_MINE);
+    count(PacketCounter::DROPS);
   }
   void arpRequestRx() {
-    arpRequestsRx_.addValue(1);
+    count(PacketCounter::ARP_REQUEST_RX);
   }
   void arpRequestTx() {
-    arpRequestsTx_.addValue(1);
+    count(PacketCounter::ARP_REQUEST_TX);
   }
   void arpReplyRx() {
-    arpRepliesRx_.addValue(1);
+    count(PacketCounter::ARP_REPLY_RX);
   }
   void arpReplyTx() {
-    arpRepliesTx_.addValue(1);
+    count(PacketCounter::ARP_REPLY_TX);
   }
   void arpBadOp() {
-    arpBadOp_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::ARP_BAD_OP);
+    count(PacketCounter::DROPS);
   }
 
   void ipv6NdpPkt() {
-    trapPktNdp_.addValue(1);
+    count(PacketCounter::NDP);
   }
   void ipv6NdpBad() {
-    ipv6NdpBad_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::NDP_BAD);
+    count(PacketCounter::DROPS);
+  }
+
+  void neighborResolutionDeduped() {
+    neighborResolutionDeduped_.addValue(1);
+  }
+  void neighborResolutionRateLimited() {
+    neighborResolutionRateLimited_.addValue(1);
+  }
+
+  void macLearningFolded() {
+    macLearningFolded_.addValue(1);
+  }
+  void macLearningBackpressure() {
+    macLearningBackpressure_.addValue(1);
   }
 
   void dhcpV4Pkt() {
-    dhcpV4Pkt_.addValue(1);
+    count(PacketCounter::DHCPV4);
   }
 
   void dhcpV6Pkt() {
-    dhcpV6Pkt_.addValue(1);
+    count(PacketCounter::DHCPV6);
   }
 
   void ipv4Rx() {
-    ipv4Rx_.addValue(1);
+    count(PacketCounter::IPV4_RX);
   }
   void ipv4TooSmall() {
-    ipv4TooSmall_.addValue(1);
+    count(PacketCounter::IPV4_TOO_SMALL);
   }
   void ipv4WrongVer() {
-    ipv4WrongVer_.addValue(1);
+    count(PacketCounter::IPV4_WRONG_VER);
   }
   void ipv4Nexthop() {
-    ipv4Nexthop_.addValue(1);
+    count(PacketCounter::IPV4_NEXTHOP);
   }
   void ipv4Mine() {
-    ipv4Mine_.addValue(1);
+    count(PacketCounter::IPV4_MINE);
   }
   void ipv4NoArp() {
-    ipv4NoArp_.addValue(1);
+    count(PacketCounter::IPV4_NO_ARP);
   }
   void ipv4TtlExceeded() {
-    ipv4TtlExceeded_.addValue(1);
+    count(PacketCounter::IPV4_TTL_EXCEEDED);
   }
 
   void ipv6HopExceeded() {
-    ipv6HopExceeded_.addValue(1);
+    count(PacketCounter::IPV6_HOP_EXCEEDED);
   }
 
   void udpTooSmall() {
-    udpTooSmall_.addValue(1);
+    count(PacketCounter::UDP_TOO_SMALL);
   }
 
   void dhcpV4BadPkt() {
-    dhcpV4BadPkt_.addValue(1);
-    dhcpV4DropPkt_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::DHCPV4_BAD);
+    count(PacketCounter::DHCPV4_DROP);
+    count(PacketCounter::DROPS);
   }
 
   void dhcpV4DropPkt() {
-    dhcpV4DropPkt_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::DHCPV4_DROP);
+    count(PacketCounter::DROPS);
   }
 
   void dhcpV6BadPkt() {
-    dhcpV6BadPkt_.addValue(1);
-    dhcpV6DropPkt_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::DHCPV6_BAD);
+    count(PacketCounter::DHCPV6_DROP);
+    count(PacketCounter::DROPS);
   }
 
   void dhcpV6DropPkt() {
-    dhcpV6DropPkt_.addValue(1);
-    trapPktDrops_.addValue(1);
+    count(PacketCounter::DHCPV6_DROP);
+    count(PacketCounter::DROPS);
   }
 
   void addRouteV4() {
@@ -213,13 +243,13 @@ class SwitchStats : public boost::noncopyable {
   }
 
   void ipv4DstLookupFailure() {
-    dstLookupFailureV4_.addValue(1);
-    dstLookupFailure_.addValue(1);
+    count(PacketCounter::DST_LOOKUP_FAILURE_V4);
+    count(PacketCounter::DST_LOOKUP_FAILURE);
   }
 
   void ipv6DstLookupFailure() {
-    dstLookupFailureV6_.addValue(1);
-    dstLookupFailure_.addValue(1);
+    count(PacketCounter::DST_LOOKUP_FAILURE_V6);
+    count(PacketCounter::DST_LOOKUP_FAILURE);
   }
 
   void stateUpdate(std::chrono::microseconds us) {
@@ -287,17 +317,21 @@ class SwitchStats : public boost::noncopyable {
   }
 
   void pktTooBig() {
-    trapPktTooBig_.addValue(1);
+    count(PacketCounter::TOO_BIG);
   }
 
   void LldpRecvdPkt() {
-    LldpRecvdPkt_.addValue(1);
+    count(PacketCounter::LLDP_RECVD);
   }
   void LldpBadPkt() {
-    LldpBadPkt_.addValue(1);
+    count(PacketCounter::LLDP_BAD);
   }
   void LldpValidateMisMatch() {
-    LldpValidateMisMatch_.addValue(1);
+    count(PacketCounter::LLDP_MISMATCH);
+  }
+
+  void routeUpdateLogDropped() {
+    routeUpdateLogDropped_.addValue(1);
   }
 
  private:
@@ -313,6 +347,71 @@ class SwitchStats : public boost::noncopyable {
 
   explicit SwitchStats(ThreadLocalStatsMap* map);
 
+  /*
+   * Counters bumped for every packet trapped to or sent from the CPU. Rather
+   * than adding to their TLTimeseries (and taking its lock) per packet, the
+   * packet path bumps a plain per thread counter, and flushPacketCounters()
+   * adds what was counted since to the TLTimeseries.
+   */
+  enum class PacketCounter : uint8_t {
+    TRAPPED,
+    DROPS,
+    BOGUS,
+    ERRORS,
+    UNHANDLED,
+    TO_HOST,
+    TO_HOST_BYTES,
+    FROM_HOST,
+    FROM_HOST_BYTES,
+    ARP,
+    ARP_UNSUPPORTED,
+    ARP_NOT_MINE,
+    ARP_REQUEST_RX,
+    ARP_REQUEST_TX,
+    ARP_REPLY_RX,
+    ARP_REPLY_TX,
+    ARP_BAD_OP,
+    NDP,
+    NDP_BAD,
+    DHCPV4,
+    DHCPV4_BAD,
+    DHCPV4_DROP,
+    DHCPV6,
+    DHCPV6_BAD,
+    DHCPV6_DROP,
+    IPV4_RX,
+    IPV4_TOO_SMALL,
+    IPV4_WRONG_VER,
+    IPV4_NEXTHOP,
+    IPV4_MINE,
+    IPV4_NO_ARP,
+    IPV4_TTL_EXCEEDED,
+    IPV6_HOP_EXCEEDED,
+    UDP_TOO_SMALL,
+    DST_LOOKUP_FAILURE_V4,
+    DST_LOOKUP_FAILURE_V6,
+    DST_LOOKUP_FAILURE,
+    TOO_BIG,
+    LLDP_RECVD,
+    LLDP_BAD,
+    LLDP_MISMATCH,
+    // Must be last
+    NUM_COUNTERS,
+  };
+  static constexpr auto kNumPacketCounters =
+      static_cast<size_t>(PacketCounter::NUM_COUNTERS);
+  using PacketCounts = std::array<uint64_t, kNumPacketCounters>;
+
+  void count(PacketCounter counter, uint64_t value = 1) {
+    // Only the thread owning this SwitchStats bumps its counters, so there
+    // is no need for an atomic read-modify-write
+    auto& total = packetCounts_[static_cast<size_t>(counter)];
+    total.store(
+        total.load(std::memory_order_relaxed) + value,
+        std::memory_order_relaxed);
+  }
+  TLTimeseries* packetCounterSeries(PacketCounter counter);
+
   // Total number of trapped packets
   TLTimeseries trapPkts_;
   // Number of trapped packets that were intentionally dropped.
@@ -354,6 +453,16 @@ class SwitchStats : public boost::noncopyable {
   TLTimeseries trapPktNdp_;
   TLTimeseries ipv6NdpBad_;
 
+  // ARP requests and neighbor solicitations for unresolved destinations not
+  // sent since one was already in flight for the same destination
+  TLTimeseries neighborResolutionDeduped_;
+  // ARP requests and neighbor solicitations not sent due to rate limiting
+  TLTimeseries neighborResolutionRateLimited_;
+  // L2 learning updates folded into an update already buffered for the MAC
+  TLTimeseries macLearningFolded_;
+  // Buffered L2 learning updates applied early since the buffer was full
+  TLTimeseries macLearningBackpressure_;
+
   // IPv4 Packets
   TLTimeseries ipv4Rx_;
   // IPv4 packets dropped due to smaller packet size
@@ -465,6 +574,8 @@ class SwitchStats : public boost::noncopyable {
 
   // Individual port stats objects, indexed by PortID
   PortStatsMap ports_;
+  // The same port stats objects, at the offset of their PortID
+  std::vector<PortStats*> portIndex_;
 
   AggregatePortStatsMap aggregatePortIDToStats_;
 
@@ -483,6 +594,16 @@ class SwitchStats : public boost::noncopyable {
   TLTimeseries LldpBadPkt_;
   // Number of LLDP packets that did not match configured, expected values.
   TLTimeseries LldpValidateMisMatch_;
+
+  // Number of route updates the route update logger had to drop
+  TLTimeseries routeUpdateLogDropped_;
+
+  // Kept on their own cache lines, away from the TLTimeseries other threads
+  // lock and the counts the flushing thread writes.
+  alignas(folly::hardware_destructive_interference_size)
+      std::array<std::atomic<uint64_t>, kNumPacketCounters> packetCounts_{};
+  alignas(folly::hardware_destructive_interference_size)
+      folly::Synchronized<PacketCounts, folly::SpinLock> flushedCounts_{};
 };
 
 } // namespace facebook::fboss
@@ -9,12 +9,87 @@
  */
 // Copyright 2014-present Facebook. All Rights Reserved.
 #include "fboss/agent/ThreadHeartbeat.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+#include <time.h>
+#include <algorithm>
+
+DEFINE_uint32(
+    thread_profile_callbacks,
+    10,
+    "Number of slowest callbacks reported in each thread's profile");
 
 using namespace std::chrono;
 
+namespace {
+// Sample the event loop every so many iterations
+constexpr uint32_t kLoopSampleRate = 8;
+// Loop busy times histogram, in usecs
+constexpr int64_t kLoopBucketUsecs = 100;
+constexpr int64_t kLoopMaxUsecs = 100 * 1000;
+// Distinct callbacks tracked per heartbeat interval
+constexpr size_t kMaxCallbacks = 1024;
+
+nanoseconds threadCpuTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return seconds(ts.tv_sec) + nanoseconds(ts.tv_nsec);
+}
+} // namespace
+
 namespace facebook::fboss {
 
+namespace {
+// Heartbeat of the calling thread
+thread_local ThreadHeartbeat* threadHeartbeat{nullptr};
+} // namespace
+
+class ThreadHeartbeat::LoopObserver : public folly::EventBaseObserver {
+ public:
+  explicit LoopObserver(ThreadHeartbeat* heartbeat) : heartbeat_(heartbeat) {}
+
+  uint32_t getSampleRate() const override {
+    return kLoopSampleRate;
+  }
+
+  void loopSample(int64_t busyTime, int64_t idleTime) override {
+    heartbeat_->loopSample(busyTime, idleTime);
+  }
+
+ private:
+  ThreadHeartbeat* heartbeat_;
+};
+
+ThreadHeartbeat::Window::Window()
+    : loopBusyUsecs(kLoopBucketUsecs, 0, kLoopMaxUsecs) {}
+
+ThreadHeartbeat::~ThreadHeartbeat() {
+  evb_->runImmediatelyOrRunInEventBaseThreadAndWait([this]() {
+    cancelTimeout();
+    if (loopObserver_) {
+      evb_->setObserver(nullptr);
+    }
+    if (threadHeartbeat == this) {
+      threadHeartbeat = nullptr;
+    }
+  });
+}
+
+void ThreadHeartbeat::scheduleFirstHeartbeat() {
+  CHECK(evb_->inRunningEventBaseThread());
+  threadHeartbeat = this;
+  loopObserver_ = std::make_shared<LoopObserver>(this);
+  evb_->setObserver(loopObserver_);
+  window_ = std::make_unique<Window>();
+  lastCpuTime_ = threadCpuTime();
+  lastTime_ = steady_clock::now();
+  scheduleTimeout(intervalMsecs_);
+}
+
 void ThreadHeartbeat::timeoutExpired() noexcept {
   CHECK(evb_->inRunningEventBaseThread());
   auto now = steady_clock::now();
@@ -28,8 +103,105 @@ void ThreadHeartbeat::timeoutExpired() noexcept {
                << " delay ms:" << delay.count()
                << " event queue size:" << evbQueueSize;
   }
+  updateProfile(duration_cast<microseconds>(now - lastTime_));
   lastTime_ = now;
   scheduleTimeout(intervalMsecs_);
 }
 
+void ThreadHeartbeat::callbackDone(
+    folly::StringPiece name,
+    microseconds latency) {
+  auto heartbeat = threadHeartbeat;
+  if (!heartbeat) {
+    return;
+  }
+  auto& window = *heartbeat->window_;
+  auto& callbacks = window.callbacks;
+  auto it = callbacks.find(name);
+  if (it == callbacks.end()) {
+    if (callbacks.size() >= kMaxCallbacks) {
+      // Callback names may carry per entity data, so there can be more of
+      // them than we track. Only the slowest get reported: make room for
+      // this one by evicting the fastest, if this one is slower.
+      if (latency.count() <= window.fastestMaxUsecs) {
+        return;
+      }
+      auto fastest = std::min_element(
+          callbacks.begin(),
+          callbacks.end(),
+          [](const auto& lhs, const auto& rhs) {
+            return lhs.second.maxUsecs < rhs.second.maxUsecs;
+          });
+      window.fastestMaxUsecs = fastest->second.maxUsecs;
+      if (latency.count() <= window.fastestMaxUsecs) {
+        return;
+      }
+      callbacks.erase(fastest);
+    }
+    it = callbacks.emplace(name.str(), CallbackStats()).first;
+  }
+  auto& stats = it->second;
+  ++stats.count;
+  stats.totalUsecs += latency.count();
+  stats.maxUsecs = std::max(stats.maxUsecs, int64_t(latency.count()));
+}
+
+void ThreadHeartbeat::loopSample(int64_t busyUsecs, int64_t idleUsecs) {
+  window_->loopBusyUsecs.addValue(busyUsecs);
+  window_->busyUsecs += busyUsecs;
+  window_->idleUsecs += idleUsecs;
+}
+
+void ThreadHeartbeat::updateProfile(microseconds elapsed) {
+  auto cpuTime = threadCpuTime();
+  auto cpuUsecs = duration_cast<microseconds>(cpuTime - lastCpuTime_);
+  lastCpuTime_ = cpuTime;
+
+  ThreadProfile profile;
+  *profile.name_ref() = threadName_;
+  *profile.cpuPct_ref() =
+      elapsed.count() ? cpuUsecs.count() * 100 / elapsed.count() : 0;
+  auto loopUsecs = window_->busyUsecs + window_->idleUsecs;
+  *profile.loopBusyPct_ref() =
+      loopUsecs ? window_->busyUsecs * 100 / loopUsecs : 0;
+  const auto& loopBusy = window_->loopBusyUsecs;
+  *profile.loopBusyP50Usecs_ref() = loopBusy.getPercentileEstimate(0.5);
+  *profile.loopBusyP99Usecs_ref() = loopBusy.getPercentileEstimate(0.99);
+
+  std::vector<ThreadCallbackLatency> callbacks;
+  callbacks.reserve(window_->callbacks.size());
+  for (const auto& [name, stats] : window_->callbacks) {
+    ThreadCallbackLatency callback;
+    *callback.name_ref() = name;
+    *callback.count_ref() = stats.count;
+    *callback.avgUsecs_ref() = stats.totalUsecs / stats.count;
+    *callback.maxUsecs_ref() = stats.maxUsecs;
+    callbacks.push_back(std::move(callback));
+  }
+  auto numCallbacks =
+      std::min<size_t>(callbacks.size(), FLAGS_thread_profile_callbacks);
+  std::partial_sort(
+      callbacks.begin(),
+      callbacks.begin() + numCallbacks,
+      callbacks.end(),
+      [](const auto& lhs, const auto& rhs) {
+        return *lhs.maxUsecs_ref() > *rhs.maxUsecs_ref();
+      });
+  callbacks.resize(numCallbacks);
+  *profile.slowestCallbacks_ref() = std::move(callbacks);
+
+  auto prefix = folly::to<std::string>("thread.", threadName_, ".");
+  fb303::fbData->setCounter(prefix + "cpu_pct", *profile.cpuPct_ref());
+  fb303::fbData->setCounter(
+      prefix + "loop_busy_pct", *profile.loopBusyPct_ref());
+  fb303::fbData->setCounter(
+      prefix + "loop_busy_us.p99", *profile.loopBusyP99Usecs_ref());
+  fb303::fbData->setCounter(
+      prefix + "slowest_callback_us",
+      numCallbacks ? *(*profile.slowestCallbacks_ref())[0].maxUsecs_ref() : 0);
+
+  *profile_.wlock() = std::move(profile);
+  window_ = std::make_unique<Window>();
+}
+
 } // namespace facebook::fboss
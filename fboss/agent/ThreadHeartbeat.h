@@ -9,10 +9,18 @@
  */
 // Copyright 2014-present Facebook. All Rights Reserved.
 #pragma once
+#include "fboss/agent/gen-cpp2/ctrl_types.h"
+
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
 #include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/logging/xlog.h>
+#include <folly/stats/Histogram.h>
 #include <chrono>
+#include <memory>
+#include <string>
 
 namespace facebook::fboss {
 
@@ -21,6 +29,12 @@ class ThreadHeartbeat : private folly::AsyncTimeout {
    * Send heartbeat at regular interval to thread.  Measure delay between
    * time we expect heartbeat to be processed vs. time actually processed,
    * and record it to ods.
+   *
+   * Each heartbeat also profiles the thread over the interval since the
+   * last one: the CPU time it used, how long its event loop spent running
+   * callbacks, and the slowest callbacks timed with callbackDone(). These
+   * are exported to fb303 as thread.<name>.* counters, and returned by
+   * getProfile().
    */
  public:
   ThreadHeartbeat(
@@ -37,19 +51,48 @@ class ThreadHeartbeat : private folly::AsyncTimeout {
     evb_->runInEventBaseThread([this]() { scheduleFirstHeartbeat(); });
   }
 
-  ~ThreadHeartbeat() override {
-    evb_->runImmediatelyOrRunInEventBaseThreadAndWait(
-        [this]() { cancelTimeout(); });
+  ~ThreadHeartbeat() override;
+
+  /*
+   * Record the time taken by a callback run on the calling thread. A no-op
+   * unless the thread has a heartbeat.
+   */
+  static void callbackDone(
+      folly::StringPiece name,
+      std::chrono::microseconds latency);
+
+  /*
+   * Profile of the thread over the last heartbeat interval. May be called
+   * from any thread.
+   */
+  ThreadProfile getProfile() const {
+    return *profile_.rlock();
   }
 
  private:
+  class LoopObserver;
+  struct CallbackStats {
+    int64_t count{0};
+    int64_t totalUsecs{0};
+    int64_t maxUsecs{0};
+  };
+  struct Window {
+    Window();
+
+    folly::Histogram<int64_t> loopBusyUsecs;
+    int64_t busyUsecs{0};
+    int64_t idleUsecs{0};
+    folly::F14FastMap<std::string, CallbackStats> callbacks;
+    // Once callbacks is full, a lower bound on the max latency of every
+    // callback in it. Only grows, as callbacks never get faster.
+    int64_t fastestMaxUsecs{0};
+  };
+
   void timeoutExpired() noexcept override;
 
-  void scheduleFirstHeartbeat() {
-    CHECK(evb_->inRunningEventBaseThread());
-    lastTime_ = std::chrono::steady_clock::now();
-    scheduleTimeout(intervalMsecs_);
-  }
+  void scheduleFirstHeartbeat();
+  void loopSample(int64_t busyUsecs, int64_t idleUsecs);
+  void updateProfile(std::chrono::microseconds elapsed);
 
   folly::EventBase* evb_;
   std::string threadName_;
@@ -59,6 +102,13 @@ class ThreadHeartbeat : private folly::AsyncTimeout {
   // XXX: these thresholds could be made configurable if needed
   int delayThresholdMsecs_ = 1000;
   int backlogThreshold_ = 10;
+
+  // Only accessed from the thread
+  std::shared_ptr<LoopObserver> loopObserver_;
+  std::chrono::nanoseconds lastCpuTime_{0};
+  std::unique_ptr<Window> window_;
+
+  folly::Synchronized<ThreadProfile> profile_;
 };
 
 } // namespace facebook::fboss
@@ -32,6 +32,8 @@
 #include "fboss/agent/state/AggregatePortMap.h"
 #include "fboss/agent/state/ArpEntry.h"
 #include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/ForwardingInformationBaseContainer.h"
+#include "fboss/agent/state/ForwardingInformationBaseMap.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/InterfaceMap.h"
 #include "fboss/agent/state/LabelForwardingEntry.h"
@@ -41,6 +43,7 @@
 #include "fboss/agent/state/PortQueue.h"
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableMap.h"
 #include "fboss/agent/state/RouteTableRib.h"
 #include "fboss/agent/state/RouteUpdater.h"
 #include "fboss/agent/state/StateUtils.h"
@@ -53,6 +56,7 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/MoveWrapper.h>
+#include <folly/Portability.h>
 #include <folly/Range.h>
 #include <folly/container/F14Map.h>
 #include <folly/functional/Partial.h>
@@ -63,7 +67,13 @@
 #include <thrift/lib/cpp/util/EnumUtils.h>
 #include <thrift/lib/cpp2/async/DuplexChannel.h>
 
+#if FOLLY_HAS_COROUTINES
+#include <folly/experimental/coro/AsyncGenerator.h>
+#endif
+
+#include <atomic>
 #include <limits>
+#include <optional>
 
 using apache::thrift::ClientReceiveState;
 using apache::thrift::server::TConnectionContext;
@@ -97,6 +107,16 @@ DEFINE_bool(
     false,
     "Allow external mutations of running config");
 
+DEFINE_int32(
+    route_table_max_page_size,
+    10000,
+    "Maximum number of routes returned in a single route table page");
+
+DEFINE_int32(
+    route_table_stream_chunk_size,
+    1000,
+    "Number of routes sent per chunk when streaming the route table");
+
 namespace facebook::fboss {
 
 namespace util {
@@ -179,36 +199,37 @@ void fillPortStats(PortInfoThrift& portInfo, int numPortQs) {
     *stats.congestionDiscards_ref() =
         getSumStat(queue, "out_congestion_discards_bytes");
     *stats.outBytes_ref() = getSumStat(queue, "out_bytes");
-    portInfo.output_ref()->unicast_ref()->push_back(stats);
+    portInfo.output_ref()->unicast_ref()->push_back(std::move(stats));
   }
 }
 
 void getPortInfoHelper(
-    const SwSwitch& sw,
+    const SwitchState& appliedState,
     PortInfoThrift& portInfo,
-    const std::shared_ptr<Port> port) {
-  *portInfo.portId_ref() = port->getID();
-  *portInfo.name_ref() = port->getName();
-  *portInfo.description_ref() = port->getDescription();
-  *portInfo.speedMbps_ref() = static_cast<int>(port->getSpeed());
-  for (auto entry : port->getVlans()) {
+    const Port& port) {
+  *portInfo.portId_ref() = port.getID();
+  *portInfo.name_ref() = port.getName();
+  *portInfo.description_ref() = port.getDescription();
+  *portInfo.speedMbps_ref() = static_cast<int>(port.getSpeed());
+  portInfo.vlans_ref()->reserve(port.getVlans().size());
+  for (const auto& entry : port.getVlans()) {
     portInfo.vlans_ref()->push_back(entry.first);
   }
 
   std::shared_ptr<QosPolicy> qosPolicy;
-  auto state = sw.getAppliedState();
-  if (port->getQosPolicy().has_value()) {
-    auto appliedPolicyName = port->getQosPolicy();
-    qosPolicy =
-        *appliedPolicyName == state->getDefaultDataPlaneQosPolicy()->getName()
-        ? state->getDefaultDataPlaneQosPolicy()
-        : state->getQosPolicy(*appliedPolicyName);
+  if (port.getQosPolicy().has_value()) {
+    const auto& appliedPolicyName = *port.getQosPolicy();
+    const auto& defaultPolicy = appliedState.getDefaultDataPlaneQosPolicy();
+    qosPolicy = defaultPolicy && appliedPolicyName == defaultPolicy->getName()
+        ? defaultPolicy
+        : appliedState.getQosPolicy(appliedPolicyName);
     if (!qosPolicy) {
       throw std::runtime_error("qosPolicy state is null");
     }
   }
 
-  for (const auto& queue : port->getPortQueues()) {
+  portInfo.portQueues_ref()->reserve(port.getPortQueues().size());
+  for (const auto& queue : port.getPortQueues()) {
     PortQueueThrift pq;
     *pq.id_ref() = queue->getID();
     *pq.mode_ref() =
@@ -244,7 +265,7 @@ void getPortInfoHelper(
             break;
         }
         *aqmThrift.behavior_ref() = QueueCongestionBehavior(aqm.first);
-        aqms.push_back(aqmThrift);
+        aqms.push_back(std::move(aqmThrift));
       }
       pq.aqms_ref() = {};
       pq.aqms_ref()->swap(aqms);
@@ -290,45 +311,47 @@ void getPortInfoHelper(
           queue->getBandwidthBurstMaxKbits().value();
     }
 
-    if (!port->getLookupClassesToDistributeTrafficOn().empty()) {
+    if (!port.getLookupClassesToDistributeTrafficOn().empty()) {
       // On MH-NIC setup, RSW downlinks implement queue-pe-host.
       // For such configurations traffic goes to queue corresponding
       // to host regardless of DSCP value
       auto kMaxDscp = 64;
       std::vector<signed char> dscps(kMaxDscp);
       std::iota(dscps.begin(), dscps.end(), 0);
-      pq.dscps_ref() = dscps;
+      pq.dscps_ref() = std::move(dscps);
     } else if (qosPolicy) {
       std::vector<signed char> dscps;
-      auto tcToDscp = qosPolicy->getDscpMap().from();
-      auto tcToQueueId = qosPolicy->getTrafficClassToQueueId();
-      for (const auto& entry : tcToDscp) {
-        if (tcToQueueId[entry.trafficClass()] == queue->getID()) {
+      const auto& tcToQueueId = qosPolicy->getTrafficClassToQueueId();
+      for (const auto& entry : qosPolicy->getDscpMap().from()) {
+        // Traffic classes without a queue map to queue 0
+        auto itr = tcToQueueId.find(entry.trafficClass());
+        auto queueId = itr == tcToQueueId.end() ? 0 : itr->second;
+        if (queueId == queue->getID()) {
           dscps.push_back(entry.attr());
         }
       }
-      pq.dscps_ref() = dscps;
+      pq.dscps_ref() = std::move(dscps);
     }
 
-    portInfo.portQueues_ref()->push_back(pq);
+    portInfo.portQueues_ref()->push_back(std::move(pq));
   }
 
   *portInfo.adminState_ref() = PortAdminState(
-      port->getAdminState() == facebook::fboss::cfg::PortState::ENABLED);
+      port.getAdminState() == facebook::fboss::cfg::PortState::ENABLED);
   *portInfo.operState_ref() =
-      PortOperState(port->getOperState() == Port::OperState::UP);
+      PortOperState(port.getOperState() == Port::OperState::UP);
 
   // NOTE: this is not 100% accurate on some platforms (mainly
   // Backpack). We will replace with better logic as we add support
   // for new fec types and move over to platform config. We *COULD*
   // hit hardware to ask for this information, but that can lead to
   // interesting failure modes (see T65569157)
-  *portInfo.fecEnabled_ref() = port->getFEC() != cfg::PortFEC::OFF;
-  *portInfo.fecMode_ref() = apache::thrift::util::enumName(port->getFEC());
+  *portInfo.fecEnabled_ref() = port.getFEC() != cfg::PortFEC::OFF;
+  *portInfo.fecMode_ref() = apache::thrift::util::enumName(port.getFEC());
   *portInfo.profileID_ref() =
-      apache::thrift::util::enumName(port->getProfileID());
+      apache::thrift::util::enumName(port.getProfileID());
 
-  auto pause = port->getPause();
+  auto pause = port.getPause();
   *portInfo.txPause_ref() = *pause.tx_ref();
   *portInfo.rxPause_ref() = *pause.rx_ref();
 
@@ -436,7 +459,7 @@ AclEntryThrift populateAclEntryThrift(const AclEntry& aclEntry) {
 }
 
 LinkNeighborThrift thriftLinkNeighbor(
-    const SwSwitch& sw,
+    const SwitchState& state,
     const LinkNeighbor& n,
     steady_clock::time_point now) {
   LinkNeighborThrift tn;
@@ -461,12 +484,217 @@ LinkNeighborThrift thriftLinkNeighbor(
   if (!n.getPortDescription().empty()) {
     tn.portDescription_ref() = n.getPortDescription();
   }
-  const auto port = sw.getState()->getPorts()->getPortIf(n.getLocalPort());
+  const auto port = state.getPorts()->getPortIf(n.getLocalPort());
   if (port) {
     tn.localPortName_ref() = port->getName();
   }
   return tn;
 }
+/*
+ * Walks the unicast routes of an immutable SwitchState snapshot in
+ * (vrf, v4 then v6, prefix) order, converting only the routes that match the
+ * filter and only as many as the caller asks for. The walk can be resumed
+ * after any route, even on a newer snapshot, which is what makes route table
+ * pagination and streaming cheap on large tables.
+ */
+class RouteTableWalker {
+ public:
+  RouteTableWalker(
+      std::shared_ptr<SwitchState> state,
+      bool isStandaloneRib,
+      const RouteTableFilter& filter,
+      const std::optional<RouteTableCursor>& cursor)
+      : state_(std::move(state)), isStandaloneRib_(isStandaloneRib) {
+    if (filter.vrf_ref()) {
+      vrf_ = RouterID(*filter.vrf_ref());
+    }
+    if (filter.clientId_ref()) {
+      clientId_ = ClientID(*filter.clientId_ref());
+    }
+    if (filter.prefix_ref()) {
+      prefix_ = folly::CIDRNetwork(
+          toIPAddress(filter.prefix_ref()->ip),
+          filter.prefix_ref()->prefixLength);
+    }
+    if (cursor) {
+      lastVrf_ = RouterID(*cursor->vrf_ref());
+      lastPrefix_ = folly::CIDRNetwork(
+          toIPAddress(cursor->prefix_ref()->ip),
+          cursor->prefix_ref()->prefixLength);
+    }
+  }
+
+  /*
+   * Append up to maxRoutes matching routes to routes. Returns false once the
+   * whole route table has been walked.
+   */
+  bool nextPage(std::vector<RouteDetails>& routes, size_t maxRoutes) {
+    if (isStandaloneRib_) {
+      for (const auto& fibContainer : *state_->getFibs()) {
+        if (!walkVrf(
+                fibContainer->getID(),
+                *fibContainer->getFibV4(),
+                *fibContainer->getFibV6(),
+                routes,
+                maxRoutes)) {
+          return true;
+        }
+      }
+    } else {
+      for (const auto& routeTable : *state_->getRouteTables()) {
+        if (!walkVrf(
+                routeTable->getID(),
+                *routeTable->getRibV4()->routes(),
+                *routeTable->getRibV6()->routes(),
+                routes,
+                maxRoutes)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  std::optional<RouteTableCursor> cursor() const {
+    if (!lastPrefix_) {
+      return std::nullopt;
+    }
+    RouteTableCursor cursor;
+    *cursor.vrf_ref() = lastVrf_;
+    cursor.prefix_ref()->ip = toBinaryAddress(lastPrefix_->first);
+    cursor.prefix_ref()->prefixLength = lastPrefix_->second;
+    return cursor;
+  }
+
+ private:
+  // Returns false if the page filled up before the vrf was fully walked
+  template <typename RoutesV4, typename RoutesV6>
+  bool walkVrf(
+      RouterID vrf,
+      const RoutesV4& routesV4,
+      const RoutesV6& routesV6,
+      std::vector<RouteDetails>& routes,
+      size_t maxRoutes) {
+    if ((vrf_ && *vrf_ != vrf) || (lastPrefix_ && vrf < lastVrf_)) {
+      return true;
+    }
+    return walkRoutes<folly::IPAddressV4>(vrf, routesV4, routes, maxRoutes) &&
+        walkRoutes<folly::IPAddressV6>(vrf, routesV6, routes, maxRoutes);
+  }
+
+  template <typename AddrT, typename RouteMap>
+  bool walkRoutes(
+      RouterID vrf,
+      const RouteMap& routeMap,
+      std::vector<RouteDetails>& routes,
+      size_t maxRoutes) {
+    constexpr bool kIsV4 = std::is_same_v<AddrT, folly::IPAddressV4>;
+    if (prefix_ && prefix_->first.isV4() != kIsV4) {
+      return true;
+    }
+    const auto& nodes = routeMap.getAllNodes();
+    auto itr = nodes.begin();
+    if (lastPrefix_ && lastVrf_ == vrf) {
+      const auto& lastAddr = lastPrefix_->first;
+      if (lastAddr.isV4() != kIsV4) {
+        if (kIsV4) {
+          // Resuming in the v6 table, all v4 routes were already returned
+          return true;
+        }
+      } else {
+        RoutePrefix<AddrT> last{
+            AddrT::fromBinary(
+                folly::ByteRange(lastAddr.bytes(), lastAddr.byteCount())),
+            lastPrefix_->second};
+        itr = nodes.upper_bound(last);
+      }
+    }
+    for (; itr != nodes.end(); ++itr) {
+      if (routes.size() >= maxRoutes) {
+        return false;
+      }
+      const auto& route = itr->second;
+      if (matches(*route)) {
+        routes.emplace_back(route->toRouteDetails());
+      }
+      lastVrf_ = vrf;
+      lastPrefix_ = folly::CIDRNetwork(itr->first.network, itr->first.mask);
+    }
+    return true;
+  }
+
+  template <typename AddrT>
+  bool matches(const Route<AddrT>& route) const {
+    if (prefix_ &&
+        (route.prefix().mask < prefix_->second ||
+         !folly::IPAddress(route.prefix().network)
+              .inSubnet(prefix_->first, prefix_->second))) {
+      return false;
+    }
+    return !clientId_ || route.getEntryForClient(*clientId_);
+  }
+
+  const std::shared_ptr<SwitchState> state_;
+  const bool isStandaloneRib_;
+  std::optional<RouterID> vrf_;
+  std::optional<ClientID> clientId_;
+  std::optional<folly::CIDRNetwork> prefix_;
+  RouterID lastVrf_{0};
+  std::optional<folly::CIDRNetwork> lastPrefix_;
+};
+
+#if FOLLY_HAS_COROUTINES
+/*
+ * Walk one chunk of routes each time the stream asks for the next item. The
+ * stream only does so once the client has granted credits, so however slow
+ * the client, no more than a chunk of routes is converted ahead of it.
+ */
+folly::coro::AsyncGenerator<std::vector<RouteDetails>&&> routeChunks(
+    std::shared_ptr<RouteTableWalker> walker) {
+  bool more = true;
+  while (more) {
+    std::vector<RouteDetails> chunk;
+    more = walker->nextPage(chunk, FLAGS_route_table_stream_chunk_size);
+    if (!chunk.empty()) {
+      co_yield std::move(chunk);
+    }
+  }
+}
+#else
+using RouteDetailsPublisher =
+    apache::thrift::ServerStreamPublisher<std::vector<RouteDetails>>;
+
+/*
+ * Without coroutines there is no way to wait for the client's credits, so
+ * publish one chunk of routes per background EventBase loop, completing the
+ * stream once the walk is done or the client has gone away.
+ */
+void publishRouteChunks(
+    folly::EventBase* evb,
+    std::shared_ptr<RouteTableWalker> walker,
+    std::shared_ptr<RouteDetailsPublisher> publisher,
+    std::shared_ptr<std::atomic<bool>> cancelled) {
+  evb->runInEventBaseThread([evb,
+                             walker = std::move(walker),
+                             publisher = std::move(publisher),
+                             cancelled = std::move(cancelled)]() mutable {
+    bool more = false;
+    if (!*cancelled) {
+      std::vector<RouteDetails> chunk;
+      more = walker->nextPage(chunk, FLAGS_route_table_stream_chunk_size);
+      if (!chunk.empty()) {
+        publisher->next(std::move(chunk));
+      }
+    }
+    if (more && !*cancelled) {
+      publishRouteChunks(
+          evb, std::move(walker), std::move(publisher), std::move(cancelled));
+    } else {
+      std::move(*publisher).complete();
+    }
+  });
+}
+#endif
 } // namespace
 
 namespace facebook::fboss {
@@ -541,7 +769,7 @@ void ThriftHandler::flushCountersNow() {
   // Depending on how we design the HW-specific stats interface,
   // we may also need to make a separate call to force immediate collection of
   // hardware stats.
-  fb303::ThreadCachedServiceData::get()->publishStats();
+  sw_->publishStats();
 }
 
 void ThriftHandler::addUnicastRouteInVrf(
@@ -721,11 +949,15 @@ void ThriftHandler::updateUnicastRoutesImpl(
 
     sw_->stats()->addRoutesV4(stats.v4RoutesAdded);
     sw_->stats()->addRoutesV6(stats.v6RoutesAdded);
+    sw_->stats()->delRoutesV4(stats.v4RoutesDeleted);
+    sw_->stats()->delRoutesV6(stats.v6RoutesDeleted);
 
     auto totalRouteCount = stats.v4RoutesAdded + stats.v6RoutesAdded;
     sw_->stats()->routeUpdate(stats.duration, totalRouteCount);
-    XLOG(DBG0) << updType << " " << totalRouteCount << " routes took "
-               << stats.duration.count() << "us";
+    XLOG(DBG0) << updType << " " << totalRouteCount << " routes ("
+               << stats.routesUnchanged << " unchanged, "
+               << stats.v4RoutesDeleted + stats.v6RoutesDeleted
+               << " withdrawn) took " << stats.duration.count() << "us";
 
     return;
   }
@@ -816,10 +1048,15 @@ void ThriftHandler::getAllInterfaces(
     std::map<int32_t, InterfaceDetail>& interfaces) {
   auto log = LOG_THRIFT_CALL(DBG1);
   ensureConfigured(__func__);
-  for (const auto& intf : (*sw_->getState()->getInterfaces())) {
-    auto& interfaceDetail = interfaces[intf->getID()];
-    populateInterfaceDetail(interfaceDetail, intf);
-  }
+  auto cached = interfacesCache_.get(
+      sw_->getState()->getInterfaces(), [](const InterfaceMap& intfs) {
+        std::map<int32_t, InterfaceDetail> details;
+        for (const auto& intf : intfs) {
+          populateInterfaceDetail(details[intf->getID()], intf);
+        }
+        return details;
+      });
+  interfaces = *cached;
 }
 
 void ThriftHandler::getInterfaceList(std::vector<std::string>& interfaceList) {
@@ -876,10 +1113,16 @@ void ThriftHandler::getL2Table(std::vector<L2EntryThrift>& l2Table) {
 void ThriftHandler::getAclTable(std::vector<AclEntryThrift>& aclTable) {
   auto log = LOG_THRIFT_CALL(DBG1);
   ensureConfigured(__func__);
-  aclTable.reserve(sw_->getState()->getAcls()->numEntries());
-  for (const auto& aclEntry : *(sw_->getState()->getAcls())) {
-    aclTable.push_back(populateAclEntryThrift(*aclEntry));
-  }
+  auto cached = aclTableCache_.get(
+      sw_->getState()->getAcls(), [](const AclMap& acls) {
+        std::vector<AclEntryThrift> entries;
+        entries.reserve(acls.numEntries());
+        for (const auto& aclEntry : acls) {
+          entries.push_back(populateAclEntryThrift(*aclEntry));
+        }
+        return entries;
+      });
+  aclTable = *cached;
 }
 
 void ThriftHandler::getAggregatePort(
@@ -911,29 +1154,33 @@ void ThriftHandler::getAggregatePortTable(
   auto log = LOG_THRIFT_CALL(DBG1);
   ensureConfigured(__func__);
 
-  // Since aggregatePortsThrift is being push_back'ed to, but is an out
-  // parameter, make sure it's clear() first
-  aggregatePortsThrift.clear();
-
-  aggregatePortsThrift.reserve(sw_->getState()->getAggregatePorts()->size());
-
-  for (const auto& aggregatePort : *(sw_->getState()->getAggregatePorts())) {
-    aggregatePortsThrift.emplace_back();
-
-    populateAggregatePortThrift(aggregatePort, aggregatePortsThrift.back());
-  }
+  auto cached = aggregatePortsCache_.get(
+      sw_->getState()->getAggregatePorts(),
+      [](const AggregatePortMap& aggregatePorts) {
+        std::vector<AggregatePortThrift> aggregatePortsThrift;
+        aggregatePortsThrift.reserve(aggregatePorts.size());
+        for (const auto& aggregatePort : aggregatePorts) {
+          aggregatePortsThrift.emplace_back();
+          populateAggregatePortThrift(
+              aggregatePort, aggregatePortsThrift.back());
+        }
+        return aggregatePortsThrift;
+      });
+  aggregatePortsThrift = *cached;
 }
 
 void ThriftHandler::getPortInfo(PortInfoThrift& portInfo, int32_t portId) {
   auto log = LOG_THRIFT_CALL(DBG1);
   ensureConfigured(__func__);
 
-  const auto port = sw_->getState()->getPorts()->getPortIf(PortID(portId));
+  // Ports are described as desired, QoS policies as applied to hardware
+  auto [appliedState, desiredState] = sw_->getStates();
+  const auto port = desiredState->getPorts()->getPortIf(PortID(portId));
   if (!port) {
     throw FbossError("no such port ", portId);
   }
 
-  getPortInfoHelper(*sw_, portInfo, port);
+  getPortInfoHelper(*appliedState, portInfo, *port);
 }
 
 void ThriftHandler::getAllPortInfo(map<int32_t, PortInfoThrift>& portInfoMap) {
@@ -941,12 +1188,10 @@ void ThriftHandler::getAllPortInfo(map<int32_t, PortInfoThrift>& portInfoMap) {
   ensureConfigured(__func__);
 
   // NOTE: important to take pointer to switch state before iterating over
-  // list of ports
-  std::shared_ptr<SwitchState> swState = sw_->getState();
-  for (const auto& port : *(swState->getPorts())) {
-    auto portId = port->getID();
-    auto& portInfo = portInfoMap[portId];
-    getPortInfoHelper(*sw_, portInfo, port);
+  // list of ports, all ports are then described from this one snapshot
+  auto [appliedState, desiredState] = sw_->getStates();
+  for (const auto& port : *(desiredState->getPorts())) {
+    getPortInfoHelper(*appliedState, portInfoMap[port->getID()], *port);
   }
 }
 
@@ -1169,7 +1414,7 @@ void ThriftHandler::getRouteTable(std::vector<UnicastRoute>& routes) {
     for (const auto& ipv4 : *(routeTable->getRibV4()->routes())) {
       UnicastRoute tempRoute;
       if (!ipv4->isResolved()) {
-        XLOG(INFO) << "Skipping unresolved route: " << ipv4->toFollyDynamic();
+        XLOG(DBG3) << "Skipping unresolved route: " << ipv4->str();
         continue;
       }
       auto fwdInfo = ipv4->getForwardInfo();
@@ -1184,7 +1429,7 @@ void ThriftHandler::getRouteTable(std::vector<UnicastRoute>& routes) {
     for (const auto& ipv6 : *(routeTable->getRibV6()->routes())) {
       UnicastRoute tempRoute;
       if (!ipv6->isResolved()) {
-        XLOG(INFO) << "Skipping unresolved route: " << ipv6->toFollyDynamic();
+        XLOG(DBG3) << "Skipping unresolved route: " << ipv6->str();
         continue;
       }
       auto fwdInfo = ipv6->getForwardInfo();
@@ -1258,6 +1503,61 @@ void ThriftHandler::getRouteTableDetails(std::vector<RouteDetails>& routes) {
   }
 }
 
+void ThriftHandler::getRouteTableDetailsPage(
+    RouteTablePage& page,
+    std::unique_ptr<RouteTablePageRequest> request) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  if (*request->pageSize_ref() <= 0) {
+    throw FbossError(
+        "Invalid route table page size: ", *request->pageSize_ref());
+  }
+  auto pageSize =
+      std::min(*request->pageSize_ref(), FLAGS_route_table_max_page_size);
+  std::optional<RouteTableCursor> cursor;
+  if (request->cursor_ref()) {
+    cursor = *request->cursor_ref();
+  }
+  RouteTableWalker walker(
+      sw_->getAppliedState(),
+      sw_->isStandaloneRibEnabled(),
+      *request->filter_ref(),
+      cursor);
+  page.routes_ref()->reserve(pageSize);
+  if (walker.nextPage(*page.routes_ref(), pageSize)) {
+    if (auto nextCursor = walker.cursor()) {
+      page.nextCursor_ref() = std::move(*nextCursor);
+    }
+  }
+}
+
+apache::thrift::ServerStream<std::vector<RouteDetails>>
+ThriftHandler::streamRouteTableDetails(
+    std::unique_ptr<RouteTableFilter> filter) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  auto walker = std::make_shared<RouteTableWalker>(
+      sw_->getAppliedState(),
+      sw_->isStandaloneRibEnabled(),
+      *filter,
+      std::nullopt);
+#if FOLLY_HAS_COROUTINES
+  return routeChunks(std::move(walker));
+#else
+  auto cancelled = std::make_shared<std::atomic<bool>>(false);
+  auto streamAndPublisher =
+      apache::thrift::ServerStream<std::vector<RouteDetails>>::createPublisher(
+          [cancelled]() { *cancelled = true; });
+  publishRouteChunks(
+      sw_->getBackgroundEvb(),
+      std::move(walker),
+      std::make_shared<RouteDetailsPublisher>(
+          std::move(streamAndPublisher.second)),
+      std::move(cancelled));
+  return std::move(streamAndPublisher.first);
+#endif
+}
+
 void ThriftHandler::getIpRoute(
     UnicastRoute& route,
     std::unique_ptr<Address> addr,
@@ -1328,8 +1628,9 @@ void ThriftHandler::getLldpNeighbors(vector<LinkNeighborThrift>& results) {
   auto neighbors = db->getNeighbors();
   results.reserve(neighbors.size());
   auto now = steady_clock::now();
-  for (const auto& entry : db->getNeighbors()) {
-    results.push_back(thriftLinkNeighbor(*sw_, entry, now));
+  auto state = sw_->getState();
+  for (const auto& entry : neighbors) {
+    results.push_back(thriftLinkNeighbor(*state, entry, now));
   }
 }
 
@@ -1489,6 +1790,12 @@ void ThriftHandler::getMplsRouteUpdateLoggingTrackedLabels(
   }
 }
 
+void ThriftHandler::getThreadProfiles(std::vector<ThreadProfile>& profiles) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  profiles = sw_->getThreadProfiles();
+}
+
 void ThriftHandler::sendPkt(
     int32_t port,
     int32_t vlan,
@@ -16,6 +16,7 @@
 
 #include "common/fb303/cpp/FacebookBase2.h"
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/ThriftResponseCache.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/if/gen-cpp2/FbossCtrl.h"
 #include "fboss/agent/if/gen-cpp2/NeighborListenerClient.h"
@@ -29,7 +30,10 @@
 
 namespace facebook::fboss {
 
+class AclMap;
 class AggregatePort;
+class AggregatePortMap;
+class InterfaceMap;
 class Port;
 class SwSwitch;
 class Vlan;
@@ -165,6 +169,11 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
       std::vector<UnicastRoute>& routeTable,
       int16_t clientId) override;
   void getRouteTableDetails(std::vector<RouteDetails>& routeTable) override;
+  void getRouteTableDetailsPage(
+      RouteTablePage& page,
+      std::unique_ptr<RouteTablePageRequest> request) override;
+  apache::thrift::ServerStream<std::vector<RouteDetails>>
+  streamRouteTableDetails(std::unique_ptr<RouteTableFilter> filter) override;
 
   void getPortStatus(
       std::map<int32_t, PortStatus>& status,
@@ -233,6 +242,8 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   void getMplsRouteUpdateLoggingTrackedLabels(
       std::vector<MplsRouteUpdateLoggingInfo>& infos) override;
 
+  void getThreadProfiles(std::vector<ThreadProfile>& profiles) override;
+
   /*
    * Event handler for when a connection is destroyed.  When there is an ongoing
    * duplex connection, there may be other threads that depend on the connection
@@ -390,6 +401,16 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   int thriftIdleTimeout_;
   std::vector<const TConnectionContext*> brokenClients_;
 
+  /*
+   * Responses of getters whose output only depends on one SwitchState
+   * subtree, rebuilt only when that subtree changes.
+   */
+  ThriftResponseCache<InterfaceMap, std::map<int32_t, InterfaceDetail>>
+      interfacesCache_;
+  ThriftResponseCache<AclMap, std::vector<AclEntryThrift>> aclTableCache_;
+  ThriftResponseCache<AggregatePortMap, std::vector<AggregatePortThrift>>
+      aggregatePortsCache_;
+
   apache::thrift::SSLPolicy sslPolicy_;
 };
 
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/concurrency/AtomicSharedPtr.h>
+
+#include <memory>
+
+namespace facebook::fboss {
+
+/*
+ * Cache of a thrift response computed from a single SwitchState subtree.
+ *
+ * SwitchState is copy-on-write, so a subtree that was not modified by a state
+ * update is the very same node in the old and new states. Keying the cache on
+ * the subtree pointer therefore invalidates it exactly when that subtree
+ * changes, no matter how many unrelated state updates happen in between.
+ *
+ * Lookups and refills are lock free. Readers that miss concurrently may each
+ * build the response, in which case the last one to finish wins. The cached
+ * entry holds a reference to its subtree until it gets replaced, so the key
+ * can never be confused with a newer node allocated at the same address.
+ */
+template <typename NodeT, typename ResponseT>
+class ThriftResponseCache {
+ public:
+  template <typename BuildFn>
+  std::shared_ptr<const ResponseT> get(
+      const std::shared_ptr<NodeT>& node,
+      BuildFn&& build) {
+    auto entry = entry_.load();
+    if (entry && entry->node == node) {
+      return entry->response;
+    }
+    auto newEntry = std::make_shared<Entry>();
+    newEntry->node = node;
+    newEntry->response = std::make_shared<const ResponseT>(build(*node));
+    auto response = newEntry->response;
+    entry_.store(std::move(newEntry));
+    return response;
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<NodeT> node;
+    std::shared_ptr<const ResponseT> response;
+  };
+  folly::atomic_shared_ptr<Entry> entry_;
+};
+
+} // namespace facebook::fboss
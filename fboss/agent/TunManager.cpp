@@ -19,9 +19,12 @@ extern "C" {
 }
 
 #include <folly/MapUtil.h>
+#include <folly/String.h>
+#include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/lang/CString.h>
 #include <folly/logging/xlog.h>
+#include "fboss/agent/NetlinkBatch.h"
 #include "fboss/agent/NlError.h"
 #include "fboss/agent/RxPacket.h"
 #include "fboss/agent/SysError.h"
@@ -35,14 +38,17 @@ extern "C" {
 
 namespace {
 const int kDefaultMtu = 1500;
-}
+// How long to wait before reprogramming interfaces after a netlink failure
+constexpr auto kReconcileDelay = std::chrono::seconds(1);
+} // namespace
 
 namespace facebook::fboss {
 
 using folly::EventBase;
 using folly::IPAddress;
 
-TunManager::TunManager(SwSwitch* sw, EventBase* evb) : sw_(sw), evb_(evb) {
+TunManager::TunManager(SwSwitch* sw, EventBase* evb)
+    : sw_(sw), evb_(evb), netlinkBatch_(std::make_unique<NetlinkBatch>(evb)) {
   DCHECK(sw) << "NULL pointer to SwSwitch.";
   DCHECK(evb) << "NULL pointer to EventBase";
 
@@ -81,8 +87,57 @@ void TunManager::stateUpdated(const StateDelta& delta) {
   // SwSwitch is in the configured state. t4155406 should also help
   // with that.
 
-  auto state = delta.newState();
-  evb_->runInEventBaseThread([this, state]() { this->sync(state); });
+  //
+  // Bursts of state updates are coalesced: only the latest state is kept,
+  // and a sync is scheduled only if none is pending already.
+  bool syncScheduled = false;
+  {
+    auto pendingState = pendingState_.wlock();
+    syncScheduled = *pendingState != nullptr;
+    *pendingState = delta.newState();
+  }
+  if (!syncScheduled) {
+    evb_->runInEventBaseThread([this]() { syncPendingState(); });
+  }
+}
+
+void TunManager::syncPendingState() {
+  std::shared_ptr<SwitchState> state;
+  state.swap(*pendingState_.wlock());
+  if (state) {
+    sync(state);
+  }
+}
+
+void TunManager::markDirty(InterfaceID ifID) {
+  CHECK(evb_->isInEventBaseThread());
+  dirtyIntfs_.insert(ifID);
+  if (!reconcileTimeout_) {
+    reconcileTimeout_ = folly::AsyncTimeout::make(*evb_, [this]() noexcept {
+      // A sync may have happened since, reprogramming the dirty interfaces
+      if (!dirtyIntfs_.empty() && lastSyncedState_) {
+        sync(lastSyncedState_);
+      }
+    });
+  }
+  if (!reconcileTimeout_->isScheduled()) {
+    reconcileTimeout_->scheduleTimeout(
+        std::chrono::duration_cast<std::chrono::milliseconds>(kReconcileDelay));
+  }
+}
+
+void TunManager::reprogramIntf(const TunIntf& intf) {
+  auto ifID = intf.getInterfaceID();
+  XLOG(INFO) << "Reprogramming interface " << intf.getName()
+             << " after netlink failures";
+  addRouteTable(ifID, intf.getIfIndex());
+  for (const auto& [addr, mask] : intf.getAddresses()) {
+    // Rules are not replaced by the kernel, remove any existing one first
+    addRemoveSourceRouteRule(ifID, addr, false);
+    addRemoveSourceRouteRule(ifID, addr, true);
+    addRemoveTunAddress(
+        ifID, intf.getName(), intf.getIfIndex(), addr, mask, true);
+  }
 }
 
 bool TunManager::sendPacketToHost(
@@ -161,8 +216,10 @@ void TunManager::removeIntf(InterfaceID ifID) {
     addRemoveSourceRouteRule(ifID, addr.first, false);
   }
 
-  // Remove the route table and associated rule
+  // Remove the route table and associated rule. They must have been
+  // processed by the kernel before the interface goes away.
   removeRouteTable(ifID, intf->getIfIndex());
+  netlinkBatch_->flushAndWait();
   intf->setDelete();
   intfs_.erase(iter);
 }
@@ -305,28 +362,33 @@ void TunManager::addRemoveRouteTable(InterfaceID ifID, int ifIndex, bool add) {
     rtnl_route_nh_set_ifindex(nexthop, ifIndex);
     rtnl_route_add_nexthop(route, nexthop);
 
+    struct nl_msg* msg{nullptr};
     if (add) {
-      error = rtnl_route_add(sock_, route, NLM_F_REPLACE);
+      error = rtnl_route_build_add_request(route, NLM_F_REPLACE, &msg);
     } else {
-      error = rtnl_route_delete(sock_, route, 0);
+      error = rtnl_route_build_del_request(route, 0, &msg);
     }
+    nlCheckError(error, "Failed to build default route request for ", addr);
+
     /**
-     * Disable: Because of some weird reason this CHECK fails while deleting
-     * v4 default route. However route actually gets wiped off from Linux
+     * Only warn on failures: because of some weird reason removing the v4
+     * default route fails. However route actually gets wiped off from Linux
      * routing table.
-    nlCheckError(error, "Failed to ", add ? "add" : "remove",
-                  " default route ", addr, " @ index ", ifIndex,
-                  " in table ", getTableId(ifID), " for interface ", ifID,
-                  ". ErrorCode: ", error);
-      */
-    if (error < 0) {
-      XLOG(WARNING) << "Failed to " << (add ? "add" : "remove")
-                    << " default route " << addr << " @index " << ifIndex
-                    << ". ErrorCode: " << error;
-    }
-    XLOG(INFO) << (add ? "Added" : "Removed") << " default route " << addr
-               << " @ index " << ifIndex << " in table " << getTableId(ifID)
-               << " for interface " << ifID;
+     */
+    netlinkBatch_->add(msg, [this, add, addr, ifID, ifIndex](int err) {
+      if (err < 0) {
+        XLOG(WARNING) << "Failed to " << (add ? "add" : "remove")
+                      << " default route " << addr << " @index " << ifIndex
+                      << ": " << folly::errnoStr(-err);
+        if (add) {
+          markDirty(ifID);
+        }
+        return;
+      }
+      XLOG(INFO) << (add ? "Added" : "Removed") << " default route " << addr
+                 << " @ index " << ifIndex << " in table " << getTableId(ifID)
+                 << " for interface " << ifID;
+    });
   }
 }
 
@@ -366,32 +428,39 @@ void TunManager::addRemoveSourceRouteRule(
   auto error = rtnl_rule_set_src(rule, sourceaddr);
   nlCheckError(error, "Failed to set destination route to ", addr);
 
+  struct nl_msg* msg{nullptr};
   if (add) {
-    error = rtnl_rule_add(sock_, rule, NLM_F_REPLACE);
+    error = rtnl_rule_build_add_request(rule, NLM_F_REPLACE, &msg);
   } else {
-    error = rtnl_rule_delete(sock_, rule, 0);
-  }
-  nlCheckError(
-      error,
-      "Failed to ",
-      add ? "add" : "remove",
-      " rule for address ",
-      addr,
-      " to lookup table ",
-      getTableId(ifID),
-      " for interface ",
-      ifID);
-  XLOG(INFO) << (add ? "Added" : "Removed") << " rule for address " << addr
-             << " to lookup table " << getTableId(ifID) << " for interface "
-             << ifID;
+    error = rtnl_rule_build_delete_request(rule, 0, &msg);
+  }
+  nlCheckError(error, "Failed to build rule request for address ", addr);
+
+  netlinkBatch_->add(msg, [this, add, addr, ifID](int err) {
+    if (err < 0) {
+      XLOG(ERR) << "Failed to " << (add ? "add" : "remove")
+                << " rule for address " << addr << " to lookup table "
+                << getTableId(ifID) << " for interface " << ifID << ": "
+                << folly::errnoStr(-err);
+      if (add) {
+        markDirty(ifID);
+      }
+      return;
+    }
+    XLOG(INFO) << (add ? "Added" : "Removed") << " rule for address " << addr
+               << " to lookup table " << getTableId(ifID) << " for interface "
+               << ifID;
+  });
 }
 
 void TunManager::addRemoveTunAddress(
+    InterfaceID ifID,
     const std::string& ifName,
     uint32_t ifIndex,
     const folly::IPAddress& addr,
     uint8_t mask,
-    bool add) {
+    bool add,
+    folly::Function<void()> onFailure) {
   auto tunaddr = rtnl_addr_alloc();
   if (!tunaddr) {
     throw FbossError("Failed to allocate address");
@@ -418,6 +487,7 @@ void TunManager::addRemoveTunAddress(
   rtnl_addr_set_prefixlen(tunaddr, mask);
   rtnl_addr_set_ifindex(tunaddr, ifIndex);
 
+  struct nl_msg* msg{nullptr};
   if (add) {
     /**
      * When you bring down interface some routes are purged but some still stay
@@ -426,25 +496,39 @@ void TunManager::addRemoveTunAddress(
      * addresses and routes for that interface with REPLACE flag overriding
      * existing ones if any.
      */
-    error = rtnl_addr_add(sock_, tunaddr, NLM_F_REPLACE);
+    error = rtnl_addr_build_add_request(tunaddr, NLM_F_REPLACE, &msg);
   } else {
-    error = rtnl_addr_delete(sock_, tunaddr, 0);
-  }
-  nlCheckError(
-      error,
-      "Failed to ",
-      add ? "add" : "remove",
-      " address ",
-      addr,
-      "/",
-      static_cast<int>(mask),
-      " to interface ",
-      ifName,
-      " @ index ",
-      ifIndex);
-  XLOG(INFO) << (add ? "Added" : "Removed") << " address " << addr.str() << "/"
-             << static_cast<int>(mask) << " on interface " << ifName
-             << " @ index " << ifIndex;
+    error = rtnl_addr_build_delete_request(tunaddr, 0, &msg);
+  }
+  nlCheckError(error, "Failed to build address request for ", addr);
+
+  netlinkBatch_->add(
+      msg,
+      [this,
+       add,
+       addr,
+       mask,
+       ifID,
+       ifName,
+       ifIndex,
+       onFailure = std::move(onFailure)](int err) mutable {
+        if (err < 0) {
+          XLOG(ERR) << "Failed to " << (add ? "add" : "remove") << " address "
+                    << addr << "/" << static_cast<int>(mask)
+                    << " to interface " << ifName << " @ index " << ifIndex
+                    << ": " << folly::errnoStr(-err);
+          if (onFailure) {
+            onFailure();
+          }
+          if (add) {
+            markDirty(ifID);
+          }
+          return;
+        }
+        XLOG(INFO) << (add ? "Added" : "Removed") << " address " << addr.str()
+                   << "/" << static_cast<int>(mask) << " on interface "
+                   << ifName << " @ index " << ifIndex;
+      });
 }
 
 void TunManager::addTunAddress(
@@ -454,15 +538,11 @@ void TunManager::addTunAddress(
     folly::IPAddress addr,
     uint8_t mask) {
   addRemoveSourceRouteRule(ifID, addr, true);
-  SCOPE_FAIL {
-    try {
-      addRemoveSourceRouteRule(ifID, addr, false);
-    } catch (const std::exception& ex) {
-      XLOG(ERR) << "Failed to removed partially added source rule on "
-                << "interface " << ifName;
-    }
-  };
-  addRemoveTunAddress(ifName, ifIndex, addr, mask, true);
+  // Requests are only ACKed later, roll the rule back if the address fails
+  addRemoveTunAddress(
+      ifID, ifName, ifIndex, addr, mask, true, [this, ifID, ifName, addr]() {
+        rollbackSourceRouteRule(ifID, ifName, addr, false);
+      });
 }
 
 void TunManager::removeTunAddress(
@@ -472,15 +552,24 @@ void TunManager::removeTunAddress(
     folly::IPAddress addr,
     uint8_t mask) {
   addRemoveSourceRouteRule(ifID, addr, false);
-  SCOPE_FAIL {
-    try {
-      addRemoveSourceRouteRule(ifID, addr, true);
-    } catch (const std::exception& ex) {
-      XLOG(ERR) << "Failed to add partially added source rule on "
-                << "interface " << ifName;
-    }
-  };
-  addRemoveTunAddress(ifName, ifIndex, addr, mask, false);
+  addRemoveTunAddress(
+      ifID, ifName, ifIndex, addr, mask, false, [this, ifID, ifName, addr]() {
+        rollbackSourceRouteRule(ifID, ifName, addr, true);
+      });
+}
+
+void TunManager::rollbackSourceRouteRule(
+    InterfaceID ifID,
+    const std::string& ifName,
+    const folly::IPAddress& addr,
+    bool add) {
+  try {
+    addRemoveSourceRouteRule(ifID, addr, add);
+    netlinkBatch_->flush();
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Failed to roll back source rule for " << addr
+              << " on interface " << ifName << ": " << folly::exceptionStr(ex);
+  }
 }
 
 void TunManager::start() const {
@@ -742,7 +831,8 @@ void TunManager::sync(std::shared_ptr<SwitchState> state) {
         if (!oldStatus and newStatus) {
           addRouteTable(ifID, ifIndex);
           for (const auto& addr : newAddrs) {
-            addRemoveTunAddress(ifName, ifIndex, addr.first, addr.second, true);
+            addRemoveTunAddress(
+                ifID, ifName, ifIndex, addr.first, addr.second, true);
           }
         }
 
@@ -760,6 +850,21 @@ void TunManager::sync(std::shared_ptr<SwitchState> state) {
       },
       [&](ConstIntfToAddrsMapIter& oldIter) { removeIntf(oldIter->first); });
 
+  // Reprogram interfaces for which some netlink request failed. Interfaces
+  // that are down get their addresses and routes back once they come up.
+  auto dirtyIntfs = std::move(dirtyIntfs_);
+  dirtyIntfs_.clear();
+  for (auto ifID : dirtyIntfs) {
+    auto iter = intfs_.find(ifID);
+    if (iter != intfs_.end() && iter->second->getStatus()) {
+      reprogramIntf(*iter->second);
+    }
+  }
+
+  // All changes are queued, send them out without waiting for the ACKs
+  netlinkBatch_->flush();
+  lastSyncedState_ = state;
+
   start();
 
   // track number of times sync is called
@@ -9,21 +9,29 @@
  */
 #pragma once
 
+#include <folly/Function.h>
+#include <folly/Synchronized.h>
 #include <folly/io/async/EventBase.h>
 #include "fboss/agent/StateObserver.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/types.h"
 
 #include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
 
 extern "C" {
 #include <netlink/object.h>
 #include <netlink/socket.h>
 }
 
+namespace folly {
+class AsyncTimeout;
+}
+
 namespace facebook::fboss {
 
 class InterfaceMap;
+class NetlinkBatch;
 class RxPacket;
 class SwSwitch;
 class TunIntf;
@@ -35,10 +43,15 @@ class TunManager : public StateObserver {
 
   /**
    * Update the intfs_ map based on the given state update. This
-   * overrides the StateObserver stateUpdated api, which is always
-   * guaranteed to be called from the update thread.
+   * overrides the StateObserver stateUpdated api. The actual sync is
+   * deferred to evb_, so this can be notified concurrently with other
+   * observers. Updates arriving while a sync is pending are coalesced into
+   * a single sync of the latest state.
    */
   void stateUpdated(const StateDelta& delta) override;
+  bool notifyConcurrently() const override {
+    return true;
+  }
 
   /**
    * Send a packet to host.
@@ -145,14 +158,17 @@ class TunManager : public StateObserver {
       bool add);
 
   /**
-   * Add/Remove an address to/from a TUN interface on the host
+   * Add/Remove an address to/from a TUN interface on the host. onFailure is
+   * run if the kernel rejects the request.
    */
   void addRemoveTunAddress(
+      InterfaceID ifID,
       const std::string& ifName,
       uint32_t ifIndex,
       const folly::IPAddress& addr,
       uint8_t mask,
-      bool add);
+      bool add,
+      folly::Function<void()> onFailure = nullptr);
 
   /**
    * Add/Remove address as well source-routing-rule for TUN interface on host.
@@ -169,6 +185,28 @@ class TunManager : public StateObserver {
       uint32_t ifIndex,
       folly::IPAddress addr,
       uint8_t mask);
+  // Undo a source rule change whose address change was rejected
+  void rollbackSourceRouteRule(
+      InterfaceID ifID,
+      const std::string& ifName,
+      const folly::IPAddress& addr,
+      bool add);
+
+  /**
+   * Sync the latest state handed to stateUpdated(), if any.
+   */
+  void syncPendingState();
+
+  /**
+   * Record that programming some of the interface's addresses, rules or
+   * routes failed, and schedule a sync to reprogram it.
+   */
+  void markDirty(InterfaceID ifID);
+
+  /**
+   * Re-add the route table, rules and addresses of an interface.
+   */
+  void reprogramIntf(const TunIntf& intf);
 
   /**
    * Netlink callback for processing and storing links
@@ -221,6 +259,18 @@ class TunManager : public StateObserver {
   // Netlink socket for managing interface/addresses in Host/Linux
   nl_sock* sock_{nullptr};
 
+  // Batches address/rule/route requests, ACKs are processed on evb_
+  std::unique_ptr<NetlinkBatch> netlinkBatch_;
+
+  // Latest state not yet synced, set by stateUpdated()
+  folly::Synchronized<std::shared_ptr<SwitchState>> pendingState_;
+
+  // Everything below is only accessed from evb_
+  std::shared_ptr<SwitchState> lastSyncedState_;
+  // Interfaces to reprogram on the next sync because of netlink failures
+  boost::container::flat_set<InterfaceID> dirtyIntfs_;
+  std::unique_ptr<folly::AsyncTimeout> reconcileTimeout_;
+
   /**
    * The mutex used to protect `intfs_` which can be used by
    * sync() could manipulate intfs_. Called on the thread that serves evb_.
@@ -0,0 +1,28 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/TxPacketTemplate.h"
+
+#include <cstring>
+
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/TxPacket.h"
+
+namespace facebook::fboss {
+
+std::unique_ptr<TxPacket> TxPacketTemplate::instantiate(SwSwitch* sw) const {
+  auto pkt = sw->allocatePacket(frame_.length());
+  if (!pkt) {
+    return nullptr;
+  }
+  memcpy(pkt->buf()->writableData(), frame_.data(), frame_.length());
+  return pkt;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/io/IOBuf.h>
+
+#include <memory>
+
+namespace facebook::fboss {
+
+class SwSwitch;
+class TxPacket;
+
+/*
+ * A frame built once and copied into a new TxPacket for every send, for
+ * control protocols which periodically send the same frame (LLDP, LACP, IPv6
+ * router advertisements). This saves serializing the frame every time;
+ * whatever changes between sends (e.g. LACP actor state) gets patched into
+ * the instantiated packet by the caller.
+ *
+ * We do need a copy per send, since TxPackets must use DMA memory for their
+ * buffers. Where the HwSwitch pools these buffers, the copy is all it costs.
+ */
+class TxPacketTemplate {
+ public:
+  TxPacketTemplate() {}
+  explicit TxPacketTemplate(folly::ByteRange frame)
+      : frame_(folly::IOBuf::COPY_BUFFER, frame.data(), frame.size()) {}
+
+  bool empty() const {
+    return frame_.empty();
+  }
+  const folly::IOBuf& frame() const {
+    return frame_;
+  }
+
+  /*
+   * Allocate a packet and copy the frame into it. Returns nullptr if the
+   * packet could not be allocated.
+   */
+  std::unique_ptr<TxPacket> instantiate(SwSwitch* sw) const;
+
+ private:
+  folly::IOBuf frame_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,797 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/WarmBootJournal.h"
+
+#include "fboss/agent/Constants.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/SysError.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableRib.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMapDelta.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/ScopeGuard.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/hash/Checksum.h>
+#include <folly/json.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+DEFINE_bool(
+    warm_boot_journal,
+    false,
+    "Journal the switch state as it is applied, instead of serializing it "
+    "all on graceful exit");
+DEFINE_uint32(
+    warm_boot_journal_compact_mb,
+    64,
+    "Compact the warm boot journal into a new snapshot once the changes "
+    "following the snapshot exceed both this size (MB) and the snapshot");
+
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::steady_clock;
+
+namespace {
+constexpr auto kJournalFile = "switch_state_journal";
+constexpr char kMagic[8] = {'F', 'B', 'W', 'B', 'J', 'R', 'N', 'L'};
+constexpr uint32_t kVersion = 2;
+constexpr size_t kMinCapacity = 1 << 20;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+};
+static_assert(sizeof(FileHeader) == 16, "Unexpected journal header size");
+
+struct RecordHeader {
+  // Covers the type and the payload
+  uint32_t crc;
+  uint32_t length;
+  uint8_t type;
+  uint8_t reserved[3];
+};
+static_assert(sizeof(RecordHeader) == 12, "Unexpected record header size");
+
+// Keys of the switch state JSON, as SwitchState serializes them
+constexpr auto kAcls = "acls";
+constexpr auto kAggregatePorts = "aggregatePorts";
+constexpr auto kControlPlane = "controlPlane";
+constexpr auto kDefaultDataplaneQosPolicy = "defaultDataPlaneQosPolicy";
+constexpr auto kDefaultVlan = "defaultVlan";
+constexpr auto kInterfaces = "interfaces";
+constexpr auto kLabelForwardingInformationBase = "labelFib";
+constexpr auto kLoadBalancers = "loadBalancers";
+constexpr auto kMirrors = "mirrors";
+constexpr auto kPorts = "ports";
+constexpr auto kQcmCfg = "qcmConfig";
+constexpr auto kQosPolicies = "qosPolicies";
+constexpr auto kRouteTables = "routeTables";
+constexpr auto kRoutes = "routes";
+constexpr auto kSflowCollectors = "sFlowCollectors";
+constexpr auto kSwitchSettings = "switchSettings";
+constexpr auto kVlans = "vlans";
+constexpr auto kArpTable = "arpTable";
+constexpr auto kNdpTable = "ndpTable";
+constexpr auto kMacTable = "macTable";
+
+// Keys of a journaled change
+constexpr auto kFields = "fields";
+constexpr auto kNodes = "nodes";
+constexpr auto kRouteChanges = "routes";
+constexpr auto kSet = "set";
+constexpr auto kErase = "erase";
+} // namespace
+
+namespace facebook::fboss {
+
+namespace {
+
+uint32_t recordCrc(uint8_t type, const uint8_t* payload, size_t length) {
+  return folly::crc32c(payload, length, folly::crc32c(&type, 1));
+}
+
+template <typename IdT>
+std::string journalKey(const IdT& id) {
+  return folly::to<std::string>(id);
+}
+
+template <typename AddrT>
+std::string journalKey(const RoutePrefix<AddrT>& prefix) {
+  return prefix.str();
+}
+
+std::string journalKey(const folly::MacAddress& mac) {
+  return mac.toString();
+}
+
+/*
+ * Node maps journaled node by node are held as objects keyed by node ID,
+ * rather than arrays, so that changes can find the nodes they replace.
+ * entries is map serialized.
+ */
+template <typename MapT>
+void keyEntries(folly::dynamic& entries, const MapT& map) {
+  DCHECK_EQ(entries.size(), map.size());
+  folly::dynamic keyed = folly::dynamic::object;
+  size_t i = 0;
+  for (const auto& node : map) {
+    keyed[journalKey(node->getID())] = std::move(entries[i++]);
+  }
+  entries = std::move(keyed);
+}
+
+void unkeyEntries(folly::dynamic& keyed) {
+  folly::dynamic entries = folly::dynamic::array;
+  for (auto& entry : keyed.items()) {
+    entries.push_back(std::move(entry.second));
+  }
+  keyed = std::move(entries);
+}
+
+void keyRoutes(folly::dynamic& json, const RouteTable& table) {
+  keyEntries(json[kRibV4][kRoutes], *table.getRibV4()->routes());
+  keyEntries(json[kRibV6][kRoutes], *table.getRibV6()->routes());
+}
+
+folly::dynamic journaledRouteTable(const RouteTable& table) {
+  auto json = table.toFollyDynamic();
+  keyRoutes(json, table);
+  return json;
+}
+
+/*
+ * The MAC and neighbor tables of VLANs are keyed by entry, like the maps
+ * journaled node by node. vlanJson is vlan serialized.
+ */
+void keyVlanTables(folly::dynamic& vlanJson, const Vlan& vlan) {
+  keyEntries(vlanJson[kArpTable][kEntries], *vlan.getArpTable());
+  keyEntries(vlanJson[kNdpTable][kEntries], *vlan.getNdpTable());
+  keyEntries(vlanJson[kMacTable][kEntries], *vlan.getMacTable());
+}
+
+void unkeyVlanTables(folly::dynamic& vlanJson) {
+  unkeyEntries(vlanJson[kArpTable][kEntries]);
+  unkeyEntries(vlanJson[kNdpTable][kEntries]);
+  unkeyEntries(vlanJson[kMacTable][kEntries]);
+}
+
+folly::dynamic journaledState(const SwitchState& state) {
+  auto json = state.toFollyDynamic();
+  keyEntries(json[kPorts][kEntries], *state.getPorts());
+  auto& vlans = json[kVlans][kEntries];
+  size_t i = 0;
+  for (const auto& vlan : *state.getVlans()) {
+    keyVlanTables(vlans[i++], *vlan);
+  }
+  keyEntries(vlans, *state.getVlans());
+  auto& tables = json[kRouteTables][kEntries];
+  i = 0;
+  for (const auto& table : *state.getRouteTables()) {
+    keyRoutes(tables[i++], *table);
+  }
+  keyEntries(tables, *state.getRouteTables());
+  return json;
+}
+
+/*
+ * A VLAN less the entries of its MAC and neighbor tables, which are
+ * journaled entry by entry.
+ */
+folly::dynamic journaledVlan(const Vlan& vlan) {
+  auto fields = *vlan.getFields();
+  fields.arpTable = std::make_shared<ArpTable>();
+  fields.ndpTable = std::make_shared<NdpTable>();
+  fields.macTable = std::make_shared<MacTable>();
+  auto json = fields.toFollyDynamic();
+  json[kArpTable][kEntries] = folly::dynamic::object;
+  json[kNdpTable][kEntries] = folly::dynamic::object;
+  json[kMacTable][kEntries] = folly::dynamic::object;
+  return json;
+}
+
+template <typename NodeT>
+void journalField(
+    folly::dynamic& fields,
+    folly::StringPiece name,
+    const std::shared_ptr<NodeT>& oldNode,
+    const std::shared_ptr<NodeT>& newNode) {
+  if (oldNode == newNode) {
+    return;
+  }
+  fields[name] = newNode ? newNode->toFollyDynamic() : folly::dynamic(nullptr);
+}
+
+template <typename MapDeltaT>
+folly::dynamic nodeChanges(const MapDeltaT& delta) {
+  folly::dynamic set = folly::dynamic::object;
+  folly::dynamic erase = folly::dynamic::array;
+  for (const auto& nodeDelta : delta) {
+    if (const auto& newNode = nodeDelta.getNew()) {
+      set[journalKey(newNode->getID())] = newNode->toFollyDynamic();
+    } else {
+      erase.push_back(journalKey(nodeDelta.getOld()->getID()));
+    }
+  }
+  return folly::dynamic::object(kSet, std::move(set))(kErase, std::move(erase));
+}
+
+bool hasNodeChanges(const folly::dynamic& changes) {
+  return !changes[kSet].empty() || !changes[kErase].empty();
+}
+
+void applyNodeChanges(folly::dynamic& keyed, const folly::dynamic& changes) {
+  for (const auto& entry : changes[kSet].items()) {
+    keyed[entry.first] = entry.second;
+  }
+  for (const auto& key : changes[kErase]) {
+    keyed.erase(key);
+  }
+}
+
+/*
+ * Changes to VLANs, less changes to their MAC and neighbor tables.
+ */
+folly::dynamic vlanChanges(const VlanMapDelta& delta) {
+  folly::dynamic set = folly::dynamic::object;
+  folly::dynamic erase = folly::dynamic::array;
+  for (const auto& vlanDelta : delta) {
+    const auto& oldVlan = vlanDelta.getOld();
+    const auto& newVlan = vlanDelta.getNew();
+    if (!newVlan) {
+      erase.push_back(journalKey(oldVlan->getID()));
+      continue;
+    }
+    auto vlan = journaledVlan(*newVlan);
+    if (!oldVlan || vlan != journaledVlan(*oldVlan)) {
+      set[journalKey(newVlan->getID())] = std::move(vlan);
+    }
+  }
+  return folly::dynamic::object(kSet, std::move(set))(kErase, std::move(erase));
+}
+
+/*
+ * Replaced VLANs keep the entries of their MAC and neighbor tables, which
+ * only change through VLAN_TABLES records.
+ */
+void applyVlanChanges(folly::dynamic& keyed, const folly::dynamic& changes) {
+  for (const auto& entry : changes[kSet].items()) {
+    auto vlan = entry.second;
+    if (auto oldVlan = keyed.get_ptr(entry.first)) {
+      for (auto table : {kArpTable, kNdpTable, kMacTable}) {
+        vlan[table][kEntries] = std::move((*oldVlan)[table][kEntries]);
+      }
+    }
+    keyed[entry.first] = std::move(vlan);
+  }
+  for (const auto& key : changes[kErase]) {
+    keyed.erase(key);
+  }
+}
+
+template <typename TableT, typename TableDeltaT>
+void journalTable(
+    folly::dynamic& tables,
+    folly::StringPiece name,
+    const std::shared_ptr<TableT>& oldTable,
+    const std::shared_ptr<TableT>& newTable,
+    const TableDeltaT& delta) {
+  if (oldTable == newTable) {
+    return;
+  }
+  auto changes = nodeChanges(delta);
+  if (hasNodeChanges(changes)) {
+    tables[name] = std::move(changes);
+  }
+}
+
+/*
+ * Changes to the MAC and neighbor tables of VLANs from delta.oldState() to
+ * delta.newState(), keyed by VLAN. Tables of removed VLANs go with them.
+ */
+folly::dynamic journaledVlanTableChanges(const StateDelta& delta) {
+  folly::dynamic vlans = folly::dynamic::object;
+  if (delta.oldState()->getVlans() == delta.newState()->getVlans()) {
+    return vlans;
+  }
+  for (const auto& vlanDelta : delta.getVlansDelta()) {
+    const auto& oldVlan = vlanDelta.getOld();
+    const auto& newVlan = vlanDelta.getNew();
+    if (!newVlan) {
+      continue;
+    }
+    folly::dynamic tables = folly::dynamic::object;
+    journalTable(
+        tables,
+        kArpTable,
+        oldVlan ? oldVlan->getArpTable() : nullptr,
+        newVlan->getArpTable(),
+        vlanDelta.getArpDelta());
+    journalTable(
+        tables,
+        kNdpTable,
+        oldVlan ? oldVlan->getNdpTable() : nullptr,
+        newVlan->getNdpTable(),
+        vlanDelta.getNdpDelta());
+    journalTable(
+        tables,
+        kMacTable,
+        oldVlan ? oldVlan->getMacTable() : nullptr,
+        newVlan->getMacTable(),
+        vlanDelta.getMacDelta());
+    if (!tables.empty()) {
+      vlans[journalKey(newVlan->getID())] = std::move(tables);
+    }
+  }
+  return vlans;
+}
+
+void applyVlanTableChanges(folly::dynamic& state, const folly::dynamic& vlans) {
+  auto& keyed = state.at(kVlans).at(kEntries);
+  for (const auto& vlanChanges : vlans.items()) {
+    auto& vlan = keyed.at(vlanChanges.first);
+    for (const auto& tableChanges : vlanChanges.second.items()) {
+      applyNodeChanges(
+          vlan.at(tableChanges.first).at(kEntries), tableChanges.second);
+    }
+  }
+}
+
+/*
+ * Changes from delta.oldState() to delta.newState(), or null if nothing
+ * that gets serialized changed.
+ */
+folly::dynamic journaledChanges(const StateDelta& delta) {
+  const auto& oldState = delta.oldState();
+  const auto& newState = delta.newState();
+
+  folly::dynamic fields = folly::dynamic::object;
+  journalField(
+      fields,
+      kInterfaces,
+      oldState->getInterfaces(),
+      newState->getInterfaces());
+  journalField(
+      fields,
+      kAggregatePorts,
+      oldState->getAggregatePorts(),
+      newState->getAggregatePorts());
+  journalField(fields, kAcls, oldState->getAcls(), newState->getAcls());
+  journalField(
+      fields,
+      kSflowCollectors,
+      oldState->getSflowCollectors(),
+      newState->getSflowCollectors());
+  journalField(
+      fields,
+      kControlPlane,
+      oldState->getControlPlane(),
+      newState->getControlPlane());
+  journalField(
+      fields,
+      kLoadBalancers,
+      oldState->getLoadBalancers(),
+      newState->getLoadBalancers());
+  journalField(
+      fields, kMirrors, oldState->getMirrors(), newState->getMirrors());
+  journalField(
+      fields,
+      kLabelForwardingInformationBase,
+      oldState->getLabelForwardingInformationBase(),
+      newState->getLabelForwardingInformationBase());
+  journalField(
+      fields,
+      kSwitchSettings,
+      oldState->getSwitchSettings(),
+      newState->getSwitchSettings());
+  journalField(fields, kQcmCfg, oldState->getQcmCfg(), newState->getQcmCfg());
+  journalField(
+      fields,
+      kDefaultDataplaneQosPolicy,
+      oldState->getDefaultDataPlaneQosPolicy(),
+      newState->getDefaultDataPlaneQosPolicy());
+  journalField(
+      fields,
+      kQosPolicies,
+      oldState->getQosPolicies(),
+      newState->getQosPolicies());
+  if (oldState->getDefaultVlan() != newState->getDefaultVlan()) {
+    fields[kDefaultVlan] = static_cast<uint32_t>(newState->getDefaultVlan());
+  }
+
+  folly::dynamic nodes = folly::dynamic::object;
+  if (oldState->getPorts() != newState->getPorts()) {
+    nodes[kPorts] = nodeChanges(delta.getPortsDelta());
+  }
+  if (oldState->getVlans() != newState->getVlans()) {
+    auto vlans = vlanChanges(delta.getVlansDelta());
+    if (hasNodeChanges(vlans)) {
+      nodes[kVlans] = std::move(vlans);
+    }
+  }
+
+  folly::dynamic routes = folly::dynamic::object;
+  if (oldState->getRouteTables() != newState->getRouteTables()) {
+    folly::dynamic set = folly::dynamic::object;
+    folly::dynamic erase = folly::dynamic::array;
+    for (const auto& tableDelta : delta.getRouteTablesDelta()) {
+      const auto& oldTable = tableDelta.getOld();
+      const auto& newTable = tableDelta.getNew();
+      if (!oldTable) {
+        set[journalKey(newTable->getID())] = journaledRouteTable(*newTable);
+      } else if (!newTable) {
+        erase.push_back(journalKey(oldTable->getID()));
+      } else {
+        routes[journalKey(newTable->getID())] =
+            folly::dynamic::object(
+                kRibV4, nodeChanges(tableDelta.getRoutesV4Delta()))(
+                kRibV6, nodeChanges(tableDelta.getRoutesV6Delta()));
+      }
+    }
+    nodes[kRouteTables] =
+        folly::dynamic::object(kSet, std::move(set))(kErase, std::move(erase));
+  }
+
+  if (fields.empty() && nodes.empty() && routes.empty()) {
+    return nullptr;
+  }
+  return folly::dynamic::object(kFields, std::move(fields))(
+      kNodes, std::move(nodes))(kRouteChanges, std::move(routes));
+}
+
+void applyChanges(folly::dynamic& state, const folly::dynamic& changes) {
+  for (const auto& field : changes[kFields].items()) {
+    if (field.second.isNull()) {
+      state.erase(field.first);
+    } else {
+      state[field.first] = field.second;
+    }
+  }
+  for (const auto& map : changes[kNodes].items()) {
+    if (map.first == kVlans) {
+      applyVlanChanges(state.at(kVlans).at(kEntries), map.second);
+    } else {
+      applyNodeChanges(state.at(map.first).at(kEntries), map.second);
+    }
+  }
+  auto& tables = state.at(kRouteTables).at(kEntries);
+  for (const auto& tableChanges : changes[kRouteChanges].items()) {
+    auto& table = tables.at(tableChanges.first);
+    for (const auto& ribChanges : tableChanges.second.items()) {
+      applyNodeChanges(
+          table.at(ribChanges.first).at(kRoutes), ribChanges.second);
+    }
+  }
+}
+
+} // namespace
+
+WarmBootJournal::WarmBootJournal(const std::string& path) : path_(path) {}
+
+WarmBootJournal::~WarmBootJournal() {
+  if (compactionExecutor_) {
+    compactionExecutor_->join();
+  }
+}
+
+std::string WarmBootJournal::path(const std::string& warmBootDir) {
+  return folly::to<std::string>(warmBootDir, "/", kJournalFile);
+}
+
+size_t WarmBootJournal::size() const {
+  return file_ ? file_->size() : 0;
+}
+
+void WarmBootJournal::checkpoint(const std::shared_ptr<SwitchState>& state) {
+  steady_clock::time_point begin = steady_clock::now();
+  if (compaction_.valid()) {
+    // Superseded by this snapshot
+    std::move(compaction_).getTry();
+    compactionRecords_.clear();
+  }
+  install(writeSnapshot(state));
+  snapshotSize_ = file_->size();
+  XLOG(DBG2) << "Checkpointed warm boot journal, snapshot of " << snapshotSize_
+             << " bytes in "
+             << duration_cast<duration<float>>(steady_clock::now() - begin)
+                    .count();
+}
+
+void WarmBootJournal::append(const StateDelta& delta) {
+  if (!file_) {
+    throw FbossError(
+        "warm boot journal ", path_, " appended to before a checkpoint");
+  }
+  auto changes = journaledChanges(delta);
+  if (!changes.isNull()) {
+    appendRecord(RecordType::DELTA, folly::toJson(changes));
+  }
+  auto tableChanges = journaledVlanTableChanges(delta);
+  if (!tableChanges.empty()) {
+    appendRecord(RecordType::VLAN_TABLES, folly::toJson(tableChanges));
+  }
+
+  if (compaction_.valid()) {
+    if (compaction_.isReady()) {
+      finishCompaction();
+    }
+    return;
+  }
+  // Compact once replaying the changes would cost more than the snapshot
+  auto compactBytes = std::max(
+      snapshotSize_,
+      static_cast<size_t>(FLAGS_warm_boot_journal_compact_mb) << 20);
+  if (file_->size() - snapshotSize_ > compactBytes) {
+    if (!compactionExecutor_) {
+      compactionExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+          1, std::make_shared<folly::NamedThreadFactory>("WarmBootJournal"));
+    }
+    auto state = delta.newState();
+    compaction_ =
+        folly::via(compactionExecutor_.get(), [this, state]() {
+          return writeSnapshot(state);
+        }).semi();
+  }
+}
+
+void WarmBootJournal::sync() {
+  if (compaction_.valid()) {
+    finishCompaction();
+  }
+  if (file_) {
+    file_->sync();
+  }
+}
+
+std::unique_ptr<WarmBootJournal::File> WarmBootJournal::writeSnapshot(
+    const std::shared_ptr<SwitchState>& state) const {
+  steady_clock::time_point begin = steady_clock::now();
+  auto snapshot = folly::toJson(journaledState(*state));
+
+  auto tmpPath = folly::to<std::string>(path_, ".tmp");
+  auto fd = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0) {
+    throw SysError(errno, "failed to create warm boot journal ", tmpPath);
+  }
+  auto file = std::make_unique<File>(tmpPath, fd);
+  file->appendHeader();
+  file->appendRecord(RecordType::SNAPSHOT, snapshot);
+  // The snapshot must be on disk before the file can replace the journal
+  file->sync();
+  XLOG(DBG2) << "Wrote warm boot journal snapshot of " << file->size()
+             << " bytes in "
+             << duration_cast<duration<float>>(steady_clock::now() - begin)
+                    .count();
+  return file;
+}
+
+void WarmBootJournal::install(std::unique_ptr<File> file) {
+  auto tmpPath = folly::to<std::string>(path_, ".tmp");
+  if (rename(tmpPath.c_str(), path_.c_str()) < 0) {
+    throw SysError(errno, "failed to rename ", tmpPath, " to ", path_);
+  }
+  // Make the rename itself durable
+  auto slash = path_.rfind('/');
+  auto dir = slash == std::string::npos ? "." : path_.substr(0, slash);
+  auto dirFd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (dirFd < 0) {
+    throw SysError(errno, "failed to open warm boot directory ", dir);
+  }
+  SCOPE_EXIT {
+    close(dirFd);
+  };
+  if (fsync(dirFd) < 0) {
+    throw SysError(errno, "failed to sync warm boot directory ", dir);
+  }
+  file_ = std::move(file);
+}
+
+void WarmBootJournal::appendRecord(RecordType type, std::string payload) {
+  file_->appendRecord(type, payload);
+  if (compaction_.valid()) {
+    // Also belongs after the snapshot being compacted
+    compactionRecords_.emplace_back(type, std::move(payload));
+  }
+}
+
+void WarmBootJournal::finishCompaction() {
+  SCOPE_EXIT {
+    compactionRecords_.clear();
+  };
+  auto file = std::move(compaction_).get();
+  auto snapshotSize = file->size();
+  for (const auto& record : compactionRecords_) {
+    file->appendRecord(record.first, record.second);
+  }
+  install(std::move(file));
+  snapshotSize_ = snapshotSize;
+  XLOG(DBG2) << "Compacted warm boot journal, snapshot of " << snapshotSize_
+             << " bytes followed by " << compactionRecords_.size()
+             << " changes";
+}
+
+WarmBootJournal::File::~File() {
+  unmap();
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void WarmBootJournal::File::appendHeader() {
+  reserve(sizeof(FileHeader));
+  FileHeader header{};
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  memcpy(base_, &header, sizeof(header));
+  tail_ = sizeof(header);
+}
+
+void WarmBootJournal::File::appendRecord(
+    RecordType type,
+    const std::string& payload) {
+  reserve(sizeof(RecordHeader) + payload.size());
+  RecordHeader header{};
+  header.type = static_cast<uint8_t>(type);
+  header.length = payload.size();
+  header.crc = recordCrc(
+      header.type,
+      reinterpret_cast<const uint8_t*>(payload.data()),
+      payload.size());
+  // Past the tail the file is zeroed, which replay takes as the end of the
+  // journal. The CRC catches records only partly written.
+  auto record = base_ + tail_;
+  memcpy(record + sizeof(header), payload.data(), payload.size());
+  memcpy(record, &header, sizeof(header));
+  tail_ += sizeof(header) + payload.size();
+}
+
+void WarmBootJournal::File::sync() {
+  if (!base_) {
+    return;
+  }
+  if (msync(base_, tail_, MS_SYNC) < 0) {
+    throw SysError(errno, "failed to sync warm boot journal ", path_);
+  }
+  if (fsync(fd_) < 0) {
+    throw SysError(errno, "failed to sync warm boot journal ", path_);
+  }
+}
+
+void WarmBootJournal::File::reserve(size_t bytes) {
+  if (tail_ + bytes <= capacity_) {
+    return;
+  }
+  auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  auto capacity = std::max({kMinCapacity, capacity_ * 2, tail_ + bytes});
+  capacity = (capacity + pageSize - 1) / pageSize * pageSize;
+  if (ftruncate(fd_, capacity) < 0) {
+    throw SysError(errno, "failed to grow warm boot journal ", path_);
+  }
+  unmap();
+  auto base =
+      mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (base == MAP_FAILED) {
+    throw SysError(errno, "failed to map warm boot journal ", path_);
+  }
+  base_ = static_cast<uint8_t*>(base);
+  capacity_ = capacity;
+}
+
+void WarmBootJournal::File::unmap() {
+  if (base_) {
+    munmap(base_, capacity_);
+    base_ = nullptr;
+    capacity_ = 0;
+  }
+}
+
+folly::dynamic WarmBootJournal::replay(const std::string& path) {
+  steady_clock::time_point begin = steady_clock::now();
+  std::string journal;
+  if (!folly::readFile(path.c_str(), journal)) {
+    throw FbossError("unable to read warm boot journal ", path);
+  }
+  FileHeader header;
+  if (journal.size() < sizeof(header)) {
+    throw FbossError("warm boot journal ", path, " is truncated");
+  }
+  memcpy(&header, journal.data(), sizeof(header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion) {
+    throw FbossError("unrecognized warm boot journal ", path);
+  }
+
+  folly::dynamic state = nullptr;
+  size_t numChanges = 0;
+  auto data = reinterpret_cast<const uint8_t*>(journal.data());
+  auto offset = sizeof(header);
+  while (offset + sizeof(RecordHeader) <= journal.size()) {
+    RecordHeader record;
+    memcpy(&record, data + offset, sizeof(record));
+    if (record.length == 0) {
+      // End of the journal
+      break;
+    }
+    auto payload = data + offset + sizeof(record);
+    if (offset + sizeof(record) + record.length > journal.size() ||
+        recordCrc(record.type, payload, record.length) != record.crc) {
+      // The agent stopped partway through writing this record
+      XLOG(WARN) << "Ignoring incomplete warm boot journal record at offset "
+                 << offset;
+      break;
+    }
+    auto json = folly::parseJson(folly::StringPiece(
+        reinterpret_cast<const char*>(payload), record.length));
+    switch (static_cast<RecordType>(record.type)) {
+      case RecordType::SNAPSHOT:
+        state = std::move(json);
+        break;
+      case RecordType::DELTA:
+        if (state.isNull()) {
+          throw FbossError("warm boot journal ", path, " has no snapshot");
+        }
+        applyChanges(state, json);
+        ++numChanges;
+        break;
+      case RecordType::VLAN_TABLES:
+        if (state.isNull()) {
+          throw FbossError("warm boot journal ", path, " has no snapshot");
+        }
+        applyVlanTableChanges(state, json);
+        ++numChanges;
+        break;
+      default:
+        throw FbossError(
+            "unknown record type ",
+            record.type,
+            " in warm boot journal ",
+            path);
+    }
+    offset += sizeof(record) + record.length;
+  }
+  if (state.isNull()) {
+    throw FbossError("warm boot journal ", path, " has no snapshot");
+  }
+
+  unkeyEntries(state[kPorts][kEntries]);
+  for (auto& vlan : state[kVlans][kEntries].items()) {
+    unkeyVlanTables(vlan.second);
+  }
+  unkeyEntries(state[kVlans][kEntries]);
+  auto& tables = state[kRouteTables][kEntries];
+  for (auto& table : tables.items()) {
+    unkeyEntries(table.second[kRibV4][kRoutes]);
+    unkeyEntries(table.second[kRibV6][kRoutes]);
+  }
+  unkeyEntries(tables);
+  XLOG(INFO) << "Replayed warm boot journal snapshot and " << numChanges
+             << " changes in "
+             << duration_cast<duration<float>>(steady_clock::now() - begin)
+                    .count();
+  return state;
+}
+
+} // namespace facebook::fboss
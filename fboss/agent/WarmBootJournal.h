@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/dynamic.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace facebook::fboss {
+
+class StateDelta;
+class SwitchState;
+
+/*
+ * Keeps the applied switch state on disk as it changes, so that graceful exit
+ * does not have to serialize the whole state, and restart time does not
+ * depend on the size of the tables.
+ *
+ * The journal is an append-only, memory mapped file holding a snapshot of the
+ * switch state followed by the changes applied since. Ports, VLANs and routes
+ * are journaled node by node, and the MAC, ARP and NDP tables of VLANs entry
+ * by entry in records of their own. Other parts of the state are journaled
+ * whole whenever they change. Once the changes outgrow the snapshot, the
+ * journal is compacted into a new snapshot on a thread of its own.
+ *
+ * Writes land in the page cache as they are appended. sync() makes them
+ * durable, and is all that's left to do at graceful exit. On warm boot,
+ * replay() rebuilds the switch state JSON from the snapshot and the changes
+ * that follow it.
+ *
+ * The journal only stands in for the switch state serialized at graceful
+ * exit. After a crash, the agent cold boots as before: the HwSwitch only
+ * stores its own warm boot state at graceful exit, so there is nothing to
+ * warm boot the hardware from, and the journal is ignored.
+ *
+ * WarmBootJournal is not thread safe, and must only be used from the thread
+ * applying state updates.
+ */
+class WarmBootJournal {
+ public:
+  explicit WarmBootJournal(const std::string& path);
+  ~WarmBootJournal();
+
+  /*
+   * Start the journal over from a snapshot of state.
+   */
+  void checkpoint(const std::shared_ptr<SwitchState>& state);
+
+  /*
+   * Journal the changes in delta. delta.oldState() must be the last state
+   * journaled. Throws an FbossError if nothing was checkpointed yet.
+   */
+  void append(const StateDelta& delta);
+
+  /*
+   * Flush the journal to disk. Waits for any compaction in progress to
+   * complete first.
+   */
+  void sync();
+
+  /*
+   * Bytes used by the snapshot and the changes following it.
+   */
+  size_t size() const;
+
+  /*
+   * The journal file in warmBootDir.
+   */
+  static std::string path(const std::string& warmBootDir);
+
+  /*
+   * Rebuild the switch state JSON from the journal at path, in the form
+   * SwitchState::fromFollyDynamic() expects. Throws FbossError if the
+   * journal is missing or corrupt.
+   */
+  static folly::dynamic replay(const std::string& path);
+
+ private:
+  enum class RecordType : uint8_t {
+    SNAPSHOT = 1,
+    DELTA = 2,
+    VLAN_TABLES = 3,
+  };
+
+  /*
+   * A journal file, mapped for appending records.
+   */
+  class File {
+   public:
+    File(const std::string& path, int fd) : path_(path), fd_(fd) {}
+    ~File();
+
+    void appendHeader();
+    void appendRecord(RecordType type, const std::string& payload);
+    void sync();
+    size_t size() const {
+      return tail_;
+    }
+
+   private:
+    // Forbidden copy constructor and assignment operator
+    File(File const&) = delete;
+    File& operator=(File const&) = delete;
+
+    void reserve(size_t bytes);
+    void unmap();
+
+    const std::string path_;
+    int fd_{-1};
+    uint8_t* base_{nullptr};
+    size_t capacity_{0};
+    size_t tail_{0};
+  };
+
+  // Forbidden copy constructor and assignment operator
+  WarmBootJournal(WarmBootJournal const&) = delete;
+  WarmBootJournal& operator=(WarmBootJournal const&) = delete;
+
+  /*
+   * Write a new journal with a snapshot of state next to the current one,
+   * and make it durable. It only replaces the current journal once
+   * installed.
+   */
+  std::unique_ptr<File> writeSnapshot(
+      const std::shared_ptr<SwitchState>& state) const;
+  void install(std::unique_ptr<File> file);
+  void appendRecord(RecordType type, std::string payload);
+  void finishCompaction();
+
+  const std::string path_;
+  std::unique_ptr<File> file_;
+  size_t snapshotSize_{0};
+
+  // Compactions snapshot the state on this executor, while the changes
+  // following that state keep being appended to the current journal, and
+  // are set aside for the new one.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> compactionExecutor_;
+  folly::SemiFuture<std::unique_ptr<File>> compaction_{
+      folly::SemiFuture<std::unique_ptr<File>>::makeEmpty()};
+  std::vector<std::pair<RecordType, std::string>> compactionRecords_;
+};
+
+} // namespace facebook::fboss
@@ -10,8 +10,10 @@
 
 #include "fboss/agent/hw/HwSwitchWarmBootHelper.h"
 
+#include "fboss/agent/Constants.h"
 #include "fboss/agent/SysError.h"
 #include "fboss/agent/Utils.h"
+#include "fboss/agent/WarmBootJournal.h"
 
 #include <folly/FileUtil.h>
 #include <folly/json.h>
@@ -22,6 +24,10 @@ DEFINE_string(
     switch_state_file,
     "switch_state",
     "File for dumping switch state JSON in on exit");
+DEFINE_uint32(
+    warm_boot_restore_threads,
+    4,
+    "Threads used to deserialize the switch state on warm boot");
 
 namespace {
 constexpr auto wbFlagPrefix = "can_warm_boot_";
@@ -144,7 +150,13 @@ folly::dynamic HwSwitchWarmBootHelper::getWarmBootState() const {
   auto ret = folly::readFile(warmBootSwitchStateFile().c_str(), warmBootJson);
   sysCheckError(
       ret, "Unable to read switch state from : ", warmBootSwitchStateFile());
-  return folly::parseJson(warmBootJson);
+  auto warmBootState = folly::parseJson(warmBootJson);
+  if (warmBootState.find(kSwSwitch) == warmBootState.items().end()) {
+    // The agent journaled its switch state rather than writing it on exit
+    warmBootState[kSwSwitch] =
+        WarmBootJournal::replay(WarmBootJournal::path(warmBootDir_));
+  }
+  return warmBootState;
 }
 
 void HwSwitchWarmBootHelper::setupWarmBootFile() {
@@ -41,6 +41,10 @@ class HwSwitchWarmBootHelper {
   void setCanWarmBoot();
 
   bool storeWarmBootState(const folly::dynamic& switchState);
+  /*
+   * Switch state stored on exit. If the agent journaled its switch state
+   * instead of storing it, it is replayed from the WarmBootJournal.
+   */
   folly::dynamic getWarmBootState() const;
 
   std::string startupSdkDumpFile() const;
@@ -680,6 +680,15 @@ std::optional<std::string> BcmAclEntry::getEgressAclMirror() {
                               : std::nullopt;
 }
 
+void BcmAclEntry::setPriority(const std::shared_ptr<AclEntry>& acl) {
+  CHECK(acl_->isSameExceptPriority(*acl))
+      << "Only the priority of ACL=" << acl->getID() << " may change in place";
+  auto rv = bcm_field_entry_prio_set(
+      hw_->getUnit(), handle_, swPriorityToHwPriority(acl->getPriority()));
+  bcmCheckError(rv, "failed to move acl=", acl->getID());
+  acl_ = acl;
+}
+
 void BcmAclEntry::applyMirrorAction(
     const std::string& mirrorName,
     MirrorAction action,
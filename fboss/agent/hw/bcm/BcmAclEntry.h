@@ -51,6 +51,13 @@ class BcmAclEntry {
       MirrorAction action,
       MirrorDirection direction);
 
+  /**
+   * Move the installed entry to the priority of the given acl, which must
+   * otherwise be identical to the one this entry was programmed with. The
+   * attached stat and mirror actions are left untouched.
+   */
+  void setPriority(const std::shared_ptr<AclEntry>& acl);
+
  private:
   void createNewAclEntry();
   void createAclQualifiers();
@@ -52,6 +52,27 @@ void BcmAclTable::processRemovedAcl(const std::shared_ptr<AclEntry>& acl) {
   }
 }
 
+std::unique_ptr<BcmAclEntry> BcmAclTable::detachAcl(
+    const std::shared_ptr<AclEntry>& acl) {
+  auto iter = aclEntryMap_.find(acl->getPriority());
+  if (iter == aclEntryMap_.end()) {
+    throw FbossError("Failed to detach non-existent acl=", acl->getID());
+  }
+  auto bcmAcl = std::move(iter->second);
+  aclEntryMap_.erase(iter);
+  return bcmAcl;
+}
+
+void BcmAclTable::reattachAcl(
+    std::unique_ptr<BcmAclEntry> bcmAcl,
+    const std::shared_ptr<AclEntry>& acl) {
+  if (aclEntryMap_.find(acl->getPriority()) != aclEntryMap_.end()) {
+    throw FbossError("ACL=", acl->getID(), " already exists");
+  }
+  bcmAcl->setPriority(acl);
+  aclEntryMap_.emplace(acl->getPriority(), std::move(bcmAcl));
+}
+
 BcmAclEntry* FOLLY_NULLABLE BcmAclTable::getAclIf(int priority) const {
   auto iter = aclEntryMap_.find(priority);
   if (iter == aclEntryMap_.end()) {
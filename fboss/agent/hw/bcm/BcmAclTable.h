@@ -33,6 +33,16 @@ class BcmAclTable {
   ~BcmAclTable() {}
   void processAddedAcl(const int groupId, const std::shared_ptr<AclEntry>& acl);
   void processRemovedAcl(const std::shared_ptr<AclEntry>& acl);
+  /*
+   * Moving an ACL to a new priority is done in two steps so that the rest of
+   * the delta can reuse the old priority in between: detachAcl() takes the
+   * entry out of the table without touching the hardware, and reattachAcl()
+   * moves it to the new priority in place, keeping its stat and counters.
+   */
+  std::unique_ptr<BcmAclEntry> detachAcl(const std::shared_ptr<AclEntry>& acl);
+  void reattachAcl(
+      std::unique_ptr<BcmAclEntry> bcmAcl,
+      const std::shared_ptr<AclEntry>& acl);
   void releaseAcls();
 
   // Throw exception if not found
@@ -261,6 +261,7 @@ BcmEgress::~BcmEgress() {
 BcmEcmpEgress::BcmEcmpEgress(const BcmSwitchIf* hw, const Paths& paths)
     : BcmEgressBase(hw), paths_(paths) {
   program();
+  hw_->writableEgressManager()->ecmpProgrammed(id_, paths_);
 }
 
 void BcmEcmpEgress::program() {
@@ -328,6 +329,7 @@ BcmEcmpEgress::~BcmEcmpEgress() {
   if (id_ == INVALID) {
     return;
   }
+  hw_->writableEgressManager()->ecmpRemoved(id_, paths_);
   bcm_l3_egress_ecmp_t obj;
   bcm_l3_egress_ecmp_t_init(&obj);
   obj.ecmp_intf = id_;
@@ -100,9 +100,67 @@ void BcmEgressManager::egressResolutionChangedHwNotLocked(
     const EgressIdSet& affectedEgressIds,
     bool up) {
   CHECK(!up);
-  EgressIdSet tmpEgressIds(affectedEgressIds);
-  bcm_l3_egress_ecmp_traverse(
-      unit, removeAllEgressesFromEcmpCallback, &tmpEgressIds);
+  if (warmBootEcmpsPending_) {
+    EgressIdSet tmpEgressIds(affectedEgressIds);
+    bcm_l3_egress_ecmp_traverse(
+        unit, removeAllEgressesFromEcmpCallback, &tmpEgressIds);
+    return;
+  }
+  // Look up the affected groups under the index lock, but shrink them
+  // without holding it.
+  std::vector<std::pair<bcm_if_t /* ecmp */, bcm_if_t /* egress */>> toRemove;
+  {
+    auto ecmpIndex = ecmpIndex_.rlock();
+    for (auto egressId : affectedEgressIds) {
+      auto itr = ecmpIndex->egress2EcmpIds.find(egressId);
+      if (itr == ecmpIndex->egress2EcmpIds.end()) {
+        continue;
+      }
+      for (auto ecmpId : itr->second) {
+        toRemove.emplace_back(ecmpId, egressId);
+      }
+    }
+  }
+  for (const auto& [ecmpId, egressId] : toRemove) {
+    BcmEcmpEgress::removeEgressIdHwNotLocked(unit, ecmpId, egressId);
+  }
+}
+
+void BcmEgressManager::ecmpProgrammed(bcm_if_t ecmpId, const Paths& paths) {
+  auto ecmpIndex = ecmpIndex_.wlock();
+  for (auto path : paths) {
+    ecmpIndex->egress2EcmpIds[path].insert(ecmpId);
+  }
+  ecmpIndex->ecmp2Paths[ecmpId] = paths;
+}
+
+void BcmEgressManager::ecmpRemoved(bcm_if_t ecmpId, const Paths& paths) {
+  auto ecmpIndex = ecmpIndex_.wlock();
+  for (auto path : paths) {
+    auto itr = ecmpIndex->egress2EcmpIds.find(path);
+    if (itr == ecmpIndex->egress2EcmpIds.end()) {
+      continue;
+    }
+    itr->second.erase(ecmpId);
+    if (itr->second.empty()) {
+      ecmpIndex->egress2EcmpIds.erase(itr);
+    }
+  }
+  ecmpIndex->ecmp2Paths.erase(ecmpId);
+}
+
+std::vector<std::pair<bcm_if_t, BcmEgressManager::Paths>>
+BcmEgressManager::getEcmpsWithEgress(bcm_if_t egressId) const {
+  std::vector<std::pair<bcm_if_t, Paths>> ecmps;
+  auto ecmpIndex = ecmpIndex_.rlock();
+  auto itr = ecmpIndex->egress2EcmpIds.find(egressId);
+  if (itr == ecmpIndex->egress2EcmpIds.end()) {
+    return ecmps;
+  }
+  for (auto ecmpId : itr->second) {
+    ecmps.emplace_back(ecmpId, ecmpIndex->ecmp2Paths.at(ecmpId));
+  }
+  return ecmps;
 }
 
 } // namespace facebook::fboss
@@ -11,7 +11,14 @@
 #include <boost/container/flat_map.hpp>
 #include <boost/container/flat_set.hpp>
 
+#include <folly/SharedMutex.h>
 #include <folly/SpinLock.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+#include <atomic>
+#include <utility>
+#include <vector>
 
 extern "C" {
 #include <bcm/l3.h>
@@ -23,6 +30,7 @@ namespace facebook::fboss {
 class BcmEgressManager {
  public:
   using EgressIdSet = BcmEcmpEgress::EgressIdSet;
+  using Paths = BcmEcmpEgress::Paths;
 
   explicit BcmEgressManager(const BcmSwitchIf* hw) : hw_(hw) {
     auto port2EgressIds = std::make_shared<PortAndEgressIdsMap>();
@@ -75,6 +83,27 @@ class BcmEgressManager {
     return portAndEgressIdsDontUseDirectly_;
   }
 
+  /*
+   * Keep track of the ECMP groups programmed by BcmEcmpEgress, so that the
+   * groups an egress belongs to can be found without walking all of them.
+   * The index has its own lock, so it can be used from the linkscan thread
+   * without holding the hw lock.
+   */
+  void ecmpProgrammed(bcm_if_t ecmpId, const Paths& paths);
+  void ecmpRemoved(bcm_if_t ecmpId, const Paths& paths);
+  /*
+   * ECMP groups containing egressId, along with their paths in SW
+   */
+  std::vector<std::pair<bcm_if_t, Paths>> getEcmpsWithEgress(
+      bcm_if_t egressId) const;
+  /*
+   * ECMP groups left over in the warm boot cache are not indexed. Until they
+   * are claimed or removed, port down handling walks all groups in HW.
+   */
+  void setWarmBootEcmpsPending(bool pending) {
+    warmBootEcmpsPending_ = pending;
+  }
+
   bool isResolved(const bcm_if_t egressId) const {
     return resolvedEgresses_.find(egressId) != resolvedEgresses_.end();
   }
@@ -90,7 +119,7 @@ class BcmEgressManager {
    * Called both while holding and not holding the hw lock.
    */
   void linkStateChangedMaybeLocked(bcm_port_t port, bool up, bool locked);
-  static void egressResolutionChangedHwNotLocked(
+  void egressResolutionChangedHwNotLocked(
       int unit,
       const EgressIdSet& affectedEgressIds,
       bool up);
@@ -119,6 +148,13 @@ class BcmEgressManager {
   std::shared_ptr<PortAndEgressIdsMap> portAndEgressIdsDontUseDirectly_;
   mutable folly::SpinLock portAndEgressIdsLock_;
   boost::container::flat_set<bcm_if_t> resolvedEgresses_;
+
+  struct EcmpIndex {
+    folly::F14FastMap<bcm_if_t /* egress */, EgressIdSet> egress2EcmpIds;
+    folly::F14FastMap<bcm_if_t /* ecmp */, Paths> ecmp2Paths;
+  };
+  folly::Synchronized<EcmpIndex, folly::SharedMutex> ecmpIndex_;
+  std::atomic<bool> warmBootEcmpsPending_{false};
 };
 
 } // namespace facebook::fboss
@@ -11,9 +11,10 @@
 #include "fboss/agent/hw/bcm/BcmFieldProcessorFBConvertors.h"
 
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/state/AclEntry.h"
 
 namespace {
-constexpr int kPrioMax = 1e6;
+constexpr int kPrioMax = facebook::fboss::AclEntryFields::kMaxPriority;
 // BCM uses both bcm_l4_port and uint16 to represent icmp type, code
 // Hence the templatized version to deal with different pointer types
 template <typename BCM_ICMP_TYPE>
@@ -2,6 +2,7 @@
 
 #include "fboss/agent/hw/bcm/BcmMultiPathNextHop.h"
 
+#include "fboss/agent/hw/bcm/BcmEgressManager.h"
 #include "fboss/agent/hw/bcm/BcmHost.h"
 #include "fboss/agent/hw/bcm/BcmIntf.h"
 #include "fboss/agent/hw/bcm/BcmNextHop.h"
@@ -82,20 +83,18 @@ void BcmMultiPathNextHopTable::egressResolutionChangedHwLocked(
     return;
   }
 
-  for (const auto& nextHopsAndEcmpHostInfo : getNextHops()) {
-    auto weakPtr = nextHopsAndEcmpHostInfo.second;
-    auto ecmpHost = weakPtr.lock();
-    auto ecmpEgress = ecmpHost->getEgress();
-    if (!ecmpEgress) {
-      continue;
-    }
-    for (auto egrId : affectedEgressIds) {
+  // Only visit the ECMP groups that contain an affected egress
+  auto* hw = getBcmSwitch();
+  for (auto egrId : affectedEgressIds) {
+    for (const auto& [ecmpId, paths] :
+         hw->getEgressManager()->getEcmpsWithEgress(egrId)) {
       switch (action) {
         case BcmEcmpEgress::Action::EXPAND:
-          ecmpEgress->pathReachableHwLocked(egrId);
+          BcmEcmpEgress::addEgressIdHwLocked(
+              hw->getUnit(), ecmpId, paths, egrId);
           break;
         case BcmEcmpEgress::Action::SHRINK:
-          ecmpEgress->pathUnreachableHwLocked(egrId);
+          BcmEcmpEgress::removeEgressIdHwLocked(hw->getUnit(), ecmpId, egrId);
           break;
         case BcmEcmpEgress::Action::SKIP:
           break;
@@ -114,7 +113,6 @@ void BcmMultiPathNextHopTable::egressResolutionChangedHwLocked(
    * in the warm boot cache
    */
 
-  auto* hw = getBcmSwitch();
   for (const auto& ecmpAndEgressIds :
        hw->getWarmBootCache()->ecmp2EgressIds()) {
     for (auto path : affectedEgressIds) {
@@ -16,6 +16,7 @@ extern "C" {
 #include <folly/IPAddress.h>
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
+#include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
 #include "fboss/agent/Constants.h"
 #include "fboss/agent/hw/bcm/BcmError.h"
@@ -29,6 +30,8 @@ extern "C" {
 
 #include "fboss/agent/state/RouteTypes.h"
 
+#include <cstring>
+
 namespace facebook::fboss {
 
 BcmRoute::BcmRoute(
@@ -268,34 +271,56 @@ BcmRoute::~BcmRoute() {
   }
 }
 
-bool BcmRouteTable::Key::operator<(const Key& k2) const {
-  if (vrf < k2.vrf) {
-    return true;
-  } else if (vrf > k2.vrf) {
-    return false;
-  }
-  if (mask < k2.mask) {
-    return true;
-  } else if (mask > k2.mask) {
-    return false;
-  }
-  return network < k2.network;
+size_t BcmRouteTable::KeyHash::operator()(const KeyV4& key) const {
+  return folly::hash::hash_combine(key.network, key.mask, key.vrf);
+}
+
+size_t BcmRouteTable::KeyHash::operator()(const KeyV6& key) const {
+  return folly::hash::hash_combine(
+      key.networkHi, key.networkLo, key.mask, key.vrf);
+}
+
+BcmRouteTable::KeyV4 BcmRouteTable::makeKey(
+    bcm_vrf_t vrf,
+    const folly::IPAddressV4& network,
+    uint8_t mask) {
+  return KeyV4{network.toLongHBO(), mask, vrf};
+}
+
+BcmRouteTable::KeyV6 BcmRouteTable::makeKey(
+    bcm_vrf_t vrf,
+    const folly::IPAddressV6& network,
+    uint8_t mask) {
+  const auto& bytes = network.toByteArray();
+  uint64_t networkHi;
+  uint64_t networkLo;
+  std::memcpy(&networkHi, bytes.data(), sizeof(networkHi));
+  std::memcpy(&networkLo, bytes.data() + sizeof(networkHi), sizeof(networkLo));
+  return KeyV6{networkHi, networkLo, mask, vrf};
 }
 
 BcmRouteTable::BcmRouteTable(BcmSwitch* hw) : hw_(hw) {}
 
 BcmRouteTable::~BcmRouteTable() {}
 
+template <typename KeyT>
+BcmRoute* BcmRouteTable::getBcmRouteIf(const KeyT& key) const {
+  const auto& fib = getFib(key);
+  auto iter = fib.find(key);
+  if (iter == fib.end()) {
+    return nullptr;
+  }
+  return iter->second.get();
+}
+
 BcmRoute* BcmRouteTable::getBcmRouteIf(
     bcm_vrf_t vrf,
     const folly::IPAddress& network,
     uint8_t mask) const {
-  Key key{network, mask, vrf};
-  auto iter = fib_.find(key);
-  if (iter == fib_.end()) {
-    return nullptr;
+  if (network.isV4()) {
+    return getBcmRouteIf(makeKey(vrf, network.asV4(), mask));
   }
-  return iter->second.get();
+  return getBcmRouteIf(makeKey(vrf, network.asV6(), mask));
 }
 
 BcmRoute* BcmRouteTable::getBcmRoute(
@@ -319,11 +344,12 @@ template <typename RouteT>
 void BcmRouteTable::addRoute(bcm_vrf_t vrf, const RouteT* route) {
   const auto& prefix = route->prefix();
 
-  Key key{folly::IPAddress(prefix.network), prefix.mask, vrf};
-  auto ret = fib_.emplace(key, nullptr);
+  auto key = makeKey(vrf, prefix.network, prefix.mask);
+  auto& fib = getFib(key);
+  auto ret = fib.emplace(key, nullptr);
   if (ret.second) {
     SCOPE_FAIL {
-      fib_.erase(ret.first);
+      fib.erase(ret.first);
     };
     ret.first->second.reset(new BcmRoute(
         hw_,
@@ -343,12 +369,13 @@ void BcmRouteTable::addRoute(bcm_vrf_t vrf, const RouteT* route) {
 template <typename RouteT>
 void BcmRouteTable::deleteRoute(bcm_vrf_t vrf, const RouteT* route) {
   const auto& prefix = route->prefix();
-  Key key{folly::IPAddress(prefix.network), prefix.mask, vrf};
-  auto iter = fib_.find(key);
-  if (iter == fib_.end()) {
+  auto key = makeKey(vrf, prefix.network, prefix.mask);
+  auto& fib = getFib(key);
+  auto iter = fib.find(key);
+  if (iter == fib.end()) {
     throw FbossError("Failed to delete a non-existing route ", route->str());
   }
-  fib_.erase(iter);
+  fib.erase(iter);
 }
 
 template void BcmRouteTable::addRoute(bcm_vrf_t, const RouteV4*);
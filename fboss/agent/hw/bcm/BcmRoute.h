@@ -20,7 +20,7 @@ extern "C" {
 #include "fboss/agent/state/RouteNextHopEntry.h"
 #include "fboss/agent/types.h"
 
-#include <boost/container/flat_map.hpp>
+#include <folly/container/F14Map.h>
 
 namespace facebook::fboss {
 
@@ -120,16 +120,60 @@ class BcmRouteTable {
   void deleteRoute(bcm_vrf_t vrf, const RouteT* route);
 
  private:
-  struct Key {
-    folly::IPAddress network;
+  /*
+   * Routes are kept in per address family hash maps keyed on the binary
+   * form of the prefix. Lookups are O(1) and adding or deleting a route does
+   * not shift a sorted vector of folly::IPAddress variants around, which adds
+   * up at 100k+ routes.
+   */
+  struct KeyV4 {
+    uint32_t network; // host byte order
+    uint8_t mask;
+    bcm_vrf_t vrf;
+    bool operator==(const KeyV4& k2) const {
+      return network == k2.network && mask == k2.mask && vrf == k2.vrf;
+    }
+  };
+  struct KeyV6 {
+    uint64_t networkHi;
+    uint64_t networkLo;
     uint8_t mask;
     bcm_vrf_t vrf;
-    bool operator<(const Key& k2) const;
+    bool operator==(const KeyV6& k2) const {
+      return networkHi == k2.networkHi && networkLo == k2.networkLo &&
+          mask == k2.mask && vrf == k2.vrf;
+    }
   };
+  struct KeyHash {
+    size_t operator()(const KeyV4& key) const;
+    size_t operator()(const KeyV6& key) const;
+  };
+  template <typename KeyT>
+  using RouteMap = folly::F14FastMap<KeyT, std::unique_ptr<BcmRoute>, KeyHash>;
+
+  static KeyV4
+  makeKey(bcm_vrf_t vrf, const folly::IPAddressV4& network, uint8_t mask);
+  static KeyV6
+  makeKey(bcm_vrf_t vrf, const folly::IPAddressV6& network, uint8_t mask);
+  RouteMap<KeyV4>& getFib(const KeyV4& /*key*/) {
+    return fibV4_;
+  }
+  RouteMap<KeyV6>& getFib(const KeyV6& /*key*/) {
+    return fibV6_;
+  }
+  const RouteMap<KeyV4>& getFib(const KeyV4& /*key*/) const {
+    return fibV4_;
+  }
+  const RouteMap<KeyV6>& getFib(const KeyV6& /*key*/) const {
+    return fibV6_;
+  }
+  template <typename KeyT>
+  BcmRoute* getBcmRouteIf(const KeyT& key) const;
 
   BcmSwitch* hw_;
 
-  boost::container::flat_map<Key, std::unique_ptr<BcmRoute>> fib_;
+  RouteMap<KeyV4> fibV4_;
+  RouteMap<KeyV6> fibV6_;
 };
 
 } // namespace facebook::fboss
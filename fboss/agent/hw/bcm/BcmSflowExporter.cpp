@@ -15,19 +15,68 @@
 
 #include <fcntl.h>
 #include <ifaddrs.h>
+#include <sys/socket.h>
 
+#include <fb303/ThreadCachedServiceData.h>
 #include <folly/Range.h>
+#include <folly/io/Cursor.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <optional>
 
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/packet/SflowStructs.h"
+
+DEFINE_int32(
+    sflow_export_queue_size,
+    16384,
+    "Number of sFlow samples that can be queued for export before new "
+    "samples are dropped");
+DEFINE_int32(
+    sflow_max_datagram_size,
+    1400,
+    "Maximum size in bytes of an exported sFlow datagram");
+DEFINE_bool(
+    sflow_export_v5,
+    false,
+    "Export samples as batched sFlow v5 datagrams. Otherwise each sample is "
+    "sent as a serialized SflowPacketInfo in its own datagram");
 
 using namespace std;
 
 namespace {
+constexpr auto kSflowSamples = "sflow.samples";
+constexpr auto kSflowSamplesDropped = "sflow.samples_dropped";
+constexpr auto kSflowDatagrams = "sflow.datagrams";
+constexpr auto kSflowDatagramsDropped = "sflow.datagrams_dropped";
+// Upper bound on the number of samples the exporter takes off the queue at
+// once, to bound the latency of the first sample in a burst
+constexpr size_t kMaxSamplesPerBatch = 256;
+constexpr auto kExportPollInterval = std::chrono::milliseconds(100);
+
+uint32_t xdrPadded(uint32_t size) {
+  auto blockSize = facebook::fboss::sflow::XDR_BASIC_BLOCK_SIZE;
+  return (size + blockSize - 1) / blockSize * blockSize;
+}
+
+/*
+ * Serialize one of the sFlow structs into a single, unchained buffer of at
+ * most maxSize bytes.
+ */
+template <typename T>
+std::unique_ptr<folly::IOBuf> serializeToBuf(const T& obj, uint32_t maxSize) {
+  auto buf = folly::IOBuf::create(maxSize);
+  buf->append(maxSize);
+  folly::io::RWPrivateCursor cursor(buf.get());
+  obj.serialize(&cursor);
+  buf->trimEnd(cursor.length());
+  return buf;
+}
+
 std::optional<folly::IPAddress> getLocalIPv6FromWhoAmI() {
   const std::string whoAmIFn = "/etc/fbwhoami";
   const std::string key = "DEVICE_PRIMARY_IPV6";
@@ -189,26 +238,75 @@ ssize_t BcmSflowExporter::sendUDPDatagram(iovec* vec, const size_t iovec_len) {
   return ret;
 }
 
+size_t BcmSflowExporter::sendUDPDatagrams(
+    const std::vector<std::unique_ptr<folly::IOBuf>>& datagrams) {
+  sockaddr_storage addrStorage;
+  address_.getAddress(&addrStorage);
+
+  std::vector<iovec> vecs(datagrams.size());
+  std::vector<mmsghdr> msgs(datagrams.size());
+  for (size_t i = 0; i < datagrams.size(); ++i) {
+    DCHECK(!datagrams[i]->isChained());
+    vecs[i].iov_base = const_cast<uint8_t*>(datagrams[i]->data());
+    vecs[i].iov_len = datagrams[i]->length();
+    auto& msg = msgs[i].msg_hdr;
+    msg = {};
+    msg.msg_name = reinterpret_cast<void*>(&addrStorage);
+    msg.msg_namelen = address_.getActualSize();
+    msg.msg_iov = &vecs[i];
+    msg.msg_iovlen = 1;
+  }
+
+  size_t sent = 0;
+  while (sent < msgs.size()) {
+    auto ret = ::sendmmsg(socket_, msgs.data() + sent, msgs.size() - sent, 0);
+    if (ret < 0) {
+      XLOG(DBG1) << "Failed sending " << msgs.size() - sent
+                 << " sFlow datagrams to " << address_.describe()
+                 << " reason: " << folly::errnoStr(errno);
+      break;
+    }
+    sent += ret;
+  }
+  XLOG(DBG4) << "Sent " << sent << " sFlow datagrams to "
+             << address_.describe();
+  return sent;
+}
+
 BcmSflowExporter::~BcmSflowExporter() {
   if (socket_ != -1) {
     close(socket_);
   }
 }
 
+BcmSflowExporterTable::BcmSflowExporterTable()
+    : startTime_(std::chrono::steady_clock::now()),
+      queue_(FLAGS_sflow_export_queue_size) {
+  exportThread_ = std::thread([this]() {
+    initThread("SflowExporter");
+    exportLoop();
+  });
+}
+
+BcmSflowExporterTable::~BcmSflowExporterTable() {
+  stop_ = true;
+  exportThread_.join();
+}
+
 bool BcmSflowExporterTable::contains(
     const shared_ptr<SflowCollector>& c) const {
-  auto iter = map_.find(c->getID());
-  return iter != map_.end();
+  auto map = map_.rlock();
+  return map->find(c->getID()) != map->end();
 }
 
 size_t BcmSflowExporterTable::size() const {
-  return map_.size();
+  return map_.rlock()->size();
 }
 
 void BcmSflowExporterTable::addExporter(const shared_ptr<SflowCollector>& c) {
   try {
     auto exporter = make_unique<BcmSflowExporter>(c->getAddress());
-    map_.emplace(c->getID(), move(exporter));
+    map_.wlock()->emplace(c->getID(), move(exporter));
   } catch (const fboss::thrift::FbossBaseError& ex) {
     XLOG(ERR) << "Could not add exporter: "
               << c->getAddress().getFullyQualified()
@@ -222,50 +320,175 @@ void BcmSflowExporterTable::addExporter(const shared_ptr<SflowCollector>& c) {
 
 void BcmSflowExporterTable::removeExporter(const std::string& id) {
   XLOG(INFO) << "Removed sFlow exporter " << id;
-  map_.erase(id);
+  map_.wlock()->erase(id);
 }
 
 void BcmSflowExporterTable::updateSamplingRates(
     PortID id,
     int64_t inRate,
     int64_t outRate) {
-  std::pair<int64_t, int64_t> rates(inRate, outRate);
-  auto it = port2samplingRates_.find(id);
-  if (it != port2samplingRates_.end()) {
-    it->second = rates;
-  } else {
-    port2samplingRates_.insert(std::make_pair(id, rates));
-  }
+  (*port2samplingRates_.wlock())[id] = std::make_pair(inRate, outRate);
 
   // We piggyback the update of local IPv6
-  localIP_ = getLocalIPv6();
+  auto localIP = getLocalIPv6();
+  *localIP_.wlock() = localIP;
 }
 
-void BcmSflowExporterTable::sendToAll(const SflowPacketInfo& info) {
-  if (map_.empty()) {
+void BcmSflowExporterTable::sendToAll(SflowPacketInfo info) {
+  if (!queue_.write(std::move(info))) {
+    XLOG_EVERY_MS(WARN, 1000) << "sFlow export queue full, dropping samples";
+    tcData().addStatValue(kSflowSamplesDropped, 1, fb303::RATE);
+  }
+}
+
+void BcmSflowExporterTable::exportLoop() {
+  std::vector<SflowPacketInfo> samples;
+  samples.reserve(kMaxSamplesPerBatch);
+  while (true) {
+    SflowPacketInfo info;
+    auto deadline = std::chrono::steady_clock::now() + kExportPollInterval;
+    if (!queue_.tryReadUntil(deadline, info)) {
+      if (stop_) {
+        return;
+      }
+      continue;
+    }
+    samples.push_back(std::move(info));
+    while (samples.size() < kMaxSamplesPerBatch && queue_.read(info)) {
+      samples.push_back(std::move(info));
+    }
+    try {
+      exportSamples(samples);
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Failed to export " << samples.size()
+                << " sFlow samples: " << folly::exceptionStr(ex);
+    }
+    samples.clear();
+  }
+}
+
+void BcmSflowExporterTable::exportSamples(
+    const std::vector<SflowPacketInfo>& samples) {
+  tcData().addStatValue(kSflowSamples, samples.size(), fb303::RATE);
+  auto map = map_.rlock();
+  if (map->empty()) {
     XLOG(DBG1)
         << "zero sFlow collectors with sflow enabled, skipping sample export";
     return;
   }
-  // Serialize info to a string and wrap it in an IOBuf for sending
-  string output;
-  apache::thrift::BinarySerializer::serialize(info, &output);
-  auto buf = folly::IOBuf::wrapBuffer(output.data(), output.length());
-
-  // Map the IOBuf to a Linux iovec like a champ
-  iovec vec[16] = {};
-  size_t iovec_len = buf->fillIov(vec, sizeof(vec) / sizeof(vec[0])).numIovecs;
-  if (UNLIKELY(iovec_len == 0)) {
-    buf->coalesce();
-    vec[0].iov_base = const_cast<uint8_t*>(buf->data());
-    vec[0].iov_len = buf->length();
-    iovec_len = 1;
+
+  auto datagrams = buildDatagrams(samples);
+  for (const auto& c : *map) {
+    auto sent = c.second->sendUDPDatagrams(datagrams);
+    tcData().addStatValue(kSflowDatagrams, sent, fb303::RATE);
+    if (sent < datagrams.size()) {
+      tcData().addStatValue(
+          kSflowDatagramsDropped, datagrams.size() - sent, fb303::RATE);
+    }
+  }
+}
+
+std::vector<std::unique_ptr<folly::IOBuf>>
+BcmSflowExporterTable::buildDatagrams(
+    const std::vector<SflowPacketInfo>& samples) {
+  std::vector<std::unique_ptr<folly::IOBuf>> datagrams;
+  if (!FLAGS_sflow_export_v5) {
+    for (const auto& info : samples) {
+      string output;
+      apache::thrift::BinarySerializer::serialize(info, &output);
+      datagrams.push_back(folly::IOBuf::copyBuffer(output));
+    }
+    return datagrams;
   }
 
-  for (const auto& c : map_) {
-    // TODO: prob need to handle ret code?
-    c.second->sendUDPDatagram(vec, iovec_len);
+  auto agentAddress = localIP_.copy();
+  if (agentAddress.empty()) {
+    // No sampling rate was programmed yet, which is when we look it up
+    agentAddress = getLocalIPv6();
+    *localIP_.wlock() = agentAddress;
+  }
+  auto rates = port2samplingRates_.copy();
+  auto uptime = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - startTime_)
+                    .count();
+  // version + agent address type and bytes + sub agent id + sequence number
+  // + uptime + sample count
+  const uint32_t datagramHeaderSize = 4 + sflow::sizeIP(agentAddress) + 16;
+
+  std::vector<std::unique_ptr<folly::IOBuf>> sampleBufs;
+  uint32_t datagramSize = datagramHeaderSize;
+  auto flush = [&]() {
+    if (sampleBufs.empty()) {
+      return;
+    }
+    std::vector<sflow::SampleRecord> records(sampleBufs.size());
+    for (size_t i = 0; i < sampleBufs.size(); ++i) {
+      records[i].sampleType = 1; // flow sample
+      records[i].sampleDataLen = sampleBufs[i]->length();
+      records[i].sampleData = sampleBufs[i]->writableData();
+    }
+    sflow::SampleDatagram datagram;
+    datagram.datagramV5.agentAddress = agentAddress;
+    datagram.datagramV5.subAgentID = 0;
+    datagram.datagramV5.sequenceNumber = datagramSequence_++;
+    datagram.datagramV5.uptime = uptime;
+    datagram.datagramV5.samplesCnt = records.size();
+    datagram.datagramV5.samples = records.data();
+    datagrams.push_back(serializeToBuf(datagram, datagramSize));
+    sampleBufs.clear();
+    datagramSize = datagramHeaderSize;
+  };
+
+  for (const auto& info : samples) {
+    sflow::SampledHeader header;
+    header.protocol = sflow::HeaderProtocol::ETHERNET_ISO88023;
+    header.frameLength = info.packetData.size();
+    header.stripped = 0;
+    header.headerLength = info.packetData.size();
+    header.header =
+        reinterpret_cast<const sflow::byte*>(info.packetData.data());
+    auto headerBuf = serializeToBuf(header, xdrPadded(header.size()));
+
+    sflow::FlowRecord record;
+    record.flowFormat = 1; // sampled header
+    record.flowDataLen = headerBuf->length();
+    record.flowData = headerBuf->writableData();
+
+    // Ports are carried as int16 in SflowPacketInfo
+    auto srcPort = static_cast<uint16_t>(info.srcPort);
+    auto dstPort = static_cast<uint16_t>(info.dstPort);
+    int64_t samplingRate = 0;
+    auto rate = rates.find(PortID(srcPort));
+    if (rate != rates.end()) {
+      samplingRate = info.ingressSampled ? rate->second.first
+                                         : rate->second.second;
+    }
+    sflow::FlowSample sample;
+    sample.sequenceNumber = sampleSequence_++;
+    sample.sourceID = sflow::makeSflowDataSource(
+        sflow::DataSourceType::IF_INDEX,
+        info.ingressSampled ? srcPort : dstPort);
+    sample.samplingRate = samplingRate;
+    sample.samplePool = 0;
+    sample.drops = 0;
+    sample.input = srcPort;
+    sample.output = dstPort;
+    sample.flowRecordsCnt = 1;
+    sample.flowRecords = &record;
+    auto sampleBuf =
+        serializeToBuf(sample, sample.size(xdrPadded(record.size())));
+
+    // sample type + sample length + sample data
+    auto recordSize = 8 + xdrPadded(sampleBuf->length());
+    if (datagramSize + recordSize >
+        static_cast<uint32_t>(FLAGS_sflow_max_datagram_size)) {
+      flush();
+    }
+    sampleBufs.push_back(std::move(sampleBuf));
+    datagramSize += recordSize;
   }
+  flush();
+  return datagrams;
 }
 
 } // namespace facebook::fboss
@@ -9,10 +9,18 @@
  */
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <folly/IPAddress.h>
+#include <folly/MPMCQueue.h>
 #include <folly/SocketAddress.h>
+#include <folly/Synchronized.h>
+#include <folly/io/IOBuf.h>
+#include <gtest/gtest_prod.h>
 
 #include "fboss/agent/if/gen-cpp2/sflow_types.h"
 #include "fboss/agent/state/SflowCollector.h"
@@ -35,6 +43,13 @@ class BcmSflowExporter {
    */
   ssize_t sendUDPDatagram(iovec* vec, const size_t iovec_len);
 
+  /*
+   * Send out a batch of datagrams with a single sendmmsg() call where
+   * possible. Returns the number of datagrams that were sent.
+   */
+  size_t sendUDPDatagrams(
+      const std::vector<std::unique_ptr<folly::IOBuf>>& datagrams);
+
  private:
   // no copy or assignment
   BcmSflowExporter(BcmSflowExporter const&) = delete;
@@ -44,10 +59,17 @@ class BcmSflowExporter {
   int socket_{-1};
 };
 
+/*
+ * Samples are handed over from the RX callback through a bounded lock-free
+ * queue and exported from a dedicated thread, so that collectors never slow
+ * down control plane packet handling. The exporter thread packs as many
+ * samples as fit into each sFlow v5 datagram and sends the datagrams to every
+ * collector with sendmmsg().
+ */
 class BcmSflowExporterTable {
  public:
-  BcmSflowExporterTable() = default;
-  ~BcmSflowExporterTable() = default;
+  BcmSflowExporterTable();
+  ~BcmSflowExporterTable();
 
   bool contains(const std::shared_ptr<SflowCollector>& collector) const;
   size_t size() const;
@@ -56,19 +78,44 @@ class BcmSflowExporterTable {
 
   void updateSamplingRates(PortID id, int64_t inRate, int64_t outRate);
 
-  void sendToAll(const SflowPacketInfo& info);
+  /*
+   * Queue a sample for export. Safe to call from the RX thread, never
+   * blocks: the sample is dropped if the exporter thread can't keep up.
+   */
+  void sendToAll(SflowPacketInfo info);
 
  private:
   // no copy or assignment
   BcmSflowExporterTable(BcmSflowExporterTable const&) = delete;
   BcmSflowExporterTable& operator=(BcmSflowExporterTable const&) = delete;
 
-  std::unordered_map<std::string, std::unique_ptr<BcmSflowExporter>> map_;
-  std::unordered_map<
+  using ExporterMap =
+      std::unordered_map<std::string, std::unique_ptr<BcmSflowExporter>>;
+  using SamplingRates = std::unordered_map<
       PortID,
-      std::pair<int64_t /* ingress rate */, int64_t /* egress rate */>>
-      port2samplingRates_;
-  folly::IPAddress localIP_;
+      std::pair<int64_t /* ingress rate */, int64_t /* egress rate */>>;
+
+  FRIEND_TEST(BcmSflowExporterTest, buildDatagramsV5);
+  FRIEND_TEST(BcmSflowExporterTest, buildDatagramsSplitAtMaxSize);
+  FRIEND_TEST(BcmSflowExporterTest, buildDatagramsWithoutAgentAddress);
+
+  void exportLoop();
+  void exportSamples(const std::vector<SflowPacketInfo>& samples);
+  std::vector<std::unique_ptr<folly::IOBuf>> buildDatagrams(
+      const std::vector<SflowPacketInfo>& samples);
+
+  folly::Synchronized<ExporterMap> map_;
+  folly::Synchronized<SamplingRates> port2samplingRates_;
+  folly::Synchronized<folly::IPAddress> localIP_;
+
+  // Only touched by the exporter thread
+  uint32_t datagramSequence_{0};
+  uint32_t sampleSequence_{0};
+  const std::chrono::steady_clock::time_point startTime_;
+
+  folly::MPMCQueue<SflowPacketInfo> queue_;
+  std::atomic<bool> stop_{false};
+  std::thread exportThread_;
 };
 
 } // namespace facebook::fboss
@@ -44,6 +44,11 @@ BcmStats::BcmStats(ThreadLocalStatsMap* map)
           SwitchStats::kCounterPrefix + "bcm.tx.pkt.allocation.errors",
           SUM,
           RATE),
+      txPktPoolEmpty_(
+          map,
+          SwitchStats::kCounterPrefix + "bcm.tx.pkt.pool.empty",
+          SUM,
+          RATE),
       txQueued_(
           map,
           SwitchStats::kCounterPrefix + "bcm.tx.pkt.queued_us",
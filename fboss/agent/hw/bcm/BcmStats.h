@@ -52,6 +52,9 @@ class BcmStats {
     txErrors_.addValue(1);
     txPktAllocErrors_.addValue(1);
   }
+  void txPktPoolEmpty() {
+    txPktPoolEmpty_.addValue(1);
+  }
 
   void corrParityError() {
     parityErrors_.addValue(1);
@@ -90,6 +93,8 @@ class BcmStats {
   // Errors in sending packets
   TLTimeseries txErrors_;
   TLTimeseries txPktAllocErrors_;
+  // Tx packets allocated one by one since all pooled buffers were in use
+  TLTimeseries txPktPoolEmpty_;
 
   // Time spent for each Tx packet queued in HW
   TLHistogram txQueued_;
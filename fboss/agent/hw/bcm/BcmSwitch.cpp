@@ -14,6 +14,8 @@
 #include <fstream>
 #include <map>
 #include <optional>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include <folly/Conv.h>
@@ -68,6 +70,7 @@
 #include "fboss/agent/hw/bcm/BcmTrunk.h"
 #include "fboss/agent/hw/bcm/BcmTrunkTable.h"
 #include "fboss/agent/hw/bcm/BcmTxPacket.h"
+#include "fboss/agent/hw/bcm/BcmTxPacketPool.h"
 #include "fboss/agent/hw/bcm/BcmUnit.h"
 #include "fboss/agent/hw/bcm/BcmWarmBootCache.h"
 #include "fboss/agent/hw/bcm/BcmWarmBootHelper.h"
@@ -195,6 +198,11 @@ DEFINE_int32(
 // Put lowest priority for this group among all i.e. lower than acl_g_pri,
 // ll_mcast_g_pri,
 DEFINE_int32(qcm_ifp_pri, -1, "Group priority for ACL field group");
+DEFINE_int32(
+    tx_pkt_pool_size,
+    256,
+    "Number of DMA buffers kept around for packets sent from the CPU. "
+    "0 allocates a buffer for every packet");
 
 enum : uint8_t {
   kRxCallbackPriority = 1,
@@ -421,6 +429,10 @@ BcmSwitch::~BcmSwitch() {
 void BcmSwitch::resetTables() {
   std::unique_lock<std::mutex> lk(lock_);
   unregisterCallbacks();
+  if (txPacketPool_) {
+    // Free pooled buffers while the unit is still around
+    txPacketPool_->stop();
+  }
   routeTable_.reset();
   labelMap_.reset();
   l3NextHopTable_.reset();
@@ -509,6 +521,9 @@ void BcmSwitch::gracefulExit(folly::dynamic& switchState) {
 
   switchState[kHwSwitch] = toFollyDynamic();
   unitObject_->writeWarmBootState(switchState);
+  if (txPacketPool_) {
+    txPacketPool_->stop();
+  }
   unitObject_.reset();
   XLOG(INFO)
       << "[Exit] BRCM Graceful Exit time "
@@ -808,6 +823,9 @@ HwInitResult BcmSwitch::init(Callback* callback) {
   BcmSwitchEventUtils::registerSwitchEventCallback(
       unit_, BCM_SWITCH_EVENT_PARITY_ERROR, nonFatalCob);
 
+  txPacketPool_ = std::make_shared<BcmTxPacketPool>(
+      unit_, std::max(FLAGS_tx_pkt_pool_size, 0));
+
   // Create bcmStatUpdater to cache the stat ids
   bcmStatUpdater_ = std::make_unique<BcmStatUpdater>(this, isAlpmEnabled());
 
@@ -882,6 +900,7 @@ HwInitResult BcmSwitch::init(Callback* callback) {
     // This needs to be done after we have set
     // bcmSwitchL3EgressMode else the egress ids
     // in the host table don't show up correctly.
+    egressManager_->setWarmBootEcmpsPending(true);
     warmBootCache_->populate();
   }
   setupToCpuEgress();
@@ -912,6 +931,8 @@ HwInitResult BcmSwitch::init(Callback* callback) {
     ret.switchState = warmBootState;
     // Done with warm boot, clear warm boot cache
     warmBootCache_->clear();
+    // Every ECMP group left in HW is now owned by a BcmEcmpEgress
+    egressManager_->setWarmBootEcmpsPending(false);
     if (getPlatform()->getAsic()->getAsicType() ==
         HwAsic::AsicType::ASIC_TYPE_TRIDENT2) {
       for (auto ip : {folly::IPAddress("0.0.0.0"), folly::IPAddress("::")}) {
@@ -1192,6 +1213,11 @@ unique_ptr<TxPacket> BcmSwitch::allocatePacket(uint32_t size) const {
   // that supports multiple units.  Fortunately, the linux userspace
   // implemetation uses the same DMA pool for all local units, so it wouldn't
   // really matter which unit we specified when allocating the buffer.
+  if (txPacketPool_) {
+    if (auto pkt = txPacketPool_->allocate(size)) {
+      return pkt;
+    }
+  }
   return make_unique<BcmTxPacket>(unit_, size);
 }
 
@@ -1785,12 +1811,77 @@ void BcmSwitch::processQosChanges(const StateDelta& delta) {
 }
 
 void BcmSwitch::processAclChanges(const StateDelta& delta) {
+  /*
+   * The ACL delta is keyed by priority, so an ACL whose priority was the only
+   * thing that changed shows up as removed at its old priority and added at
+   * its new one. Move such ACLs in place rather than destroying and
+   * recreating them, which would churn the TCAM and reset their counters.
+   */
+  const auto aclsDelta = delta.getAclsDelta();
+  std::unordered_map<std::string, shared_ptr<AclEntry>> oldAcls;
+  std::unordered_map<std::string, shared_ptr<AclEntry>> newAcls;
   forEachChanged(
-      delta.getAclsDelta(),
-      &BcmSwitch::processChangedAcl,
-      &BcmSwitch::processAddedAcl,
-      &BcmSwitch::processRemovedAcl,
-      this);
+      aclsDelta,
+      [&](const shared_ptr<AclEntry>& oldAcl,
+          const shared_ptr<AclEntry>& newAcl) {
+        oldAcls.emplace(oldAcl->getID(), oldAcl);
+        newAcls.emplace(newAcl->getID(), newAcl);
+      },
+      [&](const shared_ptr<AclEntry>& newAcl) {
+        newAcls.emplace(newAcl->getID(), newAcl);
+      },
+      [&](const shared_ptr<AclEntry>& oldAcl) {
+        oldAcls.emplace(oldAcl->getID(), oldAcl);
+      });
+
+  std::vector<std::pair<unique_ptr<BcmAclEntry>, shared_ptr<AclEntry>>>
+      movedAcls;
+  std::unordered_set<const AclEntry*> moved;
+  for (const auto& [name, oldAcl] : oldAcls) {
+    auto newAcl = newAcls.find(name);
+    if (newAcl == newAcls.end() ||
+        !oldAcl->isSameExceptPriority(*newAcl->second)) {
+      continue;
+    }
+    moved.insert(oldAcl.get());
+    moved.insert(newAcl->second.get());
+    movedAcls.emplace_back(aclTable_->detachAcl(oldAcl), newAcl->second);
+  }
+
+  auto isMoved = [&moved](const shared_ptr<AclEntry>& acl) {
+    return moved.find(acl.get()) != moved.end();
+  };
+  forEachChanged(
+      aclsDelta,
+      [&](const shared_ptr<AclEntry>& oldAcl,
+          const shared_ptr<AclEntry>& newAcl) {
+        if (!isMoved(oldAcl) && !isMoved(newAcl)) {
+          processChangedAcl(oldAcl, newAcl);
+          return;
+        }
+        if (!isMoved(oldAcl)) {
+          processRemovedAcl(oldAcl);
+        }
+        if (!isMoved(newAcl)) {
+          processAddedAcl(newAcl);
+        }
+      },
+      [&](const shared_ptr<AclEntry>& newAcl) {
+        if (!isMoved(newAcl)) {
+          processAddedAcl(newAcl);
+        }
+      },
+      [&](const shared_ptr<AclEntry>& oldAcl) {
+        if (!isMoved(oldAcl)) {
+          processRemovedAcl(oldAcl);
+        }
+      });
+
+  for (auto& [bcmAcl, acl] : movedAcls) {
+    XLOG(DBG3) << "Moving ACL=" << acl->getID()
+               << " to priority=" << acl->getPriority();
+    aclTable_->reattachAcl(std::move(bcmAcl), acl);
+  }
 }
 
 void BcmSwitch::processAggregatePortChanges(const StateDelta& delta) {
@@ -2897,7 +2988,7 @@ bool BcmSwitch::handleSflowPacket(bcm_pkt_t* pkt) noexcept {
              << info.egressSampled << ',' << info.srcPort << ',' << info.dstPort
              << ',' << info.vlan << ',' << info.packetData.length() << ")\n";
 
-  sFlowExporterTable_->sendToAll(info);
+  sFlowExporterTable_->sendToAll(std::move(info));
 
   // If it is only here because of sFlow, we're done
   if ((pkt->rx_reason ^ bcmRxReasonSampleSource ^ bcmRxReasonSampleDest) == 0) {
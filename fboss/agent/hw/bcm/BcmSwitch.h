@@ -60,6 +60,7 @@ class BcmRxPacket;
 class BcmStatUpdater;
 class BcmSwitchEventCallback;
 class BcmTrunkTable;
+class BcmTxPacketPool;
 class BcmUnit;
 class BcmWarmBootCache;
 class BcmWarmBootHelper;
@@ -905,6 +906,8 @@ class BcmSwitch : public BcmSwitchIf {
   BootType bootType_{BootType::UNINITIALIZED};
   int64_t bstStatsUpdateTime_{0};
   std::unique_ptr<BcmQcmManager> qcmManager_;
+  // Shared with the packets using its buffers, which may outlive us
+  std::shared_ptr<BcmTxPacketPool> txPacketPool_;
 
   /*
    * Lock to synchronize access to all BCM* data structures
@@ -76,6 +76,17 @@ BcmTxPacket::BcmTxPacket(int unit, uint32_t size)
   }
 }
 
+BcmTxPacket::BcmTxPacket(
+    bcm_pkt_t* pkt,
+    uint32_t size,
+    IOBuf::FreeFunction freeFn,
+    void* userData)
+    : pkt_(pkt),
+      queued_(std::chrono::time_point<std::chrono::steady_clock>::min()) {
+  buf_ = IOBuf::takeOwnership(pkt_->pkt_data->data, size, freeFn, userData);
+  BcmStats::get()->txPktAlloc();
+}
+
 inline int BcmTxPacket::sendImpl(unique_ptr<BcmTxPacket> pkt) noexcept {
   bcm_pkt_t* bcmPkt = pkt->pkt_;
   const auto buf = pkt->buf();
@@ -25,6 +25,15 @@ namespace facebook::fboss {
 class BcmTxPacket : public TxPacket {
  public:
   BcmTxPacket(int unit, uint32_t size);
+  /*
+   * Wrap a packet allocated elsewhere, e.g. by BcmTxPacketPool. freeFn is
+   * called with userData in place of bcm_pkt_free() once the packet is done.
+   */
+  BcmTxPacket(
+      bcm_pkt_t* pkt,
+      uint32_t size,
+      folly::IOBuf::FreeFunction freeFn,
+      void* userData);
 
   bcm_pkt_t* getPkt() {
     return pkt_;
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/bcm/BcmTxPacketPool.h"
+
+#include "fboss/agent/hw/bcm/BcmError.h"
+#include "fboss/agent/hw/bcm/BcmStats.h"
+#include "fboss/agent/hw/bcm/BcmTxPacket.h"
+
+namespace facebook::fboss {
+
+BcmTxPacketPool::BcmTxPacketPool(int unit, uint32_t numBufs) : unit_(unit) {
+  auto free = free_.lock();
+  bufs_.reserve(numBufs);
+  free->bufs.reserve(numBufs);
+  for (uint32_t i = 0; i < numBufs; ++i) {
+    auto buf = std::make_unique<Buf>();
+    int rv = bcm_pkt_alloc(
+        unit, kBufSize, BCM_TX_CRC_APPEND | BCM_TX_ETHER, &buf->pkt);
+    if (BCM_FAILURE(rv)) {
+      // Make do with what we have, packets can still be allocated one by one
+      bcmLogError(rv, "Failed to allocate pooled tx packet");
+      BcmStats::get()->txPktAllocErrors();
+      break;
+    }
+    buf->initial = *buf->pkt;
+    buf->data = buf->pkt->pkt_data->data;
+    free->bufs.push_back(buf.get());
+    bufs_.push_back(std::move(buf));
+  }
+}
+
+BcmTxPacketPool::~BcmTxPacketPool() {
+  stop();
+}
+
+std::unique_ptr<BcmTxPacket> BcmTxPacketPool::allocate(uint32_t size) {
+  if (size > kBufSize) {
+    return nullptr;
+  }
+  Buf* buf{nullptr};
+  {
+    auto free = free_.lock();
+    if (free->stopped) {
+      return nullptr;
+    }
+    if (!free->bufs.empty()) {
+      buf = free->bufs.back();
+      free->bufs.pop_back();
+    }
+  }
+  if (!buf) {
+    BcmStats::get()->txPktPoolEmpty();
+    return nullptr;
+  }
+  // Undo whatever the previous sender changed (tx ports, cos, flags, ...)
+  *buf->pkt = buf->initial;
+  buf->pkt->pkt_data->data = buf->data;
+  buf->pkt->pkt_data->len = kBufSize;
+  buf->pool = shared_from_this();
+  return std::make_unique<BcmTxPacket>(buf->pkt, size, freeBuf, buf);
+}
+
+void BcmTxPacketPool::stop() {
+  std::vector<Buf*> bufs;
+  {
+    auto free = free_.lock();
+    free->stopped = true;
+    bufs.swap(free->bufs);
+  }
+  for (auto buf : bufs) {
+    freePkt(buf);
+  }
+}
+
+void BcmTxPacketPool::freeBuf(void* /*ptr*/, void* arg) {
+  auto buf = static_cast<Buf*>(arg);
+  // May drop the last reference to the pool, so buf can't be used after
+  auto pool = std::move(buf->pool);
+  pool->release(buf);
+  BcmStats::get()->txPktFree();
+}
+
+void BcmTxPacketPool::release(Buf* buf) {
+  {
+    auto free = free_.lock();
+    if (!free->stopped) {
+      free->bufs.push_back(buf);
+      return;
+    }
+  }
+  freePkt(buf);
+}
+
+void BcmTxPacketPool::freePkt(Buf* buf) {
+  int rv = bcm_pkt_free(unit_, buf->pkt);
+  bcmLogError(rv, "Failed to free pooled tx packet");
+  buf->pkt = nullptr;
+}
+
+} // namespace facebook::fboss
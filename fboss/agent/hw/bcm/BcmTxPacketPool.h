@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/SpinLock.h>
+#include <folly/Synchronized.h>
+
+#include <memory>
+#include <vector>
+
+extern "C" {
+#include <bcm/pkt.h>
+}
+
+namespace facebook::fboss {
+
+class BcmTxPacket;
+
+/*
+ * A pool of DMA packet buffers allocated up front, so that the periodic
+ * control plane packets sent from the CPU (LACP, LLDP, ARP, NDP, ...) don't
+ * go through bcm_pkt_alloc() and bcm_pkt_free() on every send.
+ *
+ * Buffers return to the pool when the BcmTxPacket using them is freed. Packets
+ * larger than kBufSize, or allocated while all pooled buffers are in use, are
+ * left to the caller to allocate. The pool stays alive until the last of its
+ * buffers is returned, and may be shared by any number of threads.
+ */
+class BcmTxPacketPool : public std::enable_shared_from_this<BcmTxPacketPool> {
+ public:
+  // Large enough for all the control plane packets we send periodically
+  static constexpr uint32_t kBufSize = 512;
+
+  BcmTxPacketPool(int unit, uint32_t numBufs);
+  ~BcmTxPacketPool();
+
+  /*
+   * Returns a packet backed by a pooled buffer, or nullptr if size is too
+   * large, no buffer is free or the pool was stopped.
+   */
+  std::unique_ptr<BcmTxPacket> allocate(uint32_t size);
+
+  /*
+   * Free all buffers in the pool, and free buffers still in use once they
+   * are returned rather than pooling them again. This must be called before
+   * the unit is detached.
+   */
+  void stop();
+
+  size_t numFree() const {
+    return free_.lock()->size();
+  }
+
+ private:
+  struct Buf {
+    bcm_pkt_t* pkt{nullptr};
+    // The packet as bcm_pkt_alloc() left it, restored before every reuse
+    bcm_pkt_t initial;
+    uint8_t* data{nullptr};
+    // Keeps the pool alive while the buffer is in use
+    std::shared_ptr<BcmTxPacketPool> pool;
+  };
+  struct FreeList {
+    std::vector<Buf*> bufs;
+    bool stopped{false};
+
+    size_t size() const {
+      return bufs.size();
+    }
+  };
+
+  // Forbidden copy constructor and assignment operator
+  BcmTxPacketPool(BcmTxPacketPool const&) = delete;
+  BcmTxPacketPool& operator=(BcmTxPacketPool const&) = delete;
+
+  static void freeBuf(void* ptr, void* arg);
+  void release(Buf* buf);
+  void freePkt(Buf* buf);
+
+  const int unit_;
+  std::vector<std::unique_ptr<Buf>> bufs_;
+  folly::Synchronized<FreeList, folly::SpinLock> free_;
+};
+
+} // namespace facebook::fboss
@@ -16,11 +16,13 @@
 
 #include <folly/Conv.h>
 #include <folly/dynamic.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/json.h>
 #include <folly/logging/xlog.h>
 
 #include "fboss/agent/Constants.h"
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/RestartTimeTracker.h"
 #include "fboss/agent/SysError.h"
 #include "fboss/agent/hw/bcm/BcmAclEntry.h"
 #include "fboss/agent/hw/bcm/BcmAclTable.h"
@@ -78,6 +80,8 @@ using std::string;
 using std::vector;
 using namespace facebook::fboss;
 
+DECLARE_uint32(warm_boot_restore_threads);
+
 namespace {
 auto constexpr kEcmpObjects = "ecmpObjects";
 auto constexpr kTrunks = "trunks";
@@ -185,12 +189,14 @@ folly::dynamic BcmWarmBootCache::getWarmBootState() const {
 }
 
 void BcmWarmBootCache::populateFromWarmBootState(
-    const folly::dynamic& warmBootState) {
-  dumpedSwSwitchState_ =
-      SwitchState::uniquePtrFromFollyDynamic(warmBootState[kSwSwitch]);
-  dumpedSwSwitchState_->publish();
-  CHECK(dumpedSwSwitchState_)
-      << "Was not able to recover software state after warmboot";
+    folly::dynamic warmBootState) {
+  // Rebuild the switch state while we traverse the hardware tables, none of
+  // which needs it
+  restoreExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+      std::max(FLAGS_warm_boot_restore_threads, 1u),
+      std::make_shared<folly::NamedThreadFactory>("WarmBootRestore"));
+  restoredSwSwitchState_ = SwitchState::restoreFromFollyDynamic(
+      std::move(warmBootState[kSwSwitch]), restoreExecutor_.get());
 
   // Extract ecmps for dumped host table
   auto& hostTable = warmBootState[kHwSwitch][kHostTable];
@@ -379,9 +385,21 @@ BcmWarmBootCache::findEgressFromLabeledHostKey(const BcmLabeledHostKey& key) {
       : findEgress(iter->second);
 }
 
+const SwitchState& BcmWarmBootCache::getDumpedSwSwitchState() {
+  if (!dumpedSwSwitchState_) {
+    CHECK(restoredSwSwitchState_.valid())
+        << "Was not able to recover software state after warmboot";
+    dumpedSwSwitchState_ = std::move(restoredSwSwitchState_).get();
+    dumpedSwSwitchState_->publish();
+    restoreExecutor_.reset();
+    restart_time::mark(RestartEvent::SWITCH_STATE_RESTORED);
+  }
+  return *dumpedSwSwitchState_;
+}
+
 void BcmWarmBootCache::populate(std::optional<folly::dynamic> warmBootState) {
   if (warmBootState) {
-    populateFromWarmBootState(*warmBootState);
+    populateFromWarmBootState(std::move(*warmBootState));
   } else {
     populateFromWarmBootState(getWarmBootState());
   }
@@ -508,6 +526,7 @@ void BcmWarmBootCache::populate(std::optional<folly::dynamic> warmBootState) {
   populateQosMaps();
   populateLabelSwitchActions();
   populateSwitchSettings();
+  restart_time::mark(RestartEvent::HW_TABLES_RESTORED);
 }
 
 bool BcmWarmBootCache::fillVlanPortInfo(Vlan* vlan) {
@@ -682,6 +701,14 @@ void BcmWarmBootCache::clear() {
   // since we want to delete entries only after there are no more
   // references to them.
   XLOG(DBG1) << "Warm boot: removing unreferenced entries";
+  // The restored switch state may never have been asked for. Wait for its
+  // restore to finish rather than leave it running on the executor.
+  if (restoredSwSwitchState_.valid()) {
+    std::move(restoredSwSwitchState_).getTry();
+  }
+  restoredSwSwitchState_ =
+      folly::SemiFuture<std::unique_ptr<SwitchState>>::makeEmpty();
+  restoreExecutor_.reset();
   dumpedSwSwitchState_.reset();
   hwSwitchEcmp2EgressIds_.clear();
   // First delete routes (fully qualified and others).
@@ -21,6 +21,8 @@ extern "C" {
 #include <folly/MacAddress.h>
 #include <folly/container/F14Map.h>
 #include <folly/dynamic.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 #include <algorithm>
 #include <list>
@@ -525,9 +527,12 @@ class BcmWarmBootCache {
       MirrorDirection direction) const;
   void programmedMirroredAcl(MirroredAcl2HandleCitr itr);
 
-  const SwitchState& getDumpedSwSwitchState() const {
-    return *dumpedSwSwitchState_;
-  }
+  /*
+   * The switch state dumped on exit. It is deserialized while the hardware
+   * tables are traversed and the ports initialized, and waited for on first
+   * use.
+   */
+  const SwitchState& getDumpedSwSwitchState();
 
   using Label2LabelActionMapCitr =
       typename Label2LabelActionMap::const_iterator;
@@ -585,7 +590,7 @@ class BcmWarmBootCache {
    */
   const EgressIds& getPathsForEcmp(EgressId ecmp) const;
   folly::dynamic getWarmBootState() const;
-  void populateFromWarmBootState(const folly::dynamic& warmBootState);
+  void populateFromWarmBootState(folly::dynamic warmBootState);
   // No copy or assignment.
   BcmWarmBootCache(const BcmWarmBootCache&) = delete;
   BcmWarmBootCache& operator=(const BcmWarmBootCache&) = delete;
@@ -655,6 +660,9 @@ class BcmWarmBootCache {
   // acl stats
   AclEntry2AclStat aclEntry2AclStat_;
 
+  std::unique_ptr<folly::CPUThreadPoolExecutor> restoreExecutor_;
+  folly::SemiFuture<std::unique_ptr<SwitchState>> restoredSwSwitchState_{
+      folly::SemiFuture<std::unique_ptr<SwitchState>>::makeEmpty()};
   std::unique_ptr<SwitchState> dumpedSwSwitchState_;
   MirrorEgressPath2Handle mirrorEgressPath2Handle_;
   MirroredPort2Handle mirroredPort2Handle_;
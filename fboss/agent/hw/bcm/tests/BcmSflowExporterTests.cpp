@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/bcm/BcmSflowExporter.h"
+
+#include <folly/IPAddress.h>
+#include <folly/io/Cursor.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+DECLARE_bool(sflow_export_v5);
+DECLARE_int32(sflow_max_datagram_size);
+
+using folly::io::Cursor;
+
+namespace facebook::fboss {
+
+namespace {
+
+const std::string kPacketData = "abcde";
+
+SflowPacketInfo makeSample(int16_t srcPort, int16_t dstPort) {
+  SflowPacketInfo info;
+  info.ingressSampled = true;
+  info.egressSampled = false;
+  info.srcPort = srcPort;
+  info.dstPort = dstPort;
+  info.packetData = kPacketData;
+  return info;
+}
+
+/*
+ * Check the datagram header and return the number of samples it carries.
+ */
+uint32_t checkDatagramHeader(
+    Cursor* cursor,
+    uint32_t addressType,
+    const folly::IPAddress& agentAddress,
+    uint32_t sequenceNumber) {
+  EXPECT_EQ(5, cursor->readBE<uint32_t>()); // version
+  EXPECT_EQ(addressType, cursor->readBE<uint32_t>());
+  auto address = cursor->readFixedString(agentAddress.byteCount());
+  EXPECT_EQ(
+      agentAddress,
+      folly::IPAddress::fromBinary(
+          folly::ByteRange(folly::StringPiece(address))));
+  EXPECT_EQ(0, cursor->readBE<uint32_t>()); // sub agent
+  EXPECT_EQ(sequenceNumber, cursor->readBE<uint32_t>());
+  cursor->skip(4); // uptime
+  return cursor->readBE<uint32_t>();
+}
+
+/*
+ * Check a flow sample record carrying a sample of kPacketData.
+ */
+void checkFlowSample(
+    Cursor* cursor,
+    uint32_t sequenceNumber,
+    uint32_t sourceID,
+    uint32_t samplingRate,
+    uint32_t input,
+    uint32_t output) {
+  EXPECT_EQ(1, cursor->readBE<uint32_t>()); // flow sample
+  EXPECT_EQ(64, cursor->readBE<uint32_t>()); // sample length
+  EXPECT_EQ(sequenceNumber, cursor->readBE<uint32_t>());
+  EXPECT_EQ(sourceID, cursor->readBE<uint32_t>());
+  EXPECT_EQ(samplingRate, cursor->readBE<uint32_t>());
+  EXPECT_EQ(0, cursor->readBE<uint32_t>()); // sample pool
+  EXPECT_EQ(0, cursor->readBE<uint32_t>()); // drops
+  EXPECT_EQ(input, cursor->readBE<uint32_t>());
+  EXPECT_EQ(output, cursor->readBE<uint32_t>());
+  EXPECT_EQ(1, cursor->readBE<uint32_t>()); // flow record count
+
+  EXPECT_EQ(1, cursor->readBE<uint32_t>()); // sampled header
+  EXPECT_EQ(24, cursor->readBE<uint32_t>()); // flow data length
+  EXPECT_EQ(1, cursor->readBE<uint32_t>()); // ethernet
+  EXPECT_EQ(kPacketData.size(), cursor->readBE<uint32_t>()); // frame length
+  EXPECT_EQ(0, cursor->readBE<uint32_t>()); // stripped
+  EXPECT_EQ(kPacketData.size(), cursor->readBE<uint32_t>()); // header length
+  EXPECT_EQ(kPacketData, cursor->readFixedString(kPacketData.size()));
+  // XDR padding
+  for (auto i = kPacketData.size(); i % 4 != 0; ++i) {
+    EXPECT_EQ(0, cursor->read<uint8_t>());
+  }
+}
+
+} // namespace
+
+TEST(BcmSflowExporterTest, buildDatagramsV5) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_sflow_export_v5 = true;
+
+  BcmSflowExporterTable table;
+  table.updateSamplingRates(PortID(5), 100, 200);
+  folly::IPAddress agentAddress("10.0.0.1");
+  *table.localIP_.wlock() = agentAddress;
+
+  auto datagrams = table.buildDatagrams({makeSample(5, 7)});
+  ASSERT_EQ(1, datagrams.size());
+
+  Cursor cursor(datagrams[0].get());
+  EXPECT_EQ(1, checkDatagramHeader(&cursor, 1 /* IPv4 */, agentAddress, 0));
+  // ifIndex data source, type 0 in the top byte
+  checkFlowSample(&cursor, 0, (0 << 24) | 5, 100, 5, 7);
+  EXPECT_TRUE(cursor.isAtEnd());
+}
+
+TEST(BcmSflowExporterTest, buildDatagramsSplitAtMaxSize) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_sflow_export_v5 = true;
+  // A 28 byte header for an IPv4 agent address, and 72 bytes per sample
+  FLAGS_sflow_max_datagram_size = 200;
+
+  BcmSflowExporterTable table;
+  folly::IPAddress agentAddress("10.0.0.1");
+  *table.localIP_.wlock() = agentAddress;
+
+  std::vector<SflowPacketInfo> samples;
+  for (int16_t port = 1; port <= 5; ++port) {
+    samples.push_back(makeSample(port, port + 1));
+  }
+  auto datagrams = table.buildDatagrams(samples);
+  ASSERT_EQ(3, datagrams.size());
+
+  uint32_t sampleSequence = 0;
+  std::vector<uint32_t> samplesPerDatagram = {2, 2, 1};
+  for (uint32_t i = 0; i < datagrams.size(); ++i) {
+    EXPECT_LE(
+        datagrams[i]->length(),
+        static_cast<size_t>(FLAGS_sflow_max_datagram_size));
+    Cursor cursor(datagrams[i].get());
+    auto numSamples = checkDatagramHeader(&cursor, 1, agentAddress, i);
+    EXPECT_EQ(samplesPerDatagram[i], numSamples);
+    for (uint32_t j = 0; j < numSamples; ++j) {
+      auto port = sampleSequence + 1;
+      // No sampling rate programmed for these ports
+      checkFlowSample(&cursor, sampleSequence, port, 0, port, port + 1);
+      ++sampleSequence;
+    }
+    EXPECT_TRUE(cursor.isAtEnd());
+  }
+}
+
+TEST(BcmSflowExporterTest, buildDatagramsWithoutAgentAddress) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_sflow_export_v5 = true;
+
+  // No sampling rate programmed yet, so the agent address was never set
+  BcmSflowExporterTable table;
+  auto datagrams = table.buildDatagrams({makeSample(5, 7)});
+  ASSERT_EQ(1, datagrams.size());
+
+  auto agentAddress = table.localIP_.copy();
+  ASSERT_TRUE(agentAddress.isV6());
+  Cursor cursor(datagrams[0].get());
+  EXPECT_EQ(1, checkDatagramHeader(&cursor, 2 /* IPv6 */, agentAddress, 0));
+  checkFlowSample(&cursor, 0, 5, 0, 5, 7);
+  EXPECT_TRUE(cursor.isAtEnd());
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+
+namespace facebook::fboss {
+
+namespace {
+constexpr int kNumAcls = 2000;
+
+cfg::AclEntry makeDenyAcl(const std::string& name, int dstPort) {
+  cfg::AclEntry acl;
+  *acl.name_ref() = name;
+  *acl.actionType_ref() = cfg::AclActionType::DENY;
+  acl.l4DstPort_ref() = dstPort;
+  return acl;
+}
+} // namespace
+
+/*
+ * Time how long it takes to reprogram a kNumAcls entry ACL table when a
+ * single ACL is inserted at the top of it. With sparse priorities only the
+ * new entry should have to be programmed.
+ */
+BENCHMARK(HwAclInsertAtTop) {
+  folly::BenchmarkSuspender suspender;
+  auto ensemble = createHwEnsemble(HwSwitch::PACKET_RX_DESIRED);
+  auto hwSwitch = ensemble->getHwSwitch();
+  auto config =
+      utility::onePortPerVlanConfig(hwSwitch, ensemble->masterLogicalPortIds());
+  for (int i = 0; i < kNumAcls; ++i) {
+    config.acls_ref()->push_back(
+        makeDenyAcl(folly::to<std::string>("acl", i), i + 1));
+  }
+  ensemble->applyInitialConfig(config);
+
+  config.acls_ref()->insert(
+      config.acls_ref()->begin(), makeDenyAcl("aclTop", kNumAcls + 1));
+  auto newState = applyThriftConfig(
+      ensemble->getProgrammedState(), &config, ensemble->getPlatform());
+
+  suspender.dismiss();
+  ensemble->applyNewState(newState);
+  suspender.rehire();
+}
+
+} // namespace facebook::fboss
@@ -19,17 +19,38 @@
 #include "fboss/agent/test/RouteScaleGenerators.h"
 
 #include <folly/Benchmark.h>
+#include <folly/Conv.h>
 #include <folly/IPAddress.h>
 
+#include <algorithm>
+#include <chrono>
 #include <thread>
+#include <vector>
 
 namespace facebook::fboss {
 
 using utility::getEcmpSizeInHw;
 
-BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
+namespace {
+constexpr int kEcmpWidth = 4;
+// ECMP groups sharing the next hop over the port we bring down
+constexpr int kNumEcmpGroups = 8;
+constexpr int kMaxEcmpWidth = kEcmpWidth + kNumEcmpGroups - 1;
+
+int64_t percentile(
+    const std::vector<std::chrono::microseconds>& sorted,
+    int percent) {
+  auto idx = std::min(sorted.size() - 1, sorted.size() * percent / 100);
+  return sorted[idx].count();
+}
+} // namespace
+
+/*
+ * Bring down a port whose next hop is a member of kNumEcmpGroups ECMP groups
+ * of different widths, and record how long each group takes to shrink in HW.
+ */
+BENCHMARK_COUNTERS(HwEcmpGroupShrinkWithCompetingRouteUpdates, counters) {
   folly::BenchmarkSuspender suspender;
-  constexpr int kEcmpWidth = 4;
   auto ensemble = createHwEnsemble(
       HwSwitch::PACKET_RX_DESIRED | HwSwitch::LINKSCAN_DESIRED);
   auto hwSwitch = ensemble->getHwSwitch();
@@ -39,14 +60,29 @@ BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
   ensemble->applyInitialConfig(config);
   auto ecmpHelper =
       utility::EcmpSetupAnyNPorts6(ensemble->getProgrammedState());
-  auto ecmpRouteState = ecmpHelper.setupECMPForwarding(
-      ecmpHelper.resolveNextHops(ensemble->getProgrammedState(), kEcmpWidth),
-      kEcmpWidth);
+  auto ecmpRouteState =
+      ecmpHelper.resolveNextHops(ensemble->getProgrammedState(), kMaxEcmpWidth);
+  // Groups of width kEcmpWidth and up all contain the first port's next hop
+  std::vector<std::pair<folly::CIDRNetwork, int>> ecmpGroups;
+  for (auto width = kEcmpWidth; width <= kMaxEcmpWidth; ++width) {
+    // Keep the default route group, and add a /64 for each wider group
+    folly::IPAddressV6 addr;
+    uint8_t mask = 0;
+    if (width != kEcmpWidth) {
+      addr =
+          folly::IPAddressV6(folly::to<std::string>("2001:db8:", width, "::"));
+      mask = 64;
+    }
+    ecmpRouteState = ecmpHelper.setupECMPForwarding(
+        ecmpRouteState, width, {RoutePrefixV6{addr, mask}});
+    ecmpGroups.emplace_back(folly::CIDRNetwork(addr, mask), width);
+  }
   ensemble->applyNewState(ecmpRouteState);
-  auto prefix = folly::CIDRNetwork(folly::IPAddress("::"), 0);
-  CHECK_EQ(
-      kEcmpWidth,
-      getEcmpSizeInHw(hwSwitch, prefix, ecmpHelper.getRouterId(), kEcmpWidth));
+  for (const auto& [prefix, width] : ecmpGroups) {
+    CHECK_EQ(
+        width,
+        getEcmpSizeInHw(hwSwitch, prefix, ecmpHelper.getRouterId(), width));
+  }
 
   auto routeStates = utility::RouteDistributionGenerator(
                          ensemble->getProgrammedState(),
@@ -84,14 +120,36 @@ BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
   // the executing the API call to trigger link down above is relatively slow -
   // starting the timer before link down increases the benchmark time by order
   // of magnitude.
+  std::vector<std::chrono::microseconds> shrinkTimes;
+  std::vector<bool> shrunk(ecmpGroups.size(), false);
+  auto start = std::chrono::steady_clock::now();
   suspender.dismiss();
-  // Busy loop to see how soon after port down do we shrink ECMP group
-  while (
-      getEcmpSizeInHw(hwSwitch, prefix, ecmpHelper.getRouterId(), kEcmpWidth) !=
-      kEcmpWidth - 1) {
+  // Busy loop to see how soon after port down do we shrink each ECMP group
+  while (shrinkTimes.size() < ecmpGroups.size()) {
+    for (size_t i = 0; i < ecmpGroups.size(); ++i) {
+      if (shrunk[i]) {
+        continue;
+      }
+      const auto& [prefix, width] = ecmpGroups[i];
+      if (getEcmpSizeInHw(
+              hwSwitch, prefix, ecmpHelper.getRouterId(), width) ==
+          width - 1) {
+        shrunk[i] = true;
+        shrinkTimes.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start));
+      }
+    }
   }
   suspender.rehire();
   t.join();
+
+  std::sort(shrinkTimes.begin(), shrinkTimes.end());
+  counters["ecmp_groups"] = ecmpGroups.size();
+  counters["shrink_us_p50"] = percentile(shrinkTimes, 50);
+  counters["shrink_us_p90"] = percentile(shrinkTimes, 90);
+  counters["shrink_us_p99"] = percentile(shrinkTimes, 99);
+  counters["shrink_us_max"] = shrinkTimes.back().count();
 }
 
 } // namespace facebook::fboss
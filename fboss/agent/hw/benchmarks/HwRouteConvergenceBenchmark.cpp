@@ -0,0 +1,330 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/HwSwitch.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/rib/ForwardingInformationBaseUpdater.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
+#include "fboss/agent/state/RouteUpdater.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/EcmpSetupHelper.h"
+#include "fboss/agent/test/RouteDistributionGenerator.h"
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+DEFINE_bool(
+    route_convergence_standalone_rib,
+    false,
+    "Converge routes through the standalone RIB and program them from the "
+    "FIBs, rather than from the route tables. Only BcmSwitch programs FIBs");
+
+namespace facebook::fboss {
+
+namespace {
+constexpr unsigned int kChunkSize = 4000;
+constexpr unsigned int kEcmpWidth = 4;
+// Percentage of routes whose next hops change, and that are withdrawn,
+// after the initial convergence.
+constexpr unsigned int kChurnPercent = 10;
+const RouterID kRouterID(0);
+const ClientID kClientID(1001);
+
+struct StageTimes {
+  std::chrono::microseconds ribUpdate{0};
+  std::chrono::microseconds resolution{0};
+  std::chrono::microseconds fibUpdate{0};
+  std::chrono::microseconds stateDelta{0};
+  std::chrono::microseconds hwProgram{0};
+};
+
+template <typename Fn>
+std::chrono::microseconds timeIt(Fn fn) {
+  auto begin = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - begin);
+}
+
+UnicastRoute toUnicastRoute(
+    const utility::RouteDistributionGenerator::Route& route,
+    size_t nhopWidth) {
+  UnicastRoute unicastRoute;
+  unicastRoute.dest_ref()->ip =
+      facebook::network::toBinaryAddress(route.prefix.first);
+  unicastRoute.dest_ref()->prefixLength = route.prefix.second;
+  for (size_t i = 0; i < std::min(nhopWidth, route.nhops.size()); ++i) {
+    NextHopThrift nhop;
+    *nhop.address_ref() = facebook::network::toBinaryAddress(route.nhops[i]);
+    *nhop.weight_ref() = ECMP_WEIGHT;
+    unicastRoute.nextHops_ref()->push_back(std::move(nhop));
+  }
+  return unicastRoute;
+}
+
+IpPrefix toIpPrefix(const utility::RouteDistributionGenerator::Route& route) {
+  IpPrefix prefix;
+  prefix.ip = facebook::network::toBinaryAddress(route.prefix.first);
+  prefix.prefixLength = route.prefix.second;
+  return prefix;
+}
+
+RouteNextHopEntry nextHopEntry(
+    const std::vector<folly::IPAddress>& nhops,
+    size_t width) {
+  RouteNextHopSet nhopSet;
+  for (size_t i = 0; i < std::min(width, nhops.size()); ++i) {
+    nhopSet.emplace(UnresolvedNextHop(nhops[i], ECMP_WEIGHT));
+  }
+  return RouteNextHopEntry(nhopSet, AdminDistance::EBGP);
+}
+
+/*
+ * FIB callback of the RIB: build the next state's FIB, which is then
+ * programmed separately so that it can be timed on its own.
+ */
+void updateFib(
+    RouterID vrf,
+    const rib::IPv4NetworkToRouteMap& v4NetworkToRoute,
+    const rib::IPv6NetworkToRouteMap& v6NetworkToRoute,
+    void* cookie) {
+  rib::ForwardingInformationBaseUpdater fibUpdater(
+      vrf, v4NetworkToRoute, v6NetworkToRoute);
+  auto nextState = static_cast<std::shared_ptr<SwitchState>*>(cookie);
+  *nextState = fibUpdater(*nextState);
+}
+
+/*
+ * Push a batch of route updates through the standalone RIB (route injection,
+ * resolution and FIB update) and return the state with the updated FIBs.
+ */
+std::shared_ptr<SwitchState> updateRib(
+    HwSwitchEnsemble* ensemble,
+    const utility::RouteDistributionGenerator::RouteChunk& toAdd,
+    size_t nhopWidth,
+    const utility::RouteDistributionGenerator::RouteChunk& toDel,
+    StageTimes& times) {
+  std::vector<UnicastRoute> routesToAdd;
+  routesToAdd.reserve(toAdd.size());
+  for (const auto& route : toAdd) {
+    routesToAdd.push_back(toUnicastRoute(route, nhopWidth));
+  }
+  std::vector<IpPrefix> routesToDel;
+  routesToDel.reserve(toDel.size());
+  for (const auto& route : toDel) {
+    routesToDel.push_back(toIpPrefix(route));
+  }
+
+  auto newState = ensemble->getProgrammedState();
+  auto stats = ensemble->getRib()->update(
+      kRouterID,
+      kClientID,
+      AdminDistance::EBGP,
+      routesToAdd,
+      routesToDel,
+      false /* resetClientsRoutes */,
+      "route convergence benchmark",
+      &updateFib,
+      static_cast<void*>(&newState));
+  times.ribUpdate +=
+      stats.duration - stats.resolutionDuration - stats.fibUpdateDuration;
+  times.resolution += stats.resolutionDuration;
+  times.fibUpdate += stats.fibUpdateDuration;
+  return newState;
+}
+
+/*
+ * Push a batch of route updates through the route updater (route injection,
+ * and resolution while building the route tables) and return the state with
+ * the updated route tables.
+ */
+std::shared_ptr<SwitchState> updateRouteTables(
+    HwSwitchEnsemble* ensemble,
+    const utility::RouteDistributionGenerator::RouteChunk& toAdd,
+    size_t nhopWidth,
+    const utility::RouteDistributionGenerator::RouteChunk& toDel,
+    StageTimes& times) {
+  auto oldState = ensemble->getProgrammedState();
+  RouteUpdater updater(oldState->getRouteTables());
+  times.ribUpdate += timeIt([&]() {
+    for (const auto& route : toAdd) {
+      updater.addRoute(
+          kRouterID,
+          route.prefix.first,
+          route.prefix.second,
+          kClientID,
+          nextHopEntry(route.nhops, nhopWidth));
+    }
+    for (const auto& route : toDel) {
+      updater.delRoute(
+          kRouterID, route.prefix.first, route.prefix.second, kClientID);
+    }
+  });
+  std::shared_ptr<RouteTableMap> newTables;
+  times.resolution += timeIt([&]() { newTables = updater.updateDone(); });
+  if (!newTables) {
+    return oldState;
+  }
+  auto newState = oldState->clone();
+  newState->resetRouteTables(newTables);
+  return newState;
+}
+
+template <typename Delta>
+size_t numChanged(const Delta& delta) {
+  return std::distance(delta.begin(), delta.end());
+}
+
+/*
+ * Converge a batch of route updates: update the routes, compute the
+ * resulting StateDelta and program it.
+ */
+void convergeRoutes(
+    HwSwitchEnsemble* ensemble,
+    const utility::RouteDistributionGenerator::RouteChunk& toAdd,
+    size_t nhopWidth,
+    const utility::RouteDistributionGenerator::RouteChunk& toDel,
+    StageTimes& times) {
+  auto oldState = ensemble->getProgrammedState();
+  auto newState = FLAGS_route_convergence_standalone_rib
+      ? updateRib(ensemble, toAdd, nhopWidth, toDel, times)
+      : updateRouteTables(ensemble, toAdd, nhopWidth, toDel, times);
+  if (newState == oldState) {
+    return;
+  }
+
+  newState->publish();
+  times.stateDelta += timeIt([&]() {
+    StateDelta delta(oldState, newState);
+    size_t changed = 0;
+    for (const auto& routeDelta : delta.getRouteTablesDelta()) {
+      changed += numChanged(routeDelta.getRoutesV4Delta());
+      changed += numChanged(routeDelta.getRoutesV6Delta());
+    }
+    for (const auto& fibDelta : delta.getFibsDelta()) {
+      changed += numChanged(fibDelta.getV4FibDelta());
+      changed += numChanged(fibDelta.getV6FibDelta());
+    }
+    folly::doNotOptimizeAway(changed);
+  });
+  times.hwProgram += timeIt([&]() { ensemble->applyNewState(newState); });
+}
+
+/*
+ * Measure route convergence, from route updates to hardware programming,
+ * for numRoutes routes split evenly across v6 /64s and v4 /24s. Routes are
+ * programmed from the route tables, or from the standalone RIB's FIBs with
+ * --route_convergence_standalone_rib, which only BcmSwitch supports so far.
+ * They are added in kChunkSize batches, after which kChurnPercent of them
+ * change next hops and another kChurnPercent are withdrawn.
+ */
+void routeConvergenceBenchmarker(
+    uint32_t numRoutes,
+    folly::UserCounters& counters) {
+  folly::BenchmarkSuspender suspender;
+  auto ensemble = createHwEnsemble(
+      HwSwitch::PACKET_RX_DESIRED | HwSwitch::LINKSCAN_DESIRED);
+  auto config = utility::onePortPerVlanConfig(
+      ensemble->getHwSwitch(), ensemble->masterLogicalPortIds());
+  ensemble->applyInitialConfig(config);
+
+  if (FLAGS_route_convergence_standalone_rib) {
+    // Seed the RIB with the interface routes, and create the FIBs. The route
+    // tables programmed with the initial config only hold the same interface
+    // (and ALPM default) routes, so they are left alone.
+    auto ribState = applyThriftConfig(
+        ensemble->getProgrammedState(),
+        &config,
+        ensemble->getPlatform(),
+        ensemble->getRib());
+    if (ribState) {
+      ensemble->applyNewState(ribState);
+    }
+  }
+
+  auto ecmpHelper6 =
+      utility::EcmpSetupAnyNPorts6(ensemble->getProgrammedState());
+  auto ecmpHelper4 =
+      utility::EcmpSetupAnyNPorts4(ensemble->getProgrammedState());
+  auto state =
+      ecmpHelper6.resolveNextHops(ensemble->getProgrammedState(), kEcmpWidth);
+  state = ecmpHelper4.resolveNextHops(state, kEcmpWidth);
+  ensemble->applyNewState(state);
+
+  const utility::RouteDistributionGenerator generator(
+      ensemble->getProgrammedState(),
+      {{64, numRoutes / 2}},
+      {{24, numRoutes - numRoutes / 2}},
+      kChunkSize,
+      kEcmpWidth,
+      kRouterID);
+  const auto& chunks = generator.get();
+
+  // Pick churned routes across the whole route set
+  utility::RouteDistributionGenerator::RouteChunk changed;
+  utility::RouteDistributionGenerator::RouteChunk withdrawn;
+  uint64_t routeIndex = 0;
+  for (const auto& chunk : chunks) {
+    for (const auto& route : chunk) {
+      auto bucket = routeIndex++ % 100;
+      if (bucket < kChurnPercent) {
+        changed.push_back(route);
+      } else if (bucket < 2 * kChurnPercent) {
+        withdrawn.push_back(route);
+      }
+    }
+  }
+
+  StageTimes times;
+  std::chrono::microseconds churnTime{0};
+  suspender.dismiss();
+  auto addTime = timeIt([&]() {
+    for (const auto& chunk : chunks) {
+      convergeRoutes(ensemble.get(), chunk, kEcmpWidth, {}, times);
+    }
+  });
+  churnTime = timeIt([&]() {
+    convergeRoutes(ensemble.get(), changed, kEcmpWidth / 2, withdrawn, times);
+  });
+  suspender.rehire();
+
+  counters["routes"] = numRoutes;
+  counters["add_convergence_us"] = addTime.count();
+  counters["churn_convergence_us"] = churnTime.count();
+  counters["rib_update_us"] = times.ribUpdate.count();
+  counters["resolution_us"] = times.resolution.count();
+  counters["fib_update_us"] = times.fibUpdate.count();
+  counters["state_delta_us"] = times.stateDelta.count();
+  counters["hw_program_us"] = times.hwProgram.count();
+}
+} // namespace
+
+BENCHMARK_COUNTERS(HwRouteConvergence10k, counters) {
+  routeConvergenceBenchmarker(10'000, counters);
+}
+
+BENCHMARK_COUNTERS(HwRouteConvergence100k, counters) {
+  routeConvergenceBenchmarker(100'000, counters);
+}
+
+BENCHMARK_COUNTERS(HwRouteConvergence500k, counters) {
+  routeConvergenceBenchmarker(500'000, counters);
+}
+
+} // namespace facebook::fboss
@@ -15,24 +15,46 @@
 
 #include <folly/Benchmark.h>
 
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+
 namespace facebook::fboss {
 
+/*
+ * Resident memory of the benchmark process. This covers everything the
+ * process holds, programmed switch states included, not just the HW route
+ * tables.
+ */
+inline int64_t residentMemoryBytes() {
+  std::ifstream statm("/proc/self/statm");
+  uint64_t totalPages = 0;
+  uint64_t residentPages = 0;
+  statm >> totalPages >> residentPages;
+  return static_cast<int64_t>(residentPages) * sysconf(_SC_PAGESIZE);
+}
+
 /*
  * Helper function to benchmark speed of route insertion, deletion
  * in HW. This function inits the ASIC, generate switch states for
  * a given route distribution and then measures the time it takes
- * to add (or delete post addition) these routes
+ * to add (or delete post addition) these routes. When adding routes,
+ * the number of routes and the growth in process resident memory per route
+ * are reported as counters.
  */
 template <typename RouteScaleGeneratorT>
-void routeAddDelBenchmarker(bool measureAdd) {
+void routeAddDelBenchmarker(
+    bool measureAdd,
+    folly::UserCounters* counters = nullptr) {
   folly::BenchmarkSuspender suspender;
   auto ensemble = createHwEnsemble(
       HwSwitch::PACKET_RX_DESIRED | HwSwitch::LINKSCAN_DESIRED);
   auto config = utility::onePortPerVlanConfig(
       ensemble->getHwSwitch(), ensemble->masterLogicalPortIds());
   ensemble->applyInitialConfig(config);
-  static const auto states =
-      RouteScaleGeneratorT(ensemble->getProgrammedState()).getSwitchStates();
+  static const RouteScaleGeneratorT generator(ensemble->getProgrammedState());
+  static const auto& states = generator.getSwitchStates();
+  auto memoryBefore = residentMemoryBytes();
   if (measureAdd) {
     // Activate benchmarker before applying switch states
     // for adding routes to h/w
@@ -46,11 +68,22 @@ void routeAddDelBenchmarker(bool measureAdd) {
   // route addition
   // - Activate benchmark if we are measuring route deletion
   measureAdd ? suspender.rehire() : suspender.dismiss();
+  if (counters) {
+    uint64_t numRoutes = 0;
+    for (const auto& chunk : generator.get()) {
+      numRoutes += chunk.size();
+    }
+    // RSS may shrink as freed memory is returned to the OS
+    auto rssGrowth = std::max<int64_t>(residentMemoryBytes() - memoryBefore, 0);
+    (*counters)["routes"] = numRoutes;
+    (*counters)["process_rss_growth_bytes_per_route"] =
+        numRoutes ? rssGrowth / numRoutes : 0;
+  }
 }
 
-#define ROUTE_ADD_BENCHMARK(name, RouteScaleGeneratorT) \
-  BENCHMARK(name) {                                     \
-    routeAddDelBenchmarker<RouteScaleGeneratorT>(true); \
+#define ROUTE_ADD_BENCHMARK(name, RouteScaleGeneratorT)            \
+  BENCHMARK_COUNTERS(name, counters) {                             \
+    routeAddDelBenchmarker<RouteScaleGeneratorT>(true, &counters); \
   }
 
 #define ROUTE_DEL_BENCHMARK(name, RouteScaleGeneratorT)  \
@@ -26,6 +26,7 @@
 #include <iostream>
 
 DEFINE_bool(json, true, "Output in json form");
+DECLARE_bool(warm_boot_journal);
 
 namespace {
 class StopWatch {
@@ -37,9 +38,11 @@ class StopWatch {
     if (FLAGS_json) {
       folly::dynamic warmBootTime = folly::dynamic::object;
       warmBootTime["warm_boot_msecs"] = durationMillseconds.count();
+      warmBootTime["warm_boot_journal"] = FLAGS_warm_boot_journal;
       std::cout << warmBootTime << std::endl;
     } else {
-      XLOG(INFO) << " warm boot msecs: " << durationMillseconds.count();
+      XLOG(INFO) << " warm boot msecs: " << durationMillseconds.count()
+                 << (FLAGS_warm_boot_journal ? " (journaled)" : "");
     }
   }
 
@@ -93,6 +96,8 @@ void runBenchmark() {
                   .getSwitchStates()
                   .back();
   }
+  // With --warm_boot_journal the routes are journaled as they are applied,
+  // and graceful exit only has to sync the journal
   ensemble->applyNewState(toApply);
   // Static such that the object destructor runs as late as possible. In
   // Static such that the object destructor runs as late as possible. In
@@ -11,6 +11,7 @@
 #include "fboss/agent/hw/sai/switch/SaiSwitch.h"
 
 #include "fboss/agent/Constants.h"
+#include "fboss/agent/RestartTimeTracker.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/hw/sai/api/AdapterKeySerializers.h"
 #include "fboss/agent/hw/sai/api/FdbApi.h"
@@ -45,6 +46,8 @@
 #include "fboss/agent/hw/HwSwitchWarmBootHelper.h"
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/logging/xlog.h>
 
 #include <optional>
@@ -53,6 +56,8 @@ extern "C" {
 #include <sai.h>
 }
 
+DECLARE_uint32(warm_boot_restore_threads);
+
 DEFINE_bool(enable_sai_debug_log, false, "Turn on SAI debugging logging");
 DEFINE_bool(flexports, true, "Load the agent with flexport support enabled");
 
@@ -559,12 +564,19 @@ HwInitResult SaiSwitch::initLocked(
   std::unique_ptr<folly::dynamic> adapterKeys2AdapterHostKeysJson;
 
   std::optional<SwitchSaiId> existingSwitchId;
+  // Rebuilt while the SaiStore is reloaded from the adapter
+  std::unique_ptr<folly::CPUThreadPoolExecutor> restoreExecutor;
+  auto restoredSwitchState =
+      folly::SemiFuture<std::unique_ptr<SwitchState>>::makeEmpty();
 
   sai_api_initialize(0, platform_->getServiceMethodTable());
   if (bootType_ == BootType::WARM_BOOT) {
     auto switchStateJson = wbHelper->getWarmBootState();
-    ret.switchState = SwitchState::fromFollyDynamic(switchStateJson[kSwSwitch]);
-    ret.switchState->publish();
+    restoreExecutor = std::make_unique<folly::CPUThreadPoolExecutor>(
+        std::max(FLAGS_warm_boot_restore_threads, 1u),
+        std::make_shared<folly::NamedThreadFactory>("WarmBootRestore"));
+    restoredSwitchState = SwitchState::restoreFromFollyDynamic(
+        std::move(switchStateJson[kSwSwitch]), restoreExecutor.get());
     if (platform_->getAsic()->needsObjectKeyCache()) {
       adapterKeysJson = std::make_unique<folly::dynamic>(
           switchStateJson[kHwSwitch][kAdapterKeys]);
@@ -598,6 +610,13 @@ HwInitResult SaiSwitch::initLocked(
     saiStore->reload(
         adapterKeysJson.get(), adapterKeys2AdapterHostKeysJson.get());
   }
+  if (bootType_ == BootType::WARM_BOOT) {
+    restart_time::mark(RestartEvent::HW_TABLES_RESTORED);
+    ret.switchState = std::move(restoredSwitchState).get();
+    ret.switchState->publish();
+    restoreExecutor.reset();
+    restart_time::mark(RestartEvent::SWITCH_STATE_RESTORED);
+  }
   managerTable_->createSaiTableManagers(platform_, concurrentIndices_.get());
   callback_ = callback;
   __gSaiSwitch = this;
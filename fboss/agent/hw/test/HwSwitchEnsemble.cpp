@@ -16,6 +16,7 @@
 #include "fboss/agent/L2Entry.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/WarmBootJournal.h"
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 #include "fboss/agent/hw/test/HwLinkStateToggler.h"
 #include "fboss/agent/state/Interface.h"
@@ -33,6 +34,8 @@ DEFINE_int32(
     5909,
     "Port for thrift server to use (use with --setup_thrift");
 
+DECLARE_bool(warm_boot_journal);
+
 using namespace std::chrono_literals;
 
 namespace facebook::fboss {
@@ -97,13 +100,15 @@ std::shared_ptr<SwitchState> HwSwitchEnsemble::applyNewState(
     return programmedState_;
   }
   newState->publish();
-  StateDelta delta(programmedState_, newState);
+  auto oldState = programmedState_;
+  StateDelta delta(oldState, newState);
   programmedState_ = getHwSwitch()->stateChanged(delta);
   if (!allowPartialStateApplication_) {
     // Assert that our desired state was applied exactly
     CHECK_EQ(newState, programmedState_);
   }
   programmedState_->publish();
+  journalProgrammedState(oldState, programmedState_);
   return programmedState_;
 }
 
@@ -243,6 +248,11 @@ void HwSwitchEnsemble::setupEnsemble(
   // This will catch errors if test cases accidentally try to modify this
   // programmedState_ without first cloning it.
   programmedState_->publish();
+  if (FLAGS_warm_boot_journal) {
+    warmBootJournal_ = std::make_unique<WarmBootJournal>(
+        WarmBootJournal::path(platform_->getWarmBootDir()));
+    journalProgrammedState(nullptr, programmedState_);
+  }
 
   routingInformationBase_ = std::make_unique<rib::RoutingInformationBase>();
 
@@ -270,8 +280,25 @@ void HwSwitchEnsemble::gracefulExit() {
   // Initiate warm boot
   folly::dynamic switchState = folly::dynamic::object;
   getHwSwitch()->unregisterCallbacks();
-  switchState[kSwSwitch] = getProgrammedState()->toFollyDynamic();
+  if (warmBootJournal_) {
+    warmBootJournal_->sync();
+  } else {
+    switchState[kSwSwitch] = getProgrammedState()->toFollyDynamic();
+  }
   getHwSwitch()->gracefulExit(switchState);
 }
 
+void HwSwitchEnsemble::journalProgrammedState(
+    const std::shared_ptr<SwitchState>& oldState,
+    const std::shared_ptr<SwitchState>& newState) {
+  if (!warmBootJournal_ || oldState == newState) {
+    return;
+  }
+  if (oldState) {
+    warmBootJournal_->append(StateDelta(oldState, newState));
+  } else {
+    warmBootJournal_->checkpoint(newState);
+  }
+}
+
 } // namespace facebook::fboss
@@ -27,6 +27,7 @@ namespace facebook::fboss {
 class Platform;
 class SwitchState;
 class HwLinkStateToggler;
+class WarmBootJournal;
 
 class HwSwitchEnsemble : public HwSwitch::Callback {
  public:
@@ -133,6 +134,9 @@ class HwSwitchEnsemble : public HwSwitch::Callback {
  private:
   bool waitForAnyPorAndQueutOutBytesIncrement(
       const std::map<PortID, HwPortStats>& originalPortStats);
+  void journalProgrammedState(
+      const std::shared_ptr<SwitchState>& oldState,
+      const std::shared_ptr<SwitchState>& newState);
 
   std::shared_ptr<SwitchState> programmedState_{nullptr};
   std::unique_ptr<rib::RoutingInformationBase> routingInformationBase_;
@@ -141,6 +145,7 @@ class HwSwitchEnsemble : public HwSwitch::Callback {
   uint32_t featuresDesired_{0};
   folly::Synchronized<std::set<HwSwitchEventObserverIf*>> hwEventObservers_;
   std::unique_ptr<std::thread> thriftThread_;
+  std::unique_ptr<WarmBootJournal> warmBootJournal_;
   bool allowPartialStateApplication_{false};
   SwitchRunState runState_{SwitchRunState::UNINITIALIZED};
 };
@@ -112,6 +112,41 @@ struct RouteDetails {
   7: list<NextHopThrift> nextHops,
 }
 
+/*
+ * Server side filter applied while walking the route table. Unset fields
+ * match every route.
+ */
+struct RouteTableFilter {
+  1: optional i32 vrf,
+  // Only routes with a next hop entry from this client
+  2: optional i16 clientId,
+  // Only routes equal to or more specific than this prefix
+  3: optional IpPrefix prefix,
+}
+
+/*
+ * Position of the last route returned by a page. Routes are walked in
+ * (vrf, v4 then v6, prefix) order, so a cursor stays valid across route
+ * table updates: the next page resumes after this prefix.
+ */
+struct RouteTableCursor {
+  1: i32 vrf,
+  2: IpPrefix prefix,
+}
+
+struct RouteTablePageRequest {
+  1: RouteTableFilter filter,
+  2: i32 pageSize = 1000,
+  // Start from the beginning of the route table if unset
+  3: optional RouteTableCursor cursor,
+}
+
+struct RouteTablePage {
+  1: list<RouteDetails> routes,
+  // Unset once the route table has been walked completely
+  2: optional RouteTableCursor nextCursor,
+}
+
 struct MplsRouteDetails {
   1: mpls.MplsLabel topLabel
   2: string action
@@ -483,6 +518,31 @@ struct LinkNeighborThrift {
   15: optional string localPortName
 }
 
+/*
+ * Time taken by a callback run on an agent thread
+ */
+struct ThreadCallbackLatency {
+  1: string name
+  2: i64 count
+  3: i64 avgUsecs
+  4: i64 maxUsecs
+}
+
+/*
+ * Load on an agent thread over its last heartbeat interval
+ */
+struct ThreadProfile {
+  1: string name
+  // CPU time used by the thread, in percent of the interval
+  2: i32 cpuPct
+  // Time the thread's event loop spent running callbacks, in percent
+  3: i32 loopBusyPct
+  4: i64 loopBusyP50Usecs
+  5: i64 loopBusyP99Usecs
+  // Slowest callbacks timed on the thread, slowest first
+  6: list<ThreadCallbackLatency> slowestCallbacks
+}
+
 enum ClientID {
   BGPD = 0,
   STATIC_ROUTE = 1,
@@ -658,6 +718,16 @@ service FbossCtrl extends fb303.FacebookService {
     throws (1: fboss.FbossBaseError error)
   list<RouteDetails> getRouteTableDetails()
     throws (1: fboss.FbossBaseError error)
+  /*
+   * Paginated and streaming variants of getRouteTableDetails. Both walk the
+   * applied switch state and filter routes server side, so large route
+   * tables never need to be materialized in a single response.
+   */
+  RouteTablePage getRouteTableDetailsPage(1: RouteTablePageRequest request)
+    throws (1: fboss.FbossBaseError error)
+  stream<list<RouteDetails>> streamRouteTableDetails(
+    1: RouteTableFilter filter,
+  ) throws (1: fboss.FbossBaseError error)
   InterfaceDetail getInterfaceDetail(1: i32 interfaceId)
     throws (1: fboss.FbossBaseError error)
 
@@ -827,6 +897,12 @@ service FbossCtrl extends fb303.FacebookService {
   void stopLoggingAnyMplsRouteUpdates(1: string identifier)
   list<MplsRouteUpdateLoggingInfo> getMplsRouteUpdateLoggingTrackedLabels()
 
+  /*
+   * CPU and event loop load of the agent threads, and their slowest
+   * callbacks
+   */
+  list<ThreadProfile> getThreadProfiles()
+
   void keepalive()
 
   i32 getIdleTimeout()
@@ -16,6 +16,7 @@
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/TxPacketTemplate.h"
 #include "fboss/agent/packet/ICMPHdr.h"
 #include "fboss/agent/packet/IPv6Hdr.h"
 #include "fboss/agent/packet/PktUtil.h"
@@ -98,7 +99,7 @@ class IPv6RAImpl : private folly::AsyncTimeout {
   void sendRouteAdvertisement();
 
   std::chrono::milliseconds interval_;
-  folly::IOBuf buf_;
+  TxPacketTemplate frame_;
   SwSwitch* const sw_{nullptr};
 };
 
@@ -129,31 +130,19 @@ void IPv6RAImpl::stop(IPv6RAImpl* ra) {
 
 void IPv6RAImpl::initPacket(const Interface* intf) {
   auto totalLength = IPv6RouteAdvertiser::getPacketSize(intf);
-  buf_ = IOBuf(IOBuf::CREATE, totalLength);
-  buf_.append(totalLength);
-  RWPrivateCursor cursor(&buf_);
+  IOBuf buf(IOBuf::CREATE, totalLength);
+  buf.append(totalLength);
+  RWPrivateCursor cursor(&buf);
   IPv6RouteAdvertiser::createAdvertisementPacket(
       intf, &cursor, MacAddress("33:33:00:00:00:01"), IPAddressV6("ff02::1"));
+  frame_ = TxPacketTemplate(folly::ByteRange(buf.data(), buf.length()));
 }
 
 void IPv6RAImpl::sendRouteAdvertisement() {
   XLOG(DBG5) << "sending route advertisement:\n"
-             << PktUtil::hexDump(Cursor(&buf_));
-
-  // Allocate a new packet, and copy our data into it.
-  //
-  // Note that we unfortunately do need to perform a buffer copy here.
-  // The TxPacket is required to use DMA memory for its buffer, so we can't do
-  // a simple clone.
-  //
-  // TODO: In the future it would be nice to support allocating buf_ in a DMA
-  // buffer so that we really can just clone a reference to it here, rather
-  // than doing a copy.
-  uint32_t pktLen = buf_.length();
-  auto pkt = sw_->allocatePacket(pktLen);
-  RWPrivateCursor cursor(pkt->buf());
-  cursor.push(buf_.data(), buf_.length());
+             << PktUtil::hexDump(Cursor(&frame_.frame()));
 
+  auto pkt = frame_.instantiate(sw_);
   sw_->sendNetworkControlPacketAsync(std::move(pkt), std::nullopt);
 }
 
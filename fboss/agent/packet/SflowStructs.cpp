@@ -19,7 +19,13 @@ namespace sflow {
 
 void serializeIP(RWPrivateCursor* cursor, folly::IPAddress ip) {
   // We first push the address type
-  cursor->writeBE<uint32_t>(static_cast<uint32_t>(AddressType::IP_V6));
+  auto type = AddressType::UNKNOWN;
+  if (ip.isV4()) {
+    type = AddressType::IP_V4;
+  } else if (ip.isV6()) {
+    type = AddressType::IP_V6;
+  }
+  cursor->writeBE<uint32_t>(static_cast<uint32_t>(type));
   // then push the address in bytes
   cursor->push(ip.bytes(), ip.byteCount());
 }
@@ -32,6 +38,11 @@ void serializeDataFormat(RWPrivateCursor* cursor, DataFormat fmt) {
   cursor->writeBE<DataFormat>(fmt);
 }
 
+SflowDataSource makeSflowDataSource(DataSourceType type, uint32_t index) {
+  // The compact format only has room for a 24 bit index
+  return (static_cast<uint32_t>(type) << 24) | (index & 0x00FFFFFF);
+}
+
 void serializeSflowDataSource(RWPrivateCursor* cursor, SflowDataSource src) {
   cursor->writeBE<SflowDataSource>(src);
 }
@@ -109,7 +120,7 @@ void SampleDatagramV5::serialize(RWPrivateCursor* cursor) const {
 }
 
 uint32_t SampleDatagramV5::size(const uint32_t recordsSize) const {
-  return this->agentAddress.byteCount() + 4 /* subAgentID */ +
+  return sizeIP(this->agentAddress) + 4 /* subAgentID */ +
       4 /*sequenceNumber */ + 4 /*uptime*/
       + 4 /*samplesCnt */ + recordsSize;
 }
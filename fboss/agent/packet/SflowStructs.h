@@ -32,7 +32,7 @@ using byte = uint8_t;
 enum struct AddressType : uint32_t { UNKNOWN = 0, IP_V4 = 1, IP_V6 = 2 };
 
 void serializeIP(folly::io::RWPrivateCursor* cursor, folly::IPAddress ip);
-uint32_t sizeIP(folly::IPAddress ip);
+uint32_t sizeIP(folly::IPAddress const& ip);
 
 /* Data Format */
 using DataFormat = uint32_t;
@@ -40,6 +40,13 @@ void serializeDataFormat(folly::io::RWPrivateCursor* cursor, DataFormat fmt);
 
 /* sFlowDataSource */
 using SflowDataSource = uint32_t;
+/* The type of a data source, held in its top 8 bits */
+enum struct DataSourceType : uint32_t {
+  IF_INDEX = 0,
+  SMON_VLAN_DATA_SOURCE = 1,
+  ENT_PHYSICAL_ENTRY = 2
+};
+SflowDataSource makeSflowDataSource(DataSourceType type, uint32_t index);
 void serializeSflowDataSource(
     folly::io::RWPrivateCursor* cursor,
     SflowDataSource src);
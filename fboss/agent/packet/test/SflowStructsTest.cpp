@@ -220,3 +220,49 @@ TEST(SflowStructsTest, Serialize) {
     EXPECT_EQ(b.at(i), data[i]);
   }
 }
+
+TEST(SflowStructsTest, SerializeIPv4AgentAddress) {
+  sflow::SampleDatagram datagram;
+  datagram.datagramV5.agentAddress = folly::IPAddress("10.0.0.1");
+  datagram.datagramV5.subAgentID = 0;
+  datagram.datagramV5.sequenceNumber = 0;
+  datagram.datagramV5.uptime = 0;
+  datagram.datagramV5.samplesCnt = 0;
+  datagram.datagramV5.samples = nullptr;
+
+  int bufSize = 1024;
+  std::vector<uint8_t> b(bufSize);
+  auto buf = folly::IOBuf::wrapBuffer(b.data(), bufSize);
+  folly::io::RWPrivateCursor cursor(buf.get());
+  datagram.serialize(&cursor);
+  size_t datagramSize = bufSize - cursor.length();
+  EXPECT_EQ(28, datagramSize);
+  EXPECT_EQ(datagramSize, datagram.size(0));
+
+  constexpr auto data = folly::make_array<uint8_t>(
+      0x00,
+      0x00,
+      0x00,
+      0x05, // version
+      0x00,
+      0x00,
+      0x00,
+      0x01, // ipv4 type = 1
+      0x0a,
+      0x00,
+      0x00,
+      0x01); // ipv4 addr
+  for (size_t i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(b.at(i), data[i]);
+  }
+}
+
+TEST(SflowStructsTest, DataSource) {
+  EXPECT_EQ(
+      0x00000005,
+      sflow::makeSflowDataSource(sflow::DataSourceType::IF_INDEX, 5));
+  EXPECT_EQ(
+      0x02000007,
+      sflow::makeSflowDataSource(
+          sflow::DataSourceType::ENT_PHYSICAL_ENTRY, 7));
+}
@@ -13,7 +13,9 @@
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/agent/state/LabelForwardingAction.h"
+#include "fboss/lib/Interner.h"
 
+#include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
 #include <gflags/gflags.h>
 #include <numeric>
@@ -62,13 +64,44 @@ std::vector<NextHopThrift> fromRouteNextHopSet(RouteNextHopSet const& nhs) {
 
 } // namespace util
 
+namespace {
+struct NextHopSetHash {
+  size_t operator()(const RouteNextHopEntry::NextHopSet& nhops) const {
+    size_t hash = nhops.size();
+    for (const auto& nhop : nhops) {
+      uint32_t intf =
+          nhop.isResolved() ? static_cast<uint32_t>(nhop.intf()) : 0;
+      hash = folly::hash::hash_combine(hash, nhop.addr(), intf, nhop.weight());
+    }
+    return hash;
+  }
+};
+} // namespace
+
 RouteNextHopEntry::RouteNextHopEntry(NextHopSet nhopSet, AdminDistance distance)
-    : adminDistance_(distance),
-      action_(Action::NEXTHOPS),
-      nhopSet_(std::move(nhopSet)) {
-  if (nhopSet_.size() == 0) {
+    : adminDistance_(distance), action_(Action::NEXTHOPS) {
+  if (nhopSet.size() == 0) {
     throw FbossError("Empty nexthop set is passed to the RouteNextHopEntry");
   }
+  nhopSet_ = internNextHopSet(std::move(nhopSet));
+}
+
+RouteNextHopEntry::RouteNextHopEntry(NextHop nhop, AdminDistance distance)
+    : adminDistance_(distance), action_(Action::NEXTHOPS) {
+  NextHopSet nhopSet;
+  nhopSet.emplace(std::move(nhop));
+  nhopSet_ = internNextHopSet(std::move(nhopSet));
+}
+
+RouteNextHopEntry::NextHopSetPtr RouteNextHopEntry::internNextHopSet(
+    NextHopSet nhopSet) {
+  return Interner<NextHopSet, NextHopSetHash>::get()->intern(
+      std::move(nhopSet));
+}
+
+const RouteNextHopEntry::NextHopSetPtr& RouteNextHopEntry::emptyNextHopSet() {
+  static const NextHopSetPtr kEmpty = internNextHopSet(NextHopSet());
+  return kEmpty;
 }
 
 NextHopWeight RouteNextHopEntry::getTotalWeight() const {
@@ -97,9 +130,10 @@ std::string RouteNextHopEntry::str() const {
 }
 
 bool operator==(const RouteNextHopEntry& a, const RouteNextHopEntry& b) {
+  // Interned next hop sets are equal iff they are the same object
   return (
       a.getAction() == b.getAction() and
-      a.getNextHopSet() == b.getNextHopSet() and
+      a.getInternedNextHopSet() == b.getInternedNextHopSet() and
       a.getAdminDistance() == b.getAdminDistance());
 }
 
@@ -107,9 +141,11 @@ bool operator<(const RouteNextHopEntry& a, const RouteNextHopEntry& b) {
   if (a.getAdminDistance() != b.getAdminDistance()) {
     return a.getAdminDistance() < b.getAdminDistance();
   }
-  return (
-      (a.getAction() == b.getAction()) ? (a.getNextHopSet() < b.getNextHopSet())
-                                       : a.getAction() < b.getAction());
+  if (a.getAction() != b.getAction()) {
+    return a.getAction() < b.getAction();
+  }
+  return a.getInternedNextHopSet() != b.getInternedNextHopSet() &&
+      a.getNextHopSet() < b.getNextHopSet();
 }
 
 // Methods for RouteNextHopEntry
@@ -148,7 +184,7 @@ folly::dynamic RouteNextHopEntry::toFollyDynamic() const {
   folly::dynamic entry = folly::dynamic::object;
   entry[kAction] = forwardActionStr(action_);
   folly::dynamic nhops = folly::dynamic::array;
-  for (const auto& nhop : nhopSet_) {
+  for (const auto& nhop : getNextHopSet()) {
     nhops.push_back(nhop.toFollyDynamic());
   }
   entry[kNexthops] = std::move(nhops);
@@ -165,9 +201,11 @@ RouteNextHopEntry RouteNextHopEntry::fromFollyDynamic(
       : AdminDistance(entryJson[kAdminDistance].asInt());
   RouteNextHopEntry entry(Action::DROP, adminDistance);
   entry.action_ = action;
+  NextHopSet nhopSet;
   for (const auto& nhop : entryJson[kNexthops]) {
-    entry.nhopSet_.insert(util::nextHopFromFollyDynamic(nhop));
+    nhopSet.insert(util::nextHopFromFollyDynamic(nhop));
   }
+  entry.nhopSet_ = internNextHopSet(std::move(nhopSet));
   return entry;
 }
 
@@ -194,7 +232,7 @@ bool RouteNextHopEntry::isValid(bool forMplsRoute) const {
   bool valid = true;
   if (!forMplsRoute) {
     /* for ip2mpls routes, next hop label forwarding action must be push */
-    for (const auto& nexthop : nhopSet_) {
+    for (const auto& nexthop : getNextHopSet()) {
       if (action_ != Action::NEXTHOPS) {
         continue;
       }
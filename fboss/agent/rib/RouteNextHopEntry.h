@@ -13,6 +13,8 @@
 
 #include <folly/dynamic.h>
 
+#include <memory>
+
 #include "fboss/agent/rib/RouteNextHop.h"
 #include "fboss/agent/rib/RouteTypes.h"
 
@@ -34,18 +36,20 @@ class RouteNextHopEntry {
  public:
   using Action = RouteForwardAction;
   using NextHopSet = boost::container::flat_set<NextHop>;
+  /*
+   * Next hop sets are interned, so routes with the same next hops share a
+   * single immutable copy, and equal sets have equal pointers.
+   */
+  using NextHopSetPtr = std::shared_ptr<const NextHopSet>;
 
   RouteNextHopEntry(Action action, AdminDistance distance)
-      : adminDistance_(distance), action_(action) {
+      : adminDistance_(distance), action_(action), nhopSet_(emptyNextHopSet()) {
     CHECK_NE(action_, Action::NEXTHOPS);
   }
 
   RouteNextHopEntry(NextHopSet nhopSet, AdminDistance distance);
 
-  RouteNextHopEntry(NextHop nhop, AdminDistance distance)
-      : adminDistance_(distance), action_(Action::NEXTHOPS) {
-    nhopSet_.emplace(std::move(nhop));
-  }
+  RouteNextHopEntry(NextHop nhop, AdminDistance distance);
 
   AdminDistance getAdminDistance() const {
     return adminDistance_;
@@ -56,9 +60,15 @@ class RouteNextHopEntry {
   }
 
   const NextHopSet& getNextHopSet() const {
+    return *nhopSet_;
+  }
+
+  const NextHopSetPtr& getInternedNextHopSet() const {
     return nhopSet_;
   }
 
+  static NextHopSetPtr internNextHopSet(NextHopSet nhopSet);
+
   // Get the sum of the weights of all the nexthops in the entry
   NextHopWeight getTotalWeight() const;
 
@@ -87,7 +97,7 @@ class RouteNextHopEntry {
 
   // Reset the NextHopSet
   void reset() {
-    nhopSet_.clear();
+    nhopSet_ = emptyNextHopSet();
     action_ = Action::DROP;
   }
 
@@ -105,9 +115,11 @@ class RouteNextHopEntry {
       const cfg::StaticRouteWithNextHops& route);
 
  private:
+  static const NextHopSetPtr& emptyNextHopSet();
+
   AdminDistance adminDistance_;
   Action action_{Action::DROP};
-  NextHopSet nhopSet_;
+  NextHopSetPtr nhopSet_;
 };
 
 /**
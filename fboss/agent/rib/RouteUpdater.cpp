@@ -10,6 +10,7 @@
 
 #include "RouteUpdater.h"
 
+#include <algorithm>
 #include <numeric>
 
 #include <boost/container/flat_map.hpp>
@@ -41,7 +42,7 @@ RouteUpdater::RouteUpdater(
     : v4Routes_(v4Routes), v6Routes_(v6Routes) {}
 
 template <typename AddressT>
-void RouteUpdater::addRouteImpl(
+bool RouteUpdater::addRouteImpl(
     const Prefix<AddressT>& prefix,
     NetworkToRouteMap<AddressT>* routes,
     ClientID clientID,
@@ -51,33 +52,34 @@ void RouteUpdater::addRouteImpl(
   if (it != routes->end()) {
     Route<AddressT>* route = &(it->value());
     if (route->has(clientID, entry)) {
-      return;
+      return false;
     }
 
     route->update(clientID, entry);
-    return;
+    return true;
   }
 
   CHECK(it == routes->end());
   routes->insert(
       prefix.network, prefix.mask, Route<AddressT>(prefix, clientID, entry));
+  return true;
 }
 
-void RouteUpdater::addRoute(
+bool RouteUpdater::addRoute(
     const folly::IPAddress& network,
     uint8_t mask,
     ClientID clientID,
     RouteNextHopEntry entry) {
   if (network.isV4()) {
     PrefixV4 prefix{network.asV4().mask(mask), mask};
-    addRouteImpl(prefix, v4Routes_, clientID, std::move(entry));
+    return addRouteImpl(prefix, v4Routes_, clientID, std::move(entry));
   } else {
     PrefixV6 prefix{network.asV6().mask(mask), mask};
     if (prefix.network.isLinkLocal()) {
       XLOG(DBG2) << "Ignoring v6 link-local interface route: " << prefix.str();
-      return;
+      return false;
     }
-    addRouteImpl(prefix, v6Routes_, clientID, std::move(entry));
+    return addRouteImpl(prefix, v6Routes_, clientID, std::move(entry));
   }
 }
 
@@ -108,7 +110,7 @@ void RouteUpdater::delLinkLocalRoutes() {
 }
 
 template <typename AddressT>
-void RouteUpdater::delRouteImpl(
+bool RouteUpdater::delRouteImpl(
     const Prefix<AddressT>& prefix,
     NetworkToRouteMap<AddressT>* routes,
     ClientID clientID) {
@@ -116,10 +118,13 @@ void RouteUpdater::delRouteImpl(
   if (it == routes->end()) {
     XLOG(DBG3) << "Failed to delete route: " << prefix.str()
                << " does not exist";
-    return;
+    return false;
   }
 
   Route<AddressT>& route = it->value();
+  if (!route.getEntryForClient(clientID)) {
+    return false;
+  }
   route.delEntryForClient(clientID);
 
   XLOG(DBG3) << "Deleted next-hops for prefix " << prefix.str()
@@ -129,31 +134,39 @@ void RouteUpdater::delRouteImpl(
     XLOG(DBG3) << "...and then deleted route " << route.str();
     routes->erase(it);
   }
+  return true;
 }
 
-void RouteUpdater::delRoute(
+bool RouteUpdater::delRoute(
     const folly::IPAddress& network,
     uint8_t mask,
     ClientID clientID) {
   if (network.isV4()) {
     PrefixV4 prefix{network.asV4().mask(mask), mask};
-    delRouteImpl(prefix, v4Routes_, clientID);
+    return delRouteImpl(prefix, v4Routes_, clientID);
   } else {
     CHECK(network.isV6());
     PrefixV6 prefix{network.asV6().mask(mask), mask};
-    delRouteImpl(prefix, v6Routes_, clientID);
+    return delRouteImpl(prefix, v6Routes_, clientID);
   }
 }
 
 template <typename AddressT>
-void RouteUpdater::removeAllRoutesFromClientImpl(
+size_t RouteUpdater::removeAllRoutesFromClientImpl(
     NetworkToRouteMap<AddressT>* routes,
-    ClientID clientID) {
+    ClientID clientID,
+    const std::vector<Prefix<AddressT>>& keep) {
   std::vector<typename NetworkToRouteMap<AddressT>::Iterator> toDelete;
+  size_t removed = 0;
 
   for (auto it = routes->begin(); it != routes->end(); ++it) {
     auto& route = it->value();
+    if (!route.getEntryForClient(clientID) ||
+        std::binary_search(keep.begin(), keep.end(), route.prefix())) {
+      continue;
+    }
     route.delEntryForClient(clientID);
+    ++removed;
     if (route.hasNoEntry()) {
       // The nexthops we removed was the only one.  Delete the route.
       toDelete.push_back(it);
@@ -164,11 +177,23 @@ void RouteUpdater::removeAllRoutesFromClientImpl(
   for (auto it : toDelete) {
     routes->erase(it);
   }
+  return removed;
 }
 
 void RouteUpdater::removeAllRoutesForClient(ClientID clientID) {
-  removeAllRoutesFromClientImpl<IPAddressV4>(v4Routes_, clientID);
-  removeAllRoutesFromClientImpl<IPAddressV6>(v6Routes_, clientID);
+  removeAllRoutesFromClientImpl<IPAddressV4>(v4Routes_, clientID, {});
+  removeAllRoutesFromClientImpl<IPAddressV6>(v6Routes_, clientID, {});
+}
+
+std::pair<size_t, size_t> RouteUpdater::removeAllRoutesForClientExcept(
+    ClientID clientID,
+    const std::vector<PrefixV4>& keepV4,
+    const std::vector<PrefixV6>& keepV6) {
+  DCHECK(std::is_sorted(keepV4.begin(), keepV4.end()));
+  DCHECK(std::is_sorted(keepV6.begin(), keepV6.end()));
+  return std::make_pair(
+      removeAllRoutesFromClientImpl<IPAddressV4>(v4Routes_, clientID, keepV4),
+      removeAllRoutesFromClientImpl<IPAddressV6>(v6Routes_, clientID, keepV6));
 }
 
 // Some helper functions for recursive weight resolution
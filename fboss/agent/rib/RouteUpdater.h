@@ -20,6 +20,9 @@
 
 #include <folly/IPAddress.h>
 
+#include <utility>
+#include <vector>
+
 namespace facebook::fboss::rib {
 
 /**
@@ -52,7 +55,8 @@ class RouteUpdater {
       IPv4NetworkToRouteMap* v4Routes,
       IPv6NetworkToRouteMap* v6Routes);
 
-  void addRoute(
+  // Returns false if the client already had this exact entry for the prefix
+  bool addRoute(
       const folly::IPAddress& network,
       uint8_t mask,
       ClientID clientID,
@@ -65,10 +69,22 @@ class RouteUpdater {
       InterfaceID interface);
 
   // TODO(samank): make del vs remove consistent
-  void
+  // Returns false if the client had no entry for the prefix
+  bool
   delRoute(const folly::IPAddress& network, uint8_t mask, ClientID clientID);
   void delLinkLocalRoutes();
   void removeAllRoutesForClient(ClientID clientID);
+  /*
+   * Remove the client's entries from all of its routes except those whose
+   * prefix is in keepV4/keepV6, which must be sorted. This lets a client's
+   * route set be synced by diffing, instead of withdrawing every route and
+   * adding it back. Returns the number of v4 and v6 routes the client was
+   * removed from.
+   */
+  std::pair<size_t, size_t> removeAllRoutesForClientExcept(
+      ClientID clientID,
+      const std::vector<PrefixV4>& keepV4,
+      const std::vector<PrefixV6>& keepV6);
 
   void updateDone();
 
@@ -82,20 +98,21 @@ class RouteUpdater {
 
   // TODO(samank): make these static
   template <typename AddressT>
-  void addRouteImpl(
+  bool addRouteImpl(
       const Prefix<AddressT>& prefix,
       NetworkToRouteMap<AddressT>* routes,
       ClientID clientID,
       RouteNextHopEntry entry);
   template <typename AddressT>
-  void delRouteImpl(
+  bool delRouteImpl(
       const Prefix<AddressT>& prefix,
       NetworkToRouteMap<AddressT>* routes,
       ClientID clientID);
   template <typename AddressT>
-  void removeAllRoutesFromClientImpl(
+  size_t removeAllRoutesFromClientImpl(
       NetworkToRouteMap<AddressT>* routes,
-      ClientID clientID);
+      ClientID clientID,
+      const std::vector<Prefix<AddressT>>& keep);
   template <typename AddressT>
   void updateDoneImpl(NetworkToRouteMap<AddressT>* routes);
 
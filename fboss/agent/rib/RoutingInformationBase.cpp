@@ -17,6 +17,7 @@
 #include "fboss/agent/rib/RouteNextHopEntry.h"
 #include "fboss/agent/rib/RouteUpdater.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -127,8 +128,31 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
   RouteUpdater updater(
       &(it->second.v4NetworkToRoute), &(it->second.v6NetworkToRoute));
 
+  bool ribChanged = false;
   if (resetClientsRoutes) {
-    updater.removeAllRoutesForClient(clientID);
+    // Only withdraw the prefixes the client no longer has. The ones it still
+    // has are updated in place below, and left alone if unchanged, so a
+    // client resync does not churn its whole route set through resolution,
+    // the FIB and the hardware.
+    std::vector<PrefixV4> syncedV4;
+    std::vector<PrefixV6> syncedV6;
+    for (const auto& route : toAdd) {
+      auto network = facebook::network::toIPAddress(route.dest.ip);
+      auto mask = static_cast<uint8_t>(route.dest.prefixLength);
+      if (network.isV4()) {
+        syncedV4.push_back(PrefixV4{network.asV4().mask(mask), mask});
+      } else {
+        syncedV6.push_back(PrefixV6{network.asV6().mask(mask), mask});
+      }
+    }
+    std::sort(syncedV4.begin(), syncedV4.end());
+    std::sort(syncedV6.begin(), syncedV6.end());
+
+    auto removed =
+        updater.removeAllRoutesForClientExcept(clientID, syncedV4, syncedV6);
+    stats.v4RoutesDeleted += removed.first;
+    stats.v6RoutesDeleted += removed.second;
+    ribChanged = removed.first + removed.second > 0;
   }
 
   for (const auto& route : toAdd) {
@@ -141,11 +165,15 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
       ++stats.v6RoutesAdded;
     }
 
-    updater.addRoute(
-        network,
-        mask,
-        clientID,
-        RouteNextHopEntry::from(route, adminDistanceFromClientID));
+    if (updater.addRoute(
+            network,
+            mask,
+            clientID,
+            RouteNextHopEntry::from(route, adminDistanceFromClientID))) {
+      ribChanged = true;
+    } else {
+      ++stats.routesUnchanged;
+    }
   }
 
   for (const auto& prefix : toDelete) {
@@ -158,16 +186,28 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
       ++stats.v6RoutesDeleted;
     }
 
-    updater.delRoute(network, mask, clientID);
+    ribChanged |= updater.delRoute(network, mask, clientID);
   }
 
-  updater.updateDone();
+  if (!ribChanged) {
+    // Resolution and the FIB only depend on the RIB, so they would come out
+    // exactly as they are now.
+    return stats;
+  }
 
-  fibUpdateCallback(
-      routerID,
-      it->second.v4NetworkToRoute,
-      it->second.v6NetworkToRoute,
-      cookie);
+  {
+    Timer resolutionTimer(&stats.resolutionDuration);
+    updater.updateDone();
+  }
+
+  {
+    Timer fibUpdateTimer(&stats.fibUpdateDuration);
+    fibUpdateCallback(
+        routerID,
+        it->second.v4NetworkToRoute,
+        it->second.v6NetworkToRoute,
+        cookie);
+  }
 
   return stats;
 }
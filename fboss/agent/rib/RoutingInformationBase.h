@@ -36,7 +36,12 @@ class RoutingInformationBase {
     std::size_t v4RoutesDeleted{0};
     std::size_t v6RoutesAdded{0};
     std::size_t v6RoutesDeleted{0};
+    // Routes in toAdd the client already had with the same next hops
+    std::size_t routesUnchanged{0};
     std::chrono::microseconds duration{0};
+    // The parts of duration spent resolving routes and in fibUpdateCallback
+    std::chrono::microseconds resolutionDuration{0};
+    std::chrono::microseconds fibUpdateDuration{0};
   };
 
   /*
@@ -46,6 +51,11 @@ class RoutingInformationBase {
    * 2. Triggers recursive (IP) resolution.
    * 3. Updates the FIB synchronously.
    *
+   * If `resetClientsRoutes` is set, `toAdd` becomes the client's complete
+   * route set. It is diffed against the routes the client already has, so
+   * only prefixes that are withdrawn, new or changed modify the RIB. Steps 2
+   * and 3 are skipped altogether when the update does not change the RIB.
+   *
    * If a UnicastRoute does not specify its admin distance, then we derive its
    * admin distance via its clientID.  This is accomplished by a mapping from
    * client IDs to admin distances provided in configuration. Unfortunately,
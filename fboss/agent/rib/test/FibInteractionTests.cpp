@@ -620,3 +620,71 @@ TEST(ForwardingInformationBaseUpdater, Deduplication) {
   ASSERT_TRUE(route3);
   EXPECT_NE(route, route3);
 }
+
+TEST(Rib, IncrementalSync) {
+  using namespace facebook::fboss;
+
+  const RouterID vrfZero{0};
+  RoutePrefixV6 kept{folly::IPAddressV6("2a03:2880:ff:1e::"), 64};
+  RoutePrefixV6 withdrawn{folly::IPAddressV6("2a03:2880:ff:1f::"), 64};
+
+  cfg::SwitchConfig config;
+  config.vlans_ref()->resize(1);
+  *config.vlans[0].id_ref() = 1;
+  config.interfaces_ref()->resize(1);
+  *config.interfaces[0].intfID_ref() = 1;
+  *config.interfaces[0].vlanID_ref() = 1;
+  *config.interfaces[0].routerID_ref() = vrfZero;
+  config.interfaces_ref()[0].__isset.mac = true;
+  config.interfaces_ref()[0].mac_ref().value_unchecked() = "00:00:00:00:00:11";
+  config.interfaces_ref()[0].ipAddresses_ref()->resize(1);
+  config.interfaces[0].ipAddresses_ref()[0] =
+      "2401:db00:e003:9100:1006::2c/127";
+
+  auto testHandle =
+      createTestHandle(&config, SwitchFlags::ENABLE_STANDALONE_RIB);
+  auto sw = testHandle->getSw();
+
+  auto nextHop = folly::IPAddress("2401:db00:e003:9100:1006::2d");
+  std::vector<UnicastRoute> routesToAdd;
+  routesToAdd.push_back(createUnicastRoute(kept.network, kept.mask, nextHop));
+  routesToAdd.push_back(
+      createUnicastRoute(withdrawn.network, withdrawn.mask, nextHop));
+
+  auto sync = [&]() {
+    return sw->getRib()->update(
+        vrfZero,
+        ClientID(0),
+        AdminDistance::EBGP,
+        routesToAdd,
+        {} /* prefixes to delete */,
+        true /* sync */,
+        "incremental sync unit test",
+        &dynamicFibUpdate,
+        static_cast<void*>(sw));
+  };
+  auto fibV6 = [&]() {
+    return sw->getState()->getFibs()->getFibContainer(vrfZero)->getFibV6();
+  };
+
+  auto stats = sync();
+  EXPECT_EQ(0, stats.routesUnchanged);
+  auto fib = fibV6();
+  auto route = fib->exactMatch(kept);
+  ASSERT_TRUE(route);
+  ASSERT_TRUE(fib->exactMatch(withdrawn));
+
+  // Re-syncing the same routes leaves the RIB, and hence the FIB, untouched
+  stats = sync();
+  EXPECT_EQ(2, stats.routesUnchanged);
+  EXPECT_EQ(0, stats.v6RoutesDeleted);
+  EXPECT_EQ(fib, fibV6());
+
+  // Only the prefix missing from the sync is withdrawn
+  routesToAdd.pop_back();
+  stats = sync();
+  EXPECT_EQ(1, stats.routesUnchanged);
+  EXPECT_EQ(1, stats.v6RoutesDeleted);
+  EXPECT_FALSE(fibV6()->exactMatch(withdrawn));
+  EXPECT_EQ(route, fibV6()->exactMatch(kept));
+}
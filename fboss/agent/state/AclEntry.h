@@ -85,6 +85,10 @@ struct AclEntryFields {
   static const uint8_t kMaxIcmpType = 0xFF;
   static const uint8_t kMaxIcmpCode = 0xFF;
   static const uint16_t kMaxL4Port = 65535;
+  // ACL priorities must stay below this: hardware that orders entries the
+  // other way round programs kMaxPriority - priority, which must not be
+  // negative.
+  static constexpr int kMaxPriority = 1000000;
 
   explicit AclEntryFields(int priority, const std::string& name)
       : priority(priority), name(name) {}
@@ -142,7 +146,15 @@ class AclEntry : public NodeBaseT<AclEntry, AclEntryFields> {
 
   bool operator==(const AclEntry& acl) const {
     return getFields()->priority == acl.getPriority() &&
-        getFields()->name == acl.getID() &&
+        isSameExceptPriority(acl);
+  }
+
+  /*
+   * Compare everything but the priority. An ACL that only had its priority
+   * changed can be moved in hardware instead of being reprogrammed.
+   */
+  bool isSameExceptPriority(const AclEntry& acl) const {
+    return getFields()->name == acl.getID() &&
         getFields()->actionType == acl.getActionType() &&
         getFields()->aclAction == acl.getAclAction() &&
         getFields()->srcIp == acl.getSrcIp() &&
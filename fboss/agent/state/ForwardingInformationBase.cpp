@@ -30,6 +30,34 @@ template <typename AddressT>
 std::shared_ptr<Route<AddressT>>
 ForwardingInformationBase<AddressT>::longestMatch(
     const AddressT& address) const {
+  if (!lpmIndex_) {
+    // Not published, still being modified
+    return longestMatchScan(address);
+  }
+  auto citr = lpmIndex_->longestMatch(address, address.bitCount());
+  return citr != lpmIndex_->end() ? citr->value() : nullptr;
+}
+
+template <typename AddressT>
+void ForwardingInformationBase<AddressT>::publish() {
+  if (this->isPublished()) {
+    return;
+  }
+  auto index = std::make_unique<LpmIndex>();
+  for (const auto& prefixAndRoute : Base::getAllNodes()) {
+    index->insert(
+        prefixAndRoute.first.network,
+        prefixAndRoute.first.mask,
+        prefixAndRoute.second);
+  }
+  lpmIndex_ = std::move(index);
+  Base::publish();
+}
+
+template <typename AddressT>
+std::shared_ptr<Route<AddressT>>
+ForwardingInformationBase<AddressT>::longestMatchScan(
+    const AddressT& address) const {
   std::shared_ptr<Route<AddressT>> longestMatchRoute = nullptr;
   // longestCommonLength must be wider than int8_t because it needs to hold
   // values in the range [-1, 128].
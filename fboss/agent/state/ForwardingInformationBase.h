@@ -12,10 +12,13 @@
 #include "fboss/agent/state/NodeMap.h"
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/RouteTypes.h"
+#include "fboss/lib/RadixTree.h"
 
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 
+#include <memory>
+
 namespace facebook::fboss {
 
 template <typename AddressT>
@@ -38,12 +41,32 @@ class ForwardingInformationBase
   std::shared_ptr<Route<AddressT>> exactMatch(
       const RoutePrefix<AddressT>& prefix) const;
 
+  /*
+   * Once the FIB is published, lookups go through a radix tree built when it
+   * was published, so they cost O(prefix length) rather than a scan of all
+   * routes. Every FIB generation gets its own tree.
+   */
   std::shared_ptr<Route<AddressT>> longestMatch(const AddressT& address) const;
 
+  /*
+   * Build the radix tree here, on the thread publishing the state, so that
+   * lookups on the packet RX path never have to.
+   */
+  void publish() override;
+
  private:
+  using LpmIndex =
+      facebook::network::RadixTree<AddressT, std::shared_ptr<Route<AddressT>>>;
+
+  std::shared_ptr<Route<AddressT>> longestMatchScan(
+      const AddressT& address) const;
+
   // Inherit the constructors required for clone()
   using Base::Base;
   friend class CloneAllocator;
+
+  // Set when published, immutable from then on
+  std::unique_ptr<const LpmIndex> lpmIndex_;
 };
 
 using ForwardingInformationBaseV4 =
@@ -22,9 +22,39 @@ InterfaceMap::InterfaceMap() {}
 
 InterfaceMap::~InterfaceMap() {}
 
+void InterfaceMap::publish() {
+  if (isPublished()) {
+    return;
+  }
+  auto index = std::make_unique<AddressIndex>();
+  size_t order = 0;
+  for (const auto& intf : *this) {
+    index->vlans.emplace(intf->getVlanID(), intf);
+    auto& routerIndex = index->routers[intf->getRouterID()];
+    for (const auto& [addr, mask] : intf->getAddresses()) {
+      routerIndex.addrs.emplace(addr, intf);
+      auto& subnets =
+          addr.isV4() ? routerIndex.v4Subnets : routerIndex.v6Subnets;
+      subnets[mask].emplace(
+          addr.mask(mask),
+          SubnetEntry{order++, IntfAddrToReach(intf.get(), &addr, mask)});
+    }
+  }
+  addressIndex_ = std::move(index);
+  NodeMapT::publish();
+}
+
 std::shared_ptr<Interface> InterfaceMap::getInterfaceIf(
     RouterID router,
     const IPAddress& ip) const {
+  if (auto index = addressIndex_.get()) {
+    auto routerItr = index->routers.find(router);
+    if (routerItr == index->routers.end()) {
+      return nullptr;
+    }
+    auto itr = routerItr->second.addrs.find(ip);
+    return itr == routerItr->second.addrs.end() ? nullptr : itr->second;
+  }
   for (auto itr = begin(); itr != end(); ++itr) {
     if ((*itr)->getRouterID() == router && (*itr)->hasAddress(ip)) {
       return *itr;
@@ -36,6 +66,16 @@ std::shared_ptr<Interface> InterfaceMap::getInterfaceIf(
 const std::shared_ptr<Interface>& InterfaceMap::getInterface(
     RouterID router,
     const IPAddress& ip) const {
+  if (auto index = addressIndex_.get()) {
+    auto routerItr = index->routers.find(router);
+    if (routerItr != index->routers.end()) {
+      auto itr = routerItr->second.addrs.find(ip);
+      if (itr != routerItr->second.addrs.end()) {
+        return itr->second;
+      }
+    }
+    throw FbossError("No interface with ip : ", ip);
+  }
   for (auto itr = begin(); itr != end(); ++itr) {
     if ((*itr)->getRouterID() == router && (*itr)->hasAddress(ip)) {
       return *itr;
@@ -46,6 +86,10 @@ const std::shared_ptr<Interface>& InterfaceMap::getInterface(
 
 std::shared_ptr<Interface> InterfaceMap::getInterfaceInVlanIf(
     VlanID vlan) const {
+  if (auto index = addressIndex_.get()) {
+    auto itr = index->vlans.find(vlan);
+    return itr == index->vlans.end() ? nullptr : itr->second;
+  }
   for (auto itr = begin(); itr != end(); ++itr) {
     if ((*itr)->getVlanID() == vlan) {
       return *itr;
@@ -66,6 +110,22 @@ const std::shared_ptr<Interface> InterfaceMap::getInterfaceInVlan(
 InterfaceMap::IntfAddrToReach InterfaceMap::getIntfAddrToReach(
     RouterID router,
     const folly::IPAddress& dest) const {
+  if (auto index = addressIndex_.get()) {
+    auto routerItr = index->routers.find(router);
+    if (routerItr == index->routers.end()) {
+      return IntfAddrToReach(nullptr, nullptr, 0);
+    }
+    const auto& subnets = dest.isV4() ? routerItr->second.v4Subnets
+                                      : routerItr->second.v6Subnets;
+    const SubnetEntry* found = nullptr;
+    for (const auto& [mask, masked] : subnets) {
+      auto itr = masked.find(dest.mask(mask));
+      if (itr != masked.end() && (!found || itr->second.order < found->order)) {
+        found = &itr->second;
+      }
+    }
+    return found ? found->reach : IntfAddrToReach(nullptr, nullptr, 0);
+  }
   for (auto iter = begin(); iter != end(); iter++) {
     const auto& intf = *iter;
     if (intf->getRouterID() == router) {
@@ -8,7 +8,10 @@
  *
  */
 #pragma once
+#include <boost/container/flat_map.hpp>
 #include <folly/IPAddress.h>
+#include <folly/container/F14Map.h>
+#include <memory>
 #include <vector>
 #include "fboss/agent/state/NodeMap.h"
 #include "fboss/agent/types.h"
@@ -19,6 +22,10 @@ typedef NodeMapTraits<InterfaceID, Interface> InterfaceMapTraits;
 
 /*
  * A container for the set of INTERFACEs.
+ *
+ * Once published, lookups by address, VLAN and subnet go through hash
+ * indices built when the map was published, instead of scanning all
+ * interfaces.
  */
 class InterfaceMap : public NodeMapT<InterfaceMap, InterfaceMapTraits> {
  public:
@@ -100,6 +107,12 @@ class InterfaceMap : public NodeMapT<InterfaceMap, InterfaceMapTraits> {
 
   void addInterface(const std::shared_ptr<Interface>& interface);
 
+  /*
+   * Build the lookup indices here, on the thread publishing the state, so
+   * that lookups on the packet RX path never have to.
+   */
+  void publish() override;
+
   /*
    * Serialize to a folly::dynamic object
    */
@@ -116,9 +129,31 @@ class InterfaceMap : public NodeMapT<InterfaceMap, InterfaceMapTraits> {
   }
 
  private:
+  struct SubnetEntry {
+    // Position in interface, then address, order. Lookups return the
+    // entry that a scan would have found first.
+    size_t order;
+    IntfAddrToReach reach;
+  };
+  // mask length -> masked subnet -> first address in that subnet
+  using SubnetIndex = boost::container::
+      flat_map<uint8_t, folly::F14FastMap<folly::IPAddress, SubnetEntry>>;
+  struct RouterIndex {
+    folly::F14FastMap<folly::IPAddress, std::shared_ptr<Interface>> addrs;
+    SubnetIndex v4Subnets;
+    SubnetIndex v6Subnets;
+  };
+  struct AddressIndex {
+    folly::F14FastMap<RouterID, RouterIndex> routers;
+    folly::F14FastMap<VlanID, std::shared_ptr<Interface>> vlans;
+  };
+
   // Inherit the constructors required for clone()
   using NodeMapT::NodeMapT;
   friend class CloneAllocator;
+
+  // Set when published, immutable from then on
+  std::unique_ptr<const AddressIndex> addressIndex_;
 };
 
 } // namespace facebook::fboss
@@ -48,7 +48,7 @@ class MacTable : public NodeMapT<MacTable, MacTableTraits> {
       PortDescriptor portDescr,
       std::optional<cfg::AclLookupClass> classID) {
     CHECK(!this->isPublished());
-    auto& nodes = this->writableNodes();
+    auto& nodes = this->writableNodes(mac);
     auto it = nodes.find(mac);
     if (it == nodes.end()) {
       throw FbossError("Mac entry for ", mac.toString(), " does not exist");
@@ -85,7 +85,7 @@ void NeighborTable<IPADDR, ENTRY, SUBCLASS>::updateEntry(
     InterfaceID intfID,
     std::optional<cfg::AclLookupClass> classID) {
   CHECK(!this->isPublished());
-  auto& nodes = this->writableNodes();
+  auto& nodes = this->writableNodes(ip);
   auto it = nodes.find(ip);
   if (it == nodes.end()) {
     throw FbossError("Neighbor entry for ", ip, " does not exist");
@@ -103,7 +103,7 @@ template <typename IPADDR, typename ENTRY, typename SUBCLASS>
 void NeighborTable<IPADDR, ENTRY, SUBCLASS>::updateEntry(
     AddressType ip,
     std::shared_ptr<ENTRY> newEntry) {
-  auto& nodes = this->writableNodes();
+  auto& nodes = this->writableNodes(ip);
   auto it = nodes.find(ip);
   if (it == nodes.end()) {
     throw FbossError("Neighbor entry for ", ip, " does not exist");
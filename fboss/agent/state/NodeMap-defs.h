@@ -16,6 +16,7 @@
 #include <folly/dynamic.h>
 #include <folly/json.h>
 
+#include <algorithm>
 #include <vector>
 
 #define FBOSS_INSTANTIATE_NODE_MAP(MapType, TraitsType) \
@@ -49,7 +50,7 @@ std::shared_ptr<typename TraitsT::Node> NodeMapT<MapTypeT, TraitsT>::getNodeIf(
 
 template <typename MapTypeT, typename TraitsT>
 void NodeMapT<MapTypeT, TraitsT>::addNode(const std::shared_ptr<Node>& node) {
-  auto& nodes = writableNodes();
+  auto& nodes = writableNodes(TraitsT::getKey(node));
   auto ret = nodes.insert(std::make_pair(TraitsT::getKey(node), node));
   if (!ret.second) {
     throw FbossError("duplicate node ID ", TraitsT::getKey(node));
@@ -59,18 +60,22 @@ void NodeMapT<MapTypeT, TraitsT>::addNode(const std::shared_ptr<Node>& node) {
 template <typename MapTypeT, typename TraitsT>
 void NodeMapT<MapTypeT, TraitsT>::updateNode(
     const std::shared_ptr<Node>& node) {
-  auto& nodes = writableNodes();
-  auto it = nodes.find(TraitsT::getKey(node));
-  if (it == nodes.end()) {
+  auto fields = this->writableFields();
+  auto it = fields->nodes.find(TraitsT::getKey(node));
+  if (it == fields->nodes.end()) {
     throw FbossError("node ID ", TraitsT::getKey(node), " does not exist");
   }
-  it->second = node;
+  // Re-setting the same node is common (e.g. route dedup), don't record it
+  if (it->second != node) {
+    fields->changes.record(it->first);
+    it->second = node;
+  }
 }
 
 template <typename MapTypeT, typename TraitsT>
 void NodeMapT<MapTypeT, TraitsT>::removeNode(
     const std::shared_ptr<Node>& node) {
-  auto& nodes = writableNodes();
+  auto& nodes = writableNodes(TraitsT::getKey(node));
   auto it = nodes.find(TraitsT::getKey(node));
   if (it == nodes.end()) {
     throw FbossError("node ID ", TraitsT::getKey(node), " does not exist");
@@ -91,7 +96,7 @@ std::shared_ptr<typename TraitsT::Node> NodeMapT<MapTypeT, TraitsT>::removeNode(
 template <typename MapTypeT, typename TraitsT>
 std::shared_ptr<typename TraitsT::Node>
 NodeMapT<MapTypeT, TraitsT>::removeNodeIf(const KeyType& key) {
-  auto& nodes = writableNodes();
+  auto& nodes = writableNodes(key);
   auto it = nodes.find(key);
   if (it == nodes.end()) {
     return nullptr;
@@ -101,6 +106,58 @@ NodeMapT<MapTypeT, TraitsT>::removeNodeIf(const KeyType& key) {
   return node;
 }
 
+namespace detail {
+template <typename KeyT>
+std::vector<KeyT> sortedUniqueKeys(std::vector<KeyT> keys) {
+  std::sort(keys.begin(), keys.end());
+  keys.erase(
+      std::unique(
+          keys.begin(),
+          keys.end(),
+          [](const KeyT& a, const KeyT& b) { return !(a < b) && !(b < a); }),
+      keys.end());
+  return keys;
+}
+} // namespace detail
+
+template <typename MapTypeT, typename TraitsT>
+std::shared_ptr<const std::vector<typename TraitsT::KeyType>>
+NodeMapT<MapTypeT, TraitsT>::getChangedKeysSince(const MapTypeT& oldMap) const {
+  const auto& changes = this->getFields()->changes;
+  if (!changes.tracked || changes.baseId != oldMap.getFields()->changes.id) {
+    return nullptr;
+  }
+  auto numChanges =
+      changes.sortedKeys ? changes.sortedKeys->size() : changes.keys.size();
+  // Past this point a lockstep walk over both maps is cheaper than looking
+  // up every changed key in both of them.
+  if (numChanges * 8 > std::max(size(), oldMap.getAllNodes().size())) {
+    return nullptr;
+  }
+  if (changes.sortedKeys) {
+    return changes.sortedKeys;
+  }
+  // Not published yet, sort a copy
+  return std::make_shared<const std::vector<KeyType>>(
+      detail::sortedUniqueKeys(changes.keys));
+}
+
+template <typename MapTypeT, typename TraitsT>
+void NodeMapT<MapTypeT, TraitsT>::publish() {
+  if (this->isPublished()) {
+    return;
+  }
+  // Sort the changed keys once, so that all deltas against the published map
+  // share them.
+  auto& changes = this->writableFields()->changes;
+  if (changes.tracked) {
+    changes.sortedKeys = std::make_shared<const std::vector<KeyType>>(
+        detail::sortedUniqueKeys(std::move(changes.keys)));
+    changes.keys.clear();
+  }
+  NodeBaseT<MapTypeT, NodeMapFields<TraitsT>>::publish();
+}
+
 template <typename MapTypeT, typename TraitsT>
 folly::dynamic NodeMapT<MapTypeT, TraitsT>::toFollyDynamic() const {
   folly::dynamic nodesJson = folly::dynamic::array;
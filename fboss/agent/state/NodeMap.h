@@ -14,8 +14,49 @@
 #include "fboss/agent/state/NodeBase.h"
 #include "fboss/agent/state/NodeMapIterator.h"
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 namespace facebook::fboss {
 
+/*
+ * NodeMapChangeLog records the keys added, updated or removed in a NodeMap
+ * since it was cloned. NodeMapDelta uses it to visit only those keys when
+ * comparing a map against the one it was cloned from, rather than walking
+ * both maps in lockstep.
+ *
+ * Every NodeMapFields instance gets a unique id, and a clone remembers the
+ * id of the fields it was copied from. Changes made through the raw
+ * container returned by writableNodes() can't be tracked, so they disable
+ * the log for the rest of the map's lifetime.
+ */
+template <typename KeyT>
+struct NodeMapChangeLog {
+  NodeMapChangeLog() {}
+  explicit NodeMapChangeLog(uint64_t baseId) : baseId(baseId), tracked(true) {}
+
+  static uint64_t nextId() {
+    static std::atomic<uint64_t> next{1};
+    return next++;
+  }
+
+  void record(const KeyT& key) {
+    if (tracked) {
+      keys.push_back(key);
+    }
+  }
+
+  uint64_t id{nextId()};
+  // Id of the fields this map was cloned from, 0 if it wasn't cloned
+  uint64_t baseId{0};
+  bool tracked{false};
+  // Keys as recorded, may contain duplicates
+  std::vector<KeyT> keys;
+  // Sorted, deduplicated keys. Set when the map is published.
+  std::shared_ptr<const std::vector<KeyT>> sortedKeys;
+};
+
 /*
  * NodeMapFields defines the fields contained inside a NodeMapT instantiation
  */
@@ -29,6 +70,9 @@ struct NodeMapFields {
 
   NodeMapFields() {}
   NodeMapFields(NodeContainer nodes) : nodes(std::move(nodes)) {}
+  // Used by clone(), changes are tracked relative to the fields cloned from
+  NodeMapFields(const NodeMapFields& other)
+      : nodes(other.nodes), extra(other.extra), changes(other.changes.id) {}
   NodeMapFields(const NodeMapFields& other, NodeContainer nodes)
       : nodes(std::move(nodes)), extra(other.extra) {}
 
@@ -42,6 +86,7 @@ struct NodeMapFields {
 
   NodeContainer nodes;
   ExtraFields extra;
+  NodeMapChangeLog<KeyType> changes;
 };
 
 struct NodeMapNoExtraFields {
@@ -100,7 +145,10 @@ class NodeMapT : public NodeBaseT<MapTypeT, NodeMapFields<TraitsT>> {
     return this->getFields()->nodes;
   }
   NodeContainer& writableNodes() {
-    return this->writableFields()->nodes;
+    auto fields = this->writableFields();
+    // We can't tell what the caller is going to change
+    fields->changes.tracked = false;
+    return fields->nodes;
   }
 
   const ExtraFields& getExtraFields() const {
@@ -134,6 +182,16 @@ class NodeMapT : public NodeBaseT<MapTypeT, NodeMapFields<TraitsT>> {
   std::shared_ptr<Node> removeNode(const KeyType& key);
   std::shared_ptr<Node> removeNodeIf(const KeyType& key);
 
+  /*
+   * If this map was cloned from oldMap, return the sorted keys whose nodes
+   * may differ between the two. Returns nullptr when the changes weren't
+   * tracked, or are too many for visiting them one by one to pay off.
+   */
+  std::shared_ptr<const std::vector<KeyType>> getChangedKeysSince(
+      const MapTypeT& oldMap) const;
+
+  void publish() override;
+
   /*
    * Serialize to folly::dynamic
    */
@@ -151,6 +209,17 @@ class NodeMapT : public NodeBaseT<MapTypeT, NodeMapFields<TraitsT>> {
    */
   static std::shared_ptr<MapTypeT> fromFollyDynamic(const folly::dynamic& json);
 
+ protected:
+  /*
+   * Writable container for changing the node for key only. Unlike
+   * writableNodes(), this keeps track of the change.
+   */
+  NodeContainer& writableNodes(const KeyType& key) {
+    auto fields = this->writableFields();
+    fields->changes.record(key);
+    return fields->nodes;
+  }
+
  private:
   // Inherit the constructor required for clone()
   using NodeBaseT<MapTypeT, NodeMapFields<TraitsT>>::NodeBaseT;
@@ -38,6 +38,45 @@ NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::Iterator(
   updateValue();
 }
 
+template <typename MAP, typename VALUE, typename MAPPOINTERTRAITS>
+NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::Iterator(
+    const MapType* oldMap,
+    const MapType* newMap,
+    std::shared_ptr<const KeyList> keys,
+    size_t keyIndex)
+    : oldIt_(oldMap->end()),
+      newIt_(newMap->end()),
+      oldMap_(oldMap),
+      newMap_(newMap),
+      keys_(std::move(keys)),
+      keyIndex_(keyIndex),
+      value_(nullNode_, nullNode_) {
+  advanceToChangedKey();
+}
+
+template <typename MAP, typename VALUE, typename MAPPOINTERTRAITS>
+void NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::
+    advanceToChangedKey() {
+  // A key may have been changed back to the node it had in the old map, so
+  // skip keys whose nodes are the same.
+  const auto& oldNodes = oldMap_->getAllNodes();
+  const auto& newNodes = newMap_->getAllNodes();
+  for (; keyIndex_ < keys_->size(); ++keyIndex_) {
+    const auto& key = (*keys_)[keyIndex_];
+    auto oldIter = oldNodes.find(key);
+    auto newIter = newNodes.find(key);
+    const auto& oldNode =
+        oldIter == oldNodes.end() ? nullNode_ : oldIter->second;
+    const auto& newNode =
+        newIter == newNodes.end() ? nullNode_ : newIter->second;
+    if (oldNode != newNode) {
+      value_.reset(oldNode, newNode);
+      return;
+    }
+  }
+  value_.reset(nullNode_, nullNode_);
+}
+
 template <typename MAP, typename VALUE, typename MAPPOINTERTRAITS>
 NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::Iterator()
     : oldIt_(),
@@ -73,6 +112,14 @@ void NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::updateValue() {
 
 template <typename MAP, typename VALUE, typename MAPPOINTERTRAITS>
 void NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::advance() {
+  if (keys_) {
+    // advance() shouldn't be called if we are already at the end
+    CHECK_LT(keyIndex_, keys_->size());
+    ++keyIndex_;
+    advanceToChangedKey();
+    return;
+  }
+
   // If we have already hit the end of one side, advance the other.
   // We are immediately done after this.
   if (oldIt_ == oldMap_->end()) {
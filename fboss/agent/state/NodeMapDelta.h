@@ -13,6 +13,7 @@
 #include <functional>
 #include <memory>
 #include <type_traits>
+#include <vector>
 
 #include <folly/functional/ApplyTuple.h>
 
@@ -49,12 +50,41 @@ class MapUniquePointerTraits {
     return map.get();
   }
 };
+/*
+ * ChangedKeysTraits looks up the keys changed between two maps, for maps that
+ * track them (see NodeMapChangeLog).
+ */
+template <typename MAP, typename = void>
+struct ChangedKeysTraits {
+  using KeyList = std::vector<int>;
+  static std::shared_ptr<const KeyList> get(const MAP*, const MAP*) {
+    return nullptr;
+  }
+};
+
+template <typename MAP>
+struct ChangedKeysTraits<
+    MAP,
+    std::void_t<decltype(std::declval<const MAP&>().getChangedKeysSince(
+        std::declval<const MAP&>()))>> {
+  using KeyList = std::vector<typename MAP::KeyType>;
+  static std::shared_ptr<const KeyList> get(
+      const MAP* oldMap,
+      const MAP* newMap) {
+    return newMap->getChangedKeysSince(*oldMap);
+  }
+};
+
 /*
  * NodeMapDelta contains code for examining the differences between two NodeMap
  * objects.
  *
  * The main function of this class is the Iterator that it provides.  This
  * allows caller to walk over the changed, added, and removed nodes.
+ *
+ * When the new map was cloned from the old one and tracked its changes, only
+ * the changed keys are visited, so the delta costs O(changes) rather than
+ * O(map size).
  */
 template <
     typename MAP,
@@ -65,10 +95,15 @@ class NodeMapDelta {
   using MapPointerType = typename MAPPOINTERTRAITS::MapPointerType;
   using RawConstPointerType = typename MAPPOINTERTRAITS::RawConstPointerType;
   using Node = typename MAP::Node;
+  using KeyList = typename ChangedKeysTraits<MAP>::KeyList;
   class Iterator;
 
   NodeMapDelta(MapPointerType&& oldMap, MapPointerType&& newMap)
-      : old_(std::move(oldMap)), new_(std::move(newMap)) {}
+      : old_(std::move(oldMap)), new_(std::move(newMap)) {
+    if (old_ && new_ && old_ != new_) {
+      changedKeys_ = ChangedKeysTraits<MAP>::get(getOld(), getNew());
+    }
+  }
 
   RawConstPointerType getOld() const {
     return MAPPOINTERTRAITS::getRawPointer(old_);
@@ -100,6 +135,8 @@ class NodeMapDelta {
    */
   MapPointerType old_;
   MapPointerType new_;
+  // Keys to visit, if the maps tracked their changes
+  std::shared_ptr<const KeyList> changedKeys_;
 };
 
 template <typename NODE>
@@ -156,6 +193,12 @@ class NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator {
       typename MapType::Iterator oldIt,
       const MapType* newMap,
       typename MapType::Iterator newIt);
+  // Iterate over the given changed keys only, starting at keyIndex
+  Iterator(
+      const MapType* oldMap,
+      const MapType* newMap,
+      std::shared_ptr<const KeyList> keys,
+      size_t keyIndex);
   Iterator();
 
   const value_type& operator*() const {
@@ -176,7 +219,8 @@ class NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator {
   }
 
   bool operator==(const Iterator& other) const {
-    return oldIt_ == other.oldIt_ && newIt_ == other.newIt_;
+    return oldIt_ == other.oldIt_ && newIt_ == other.newIt_ &&
+        keyIndex_ == other.keyIndex_;
   }
   bool operator!=(const Iterator& other) const {
     return !operator==(other);
@@ -188,11 +232,16 @@ class NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator {
 
   void advance();
   void updateValue();
+  void advanceToChangedKey();
 
   InnerIter oldIt_{nullptr};
   InnerIter newIt_{nullptr};
   const MapType* oldMap_{nullptr};
   const MapType* newMap_{nullptr};
+  // Only set when iterating over changed keys, in which case oldIt_ and
+  // newIt_ stay at the end of their maps.
+  std::shared_ptr<const KeyList> keys_;
+  size_t keyIndex_{0};
   VALUE value_;
 
   static std::shared_ptr<Node> nullNode_;
@@ -214,6 +263,9 @@ NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::begin() const {
   if (!new_) {
     return Iterator(getOld(), old_->begin(), getOld(), old_->end());
   }
+  if (changedKeys_) {
+    return Iterator(getOld(), getNew(), changedKeys_, 0);
+  }
   return Iterator(getOld(), old_->begin(), getNew(), new_->begin());
 }
 
@@ -226,6 +278,9 @@ NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::end() const {
   if (!new_) {
     return Iterator(getOld(), old_->end(), getOld(), old_->end());
   }
+  if (changedKeys_) {
+    return Iterator(getOld(), getNew(), changedKeys_, changedKeys_->size());
+  }
   return Iterator(getOld(), old_->end(), getNew(), new_->end());
 }
 
@@ -13,6 +13,8 @@
 
 #include <folly/dynamic.h>
 
+#include <memory>
+
 #include "fboss/agent/state/RouteNextHop.h"
 #include "fboss/agent/state/RouteTypes.h"
 
@@ -24,18 +26,20 @@ class RouteNextHopEntry {
  public:
   using Action = RouteForwardAction;
   using NextHopSet = boost::container::flat_set<NextHop>;
+  /*
+   * Next hop sets are interned, so routes with the same next hops share a
+   * single immutable copy, and equal sets have equal pointers.
+   */
+  using NextHopSetPtr = std::shared_ptr<const NextHopSet>;
 
   RouteNextHopEntry(Action action, AdminDistance distance)
-      : adminDistance_(distance), action_(action) {
+      : adminDistance_(distance), action_(action), nhopSet_(emptyNextHopSet()) {
     CHECK_NE(action_, Action::NEXTHOPS);
   }
 
   RouteNextHopEntry(NextHopSet nhopSet, AdminDistance distance);
 
-  RouteNextHopEntry(NextHop nhop, AdminDistance distance)
-      : adminDistance_(distance), action_(Action::NEXTHOPS) {
-    nhopSet_.emplace(std::move(nhop));
-  }
+  RouteNextHopEntry(NextHop nhop, AdminDistance distance);
 
   AdminDistance getAdminDistance() const {
     return adminDistance_;
@@ -46,9 +50,15 @@ class RouteNextHopEntry {
   }
 
   const NextHopSet& getNextHopSet() const {
+    return *nhopSet_;
+  }
+
+  const NextHopSetPtr& getInternedNextHopSet() const {
     return nhopSet_;
   }
 
+  static NextHopSetPtr internNextHopSet(NextHopSet nhopSet);
+
   NextHopSet normalizedNextHops() const;
 
   // Get the sum of the weights of all the nexthops in the entry
@@ -79,16 +89,18 @@ class RouteNextHopEntry {
 
   // Reset the NextHopSet
   void reset() {
-    nhopSet_.clear();
+    nhopSet_ = emptyNextHopSet();
     action_ = Action::DROP;
   }
 
   bool isValid(bool forMplsRoute = false) const;
 
  private:
+  static const NextHopSetPtr& emptyNextHopSet();
+
   AdminDistance adminDistance_;
   Action action_{Action::DROP};
-  NextHopSet nhopSet_;
+  NextHopSetPtr nhopSet_;
 };
 
 /**
@@ -9,6 +9,7 @@
  */
 #include "fboss/agent/state/SwitchState.h"
 
+#include "fboss/agent/Constants.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/state/AclEntry.h"
 #include "fboss/agent/state/AclMap.h"
@@ -30,6 +31,8 @@
 
 #include "fboss/agent/state/NodeBase-defs.h"
 
+#include <folly/logging/xlog.h>
+
 using std::make_shared;
 using std::shared_ptr;
 using std::chrono::seconds;
@@ -82,6 +85,7 @@ SwitchStateFields::SwitchStateFields()
       labelFib(make_shared<LabelForwardingInformationBase>()),
       switchSettings(make_shared<SwitchSettings>()) {}
 
+// Fields serialized here must also be journaled, see WarmBootJournal
 folly::dynamic SwitchStateFields::toFollyDynamic() const {
   folly::dynamic switchState = folly::dynamic::object;
   switchState[kInterfaces] = interfaces->toFollyDynamic();
@@ -117,6 +121,13 @@ SwitchStateFields SwitchStateFields::fromFollyDynamic(
   switchState.routeTables =
       RouteTableMap::fromFollyDynamic(swJson[kRouteTables]);
   switchState.acls = AclMap::fromFollyDynamic(swJson[kAcls]);
+  switchState.otherFieldsFromFollyDynamic(swJson);
+  return switchState;
+}
+
+void SwitchStateFields::otherFieldsFromFollyDynamic(
+    const folly::dynamic& swJson) {
+  auto& switchState = *this;
   if (swJson.count(kSflowCollectors) > 0) {
     switchState.sFlowCollectors =
         SflowCollectorMap::fromFollyDynamic(swJson[kSflowCollectors]);
@@ -166,11 +177,65 @@ SwitchStateFields SwitchStateFields::fromFollyDynamic(
   }
 
   // TODO verify that created state here is internally consistent t4155406
-  return switchState;
 }
 
 SwitchState::SwitchState() {}
 
+folly::SemiFuture<std::unique_ptr<SwitchState>>
+SwitchState::restoreFromFollyDynamic(
+    folly::dynamic json,
+    folly::Executor* executor) {
+  auto start = std::chrono::steady_clock::now();
+  auto swJson = std::make_shared<const folly::dynamic>(std::move(json));
+  auto fields = std::make_shared<SwitchStateFields>();
+  const auto& tablesJson = (*swJson)[kRouteTables][kEntries];
+  auto tables =
+      std::make_shared<std::vector<std::shared_ptr<RouteTable>>>(
+          tablesJson.size());
+
+  std::vector<folly::Future<folly::Unit>> restored;
+  auto restore = [executor, &restored](auto fn) {
+    restored.push_back(folly::via(executor, std::move(fn)));
+  };
+  restore([swJson, fields] {
+    fields->ports = PortMap::fromFollyDynamic((*swJson)[kPorts]);
+  });
+  restore([swJson, fields] {
+    fields->vlans = VlanMap::fromFollyDynamic((*swJson)[kVlans]);
+  });
+  restore([swJson, fields] {
+    fields->interfaces =
+        InterfaceMap::fromFollyDynamic((*swJson)[kInterfaces]);
+  });
+  restore([swJson, fields] {
+    fields->acls = AclMap::fromFollyDynamic((*swJson)[kAcls]);
+  });
+  for (size_t i = 0; i < tablesJson.size(); ++i) {
+    restore([swJson, tables, i] {
+      (*tables)[i] = RouteTable::fromFollyDynamic(
+          (*swJson)[kRouteTables][kEntries][i]);
+    });
+  }
+
+  return folly::collect(std::move(restored))
+      .via(executor)
+      .thenValue([swJson, fields, tables, start](auto&&) {
+        auto routeTables = std::make_shared<RouteTableMap>();
+        for (const auto& table : *tables) {
+          routeTables->addRouteTable(table);
+        }
+        fields->routeTables = std::move(routeTables);
+        fields->otherFieldsFromFollyDynamic(*swJson);
+        XLOG(INFO) << "Restored switch state in "
+                   << std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count()
+                   << "ms";
+        return std::make_unique<SwitchState>(*fields);
+      })
+      .semi();
+}
+
 SwitchState::~SwitchState() {}
 
 void SwitchState::modify(std::shared_ptr<SwitchState>* state) {
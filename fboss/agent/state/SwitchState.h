@@ -15,6 +15,7 @@
 #include <folly/FBString.h>
 #include <folly/Memory.h>
 #include <folly/dynamic.h>
+#include <folly/futures/Future.h>
 
 #include "fboss/agent/state/AclMap.h"
 #include "fboss/agent/state/AggregatePortMap.h"
@@ -73,6 +74,11 @@ struct SwitchStateFields {
    * Reconstruct object from folly::dynamic
    */
   static SwitchStateFields fromFollyDynamic(const folly::dynamic& json);
+  /*
+   * Reconstruct everything but ports, VLANs, interfaces, route tables and
+   * ACLs from folly::dynamic
+   */
+  void otherFieldsFromFollyDynamic(const folly::dynamic& json);
   // Static state, which can be accessed without locking.
   std::shared_ptr<PortMap> ports;
   std::shared_ptr<AggregatePortMap> aggPorts;
@@ -171,6 +177,14 @@ class SwitchState : public NodeBaseT<SwitchState, SwitchStateFields> {
     return std::make_unique<SwitchState>(fields);
   }
 
+  /*
+   * Reconstruct the state on executor, deserializing ports, VLANs,
+   * interfaces, ACLs and the route table of each VRF in parallel. Used on
+   * warm boot, where the caller can restore its hardware tables meanwhile.
+   */
+  static folly::SemiFuture<std::unique_ptr<SwitchState>>
+  restoreFromFollyDynamic(folly::dynamic json, folly::Executor* executor);
+
   static std::unique_ptr<SwitchState> uniquePtrFromJson(
       const folly::fbstring& jsonStr) {
     return uniquePtrFromFollyDynamic(folly::parseJson(jsonStr));
@@ -17,6 +17,7 @@
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/TestUtils.h"
 
+#include <folly/Conv.h>
 #include <folly/IPAddress.h>
 #include <folly/MacAddress.h>
 #include <gtest/gtest.h>
@@ -30,6 +31,7 @@ using std::shared_ptr;
 namespace {
 // We offset the start point in ApplyThriftConfig
 constexpr auto kAclStartPriority = 100000;
+constexpr auto kAclPriorityGap = 16;
 } // namespace
 
 TEST(Acl, applyConfig) {
@@ -394,10 +396,18 @@ TEST(Acl, AclGeneration) {
   EXPECT_NE(acls->getEntryIf("acl5"), nullptr);
 
   EXPECT_EQ(acls->getEntryIf("acl1")->getPriority(), kAclStartPriority);
-  EXPECT_EQ(acls->getEntryIf("acl4")->getPriority(), kAclStartPriority + 1);
-  EXPECT_EQ(acls->getEntryIf("acl2")->getPriority(), kAclStartPriority + 2);
-  EXPECT_EQ(acls->getEntryIf("acl3")->getPriority(), kAclStartPriority + 3);
-  EXPECT_EQ(acls->getEntryIf("acl5")->getPriority(), kAclStartPriority + 4);
+  EXPECT_EQ(
+      acls->getEntryIf("acl4")->getPriority(),
+      kAclStartPriority + 1 * kAclPriorityGap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl2")->getPriority(),
+      kAclStartPriority + 2 * kAclPriorityGap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl3")->getPriority(),
+      kAclStartPriority + 3 * kAclPriorityGap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl5")->getPriority(),
+      kAclStartPriority + 4 * kAclPriorityGap);
 
   // Ensure that the global actions in global traffic policy has been added to
   // the ACL entries
@@ -411,6 +421,77 @@ TEST(Acl, AclGeneration) {
            .dscpValue_ref());
 }
 
+TEST(Acl, InsertKeepsExistingPriorities) {
+  auto platform = createMockPlatform();
+  auto stateV0 = make_shared<SwitchState>();
+
+  cfg::SwitchConfig config;
+  auto addAcl = [&config](const std::string& name, int index) {
+    cfg::AclEntry acl;
+    *acl.name_ref() = name;
+    *acl.actionType_ref() = cfg::AclActionType::DENY;
+    config.acls_ref()->insert(config.acls_ref()->begin() + index, acl);
+  };
+  addAcl("A", 0);
+  addAcl("B", 1);
+  auto stateV1 = publishAndApplyConfig(stateV0, &config, platform.get());
+  ASSERT_NE(nullptr, stateV1);
+  auto aPrio = stateV1->getAcl("A")->getPriority();
+  auto bPrio = stateV1->getAcl("B")->getPriority();
+  EXPECT_EQ(kAclStartPriority, aPrio);
+  EXPECT_EQ(kAclStartPriority + kAclPriorityGap, bPrio);
+
+  // Inserting in the middle or at the top must not renumber existing ACLs
+  addAcl("C", 1);
+  addAcl("D", 0);
+  auto stateV2 = publishAndApplyConfig(stateV1, &config, platform.get());
+  ASSERT_NE(nullptr, stateV2);
+  EXPECT_EQ(aPrio, stateV2->getAcl("A")->getPriority());
+  EXPECT_EQ(bPrio, stateV2->getAcl("B")->getPriority());
+  auto cPrio = stateV2->getAcl("C")->getPriority();
+  auto dPrio = stateV2->getAcl("D")->getPriority();
+  EXPECT_LT(dPrio, aPrio);
+  EXPECT_LT(aPrio, cPrio);
+  EXPECT_LT(cPrio, bPrio);
+}
+
+TEST(Acl, PrioritiesBoundedByHwMax) {
+  auto platform = createMockPlatform();
+  auto stateV0 = make_shared<SwitchState>();
+
+  // Exactly as many data plane ACLs as fit below the max priority
+  auto numAcls =
+      (AclEntryFields::kMaxPriority - kAclStartPriority) / kAclPriorityGap;
+  cfg::SwitchConfig config;
+  for (auto i = 0; i < numAcls; ++i) {
+    cfg::AclEntry acl;
+    *acl.name_ref() = folly::to<std::string>("acl", i);
+    *acl.actionType_ref() = cfg::AclActionType::DENY;
+    config.acls_ref()->push_back(acl);
+  }
+  auto stateV1 = publishAndApplyConfig(stateV0, &config, platform.get());
+  ASSERT_NE(nullptr, stateV1);
+  auto lastAcl = folly::to<std::string>("acl", numAcls - 1);
+  auto lastPrio = stateV1->getAcl(lastAcl)->getPriority();
+  EXPECT_LT(lastPrio, AclEntryFields::kMaxPriority);
+  EXPECT_GE(lastPrio + kAclPriorityGap, AclEntryFields::kMaxPriority);
+
+  // Appending one more squeezes it in below the max
+  cfg::AclEntry acl;
+  *acl.name_ref() = "oneMore";
+  *acl.actionType_ref() = cfg::AclActionType::DENY;
+  config.acls_ref()->push_back(acl);
+  auto stateV2 = publishAndApplyConfig(stateV1, &config, platform.get());
+  ASSERT_NE(nullptr, stateV2);
+  EXPECT_EQ(lastPrio, stateV2->getAcl(lastAcl)->getPriority());
+  EXPECT_LT(
+      stateV2->getAcl("oneMore")->getPriority(), AclEntryFields::kMaxPriority);
+
+  // But numbered from scratch, they no longer fit
+  EXPECT_THROW(
+      publishAndApplyConfig(stateV0, &config, platform.get()), FbossError);
+}
+
 TEST(Acl, SerializeAclEntry) {
   auto entry = std::make_unique<AclEntry>(0, "dscp1");
   entry->setDscp(1);
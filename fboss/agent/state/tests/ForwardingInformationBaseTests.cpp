@@ -189,6 +189,36 @@ TEST_F(ForwardingInformationBaseV6Test, DecreasingLPMSequence) {
   }
 }
 
+TEST_F(ForwardingInformationBaseV4Test, PublishedLPM) {
+  fib.publish();
+  CHECK_LPM(fib.longestMatch(folly::IPAddressV4("0.0.0.0")), ip4_0, 4);
+  CHECK_LPM(fib.longestMatch(folly::IPAddressV4("64.1.0.1")), ip4_64, 3);
+  CHECK_LPM(fib.longestMatch(folly::IPAddressV4("161.16.8.1")), ip4_160, 3);
+  EXPECT_EQ(nullptr, fib.longestMatch(folly::IPAddressV4("192.0.0.0")));
+
+  // The next generation indexes its own routes
+  auto newFib = fib.clone();
+  newFib->addNode(createRouteFromPrefix(ip4_160, 8));
+  newFib->publish();
+  CHECK_LPM(newFib->longestMatch(folly::IPAddressV4("160.1.0.1")), ip4_160, 8);
+  CHECK_LPM(fib.longestMatch(folly::IPAddressV4("160.1.0.1")), ip4_160, 3);
+}
+
+TEST_F(ForwardingInformationBaseV6Test, PublishedLPM) {
+  fib.publish();
+  CHECK_LPM(fib.longestMatch(folly::IPAddressV6("::")), ip6_0, 4);
+  CHECK_LPM(fib.longestMatch(folly::IPAddressV6("4001:1::")), ip6_64, 3);
+  CHECK_LPM(fib.longestMatch(folly::IPAddressV6("A110:801::")), ip6_160, 3);
+  EXPECT_EQ(nullptr, fib.longestMatch(folly::IPAddressV6("C000::")));
+
+  // The next generation indexes its own routes
+  auto newFib = fib.clone();
+  newFib->addNode(createRouteFromPrefix(ip6_160, 8));
+  newFib->publish();
+  CHECK_LPM(newFib->longestMatch(folly::IPAddressV6("A000:1::")), ip6_160, 8);
+  CHECK_LPM(fib.longestMatch(folly::IPAddressV6("A000:1::")), ip6_160, 3);
+}
+
 TEST(ForwardingInformationBaseV4, IPv4DefaultPrefixComparesSmallest) {
   ForwardingInformationBaseV4 oldFib;
   ForwardingInformationBaseV4 newFib;
@@ -84,6 +84,31 @@ TEST(Interface, addrToReach) {
   EXPECT_EQ(nullptr, ret.intf);
   EXPECT_EQ(nullptr, ret.addr);
   EXPECT_EQ(0, ret.mask);
+
+  // Published maps answer the same lookups from their address index
+  state->publish();
+  ret = intfs->getIntfAddrToReach(RouterID(1), IPAddress("20.1.1.100"));
+  EXPECT_EQ(intf1.get(), ret.intf);
+  EXPECT_EQ(IPAddress("20.1.1.2"), *ret.addr);
+  EXPECT_EQ(24, ret.mask);
+
+  ret = intfs->getIntfAddrToReach(RouterID(2), IPAddress("::22:33:4f"));
+  EXPECT_EQ(intf2.get(), ret.intf);
+  EXPECT_EQ(IPAddress("::22:33:44"), *ret.addr);
+  EXPECT_EQ(120, ret.mask);
+
+  ret = intfs->getIntfAddrToReach(RouterID(2), IPAddress("::22:34:5f"));
+  EXPECT_EQ(nullptr, ret.intf);
+  ret = intfs->getIntfAddrToReach(RouterID(3), IPAddress("10.1.1.100"));
+  EXPECT_EQ(nullptr, ret.intf);
+
+  EXPECT_EQ(intf1, intfs->getInterfaceIf(RouterID(1), IPAddress("10.1.1.1")));
+  EXPECT_EQ(intf2, intfs->getInterface(RouterID(2), IPAddress("::11:11:11")));
+  EXPECT_EQ(nullptr, intfs->getInterfaceIf(RouterID(1), IPAddress("10.1.1.2")));
+  EXPECT_THROW(
+      intfs->getInterface(RouterID(3), IPAddress("10.1.1.1")), FbossError);
+  EXPECT_EQ(intf2, intfs->getInterfaceInVlanIf(VlanID(2)));
+  EXPECT_EQ(nullptr, intfs->getInterfaceInVlanIf(VlanID(3)));
 }
 
 TEST(Interface, applyConfig) {
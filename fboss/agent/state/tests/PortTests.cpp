@@ -21,6 +21,7 @@
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/TestUtils.h"
 
+#include <folly/Conv.h>
 #include <gtest/gtest.h>
 
 using namespace facebook::fboss;
@@ -848,6 +849,56 @@ TEST(PortMap, applyConfig) {
   checkChangedPorts(portsV2, portsV3, {3});
 }
 
+TEST(PortMap, deltaVisitsChangedPortsOnly) {
+  auto portsV0 = make_shared<PortMap>();
+  for (int i = 1; i <= 100; ++i) {
+    portsV0->registerPort(PortID(i), folly::to<std::string>("port", i));
+  }
+  portsV0->publish();
+
+  // Changes made through addNode()/updateNode()/removeNode() are tracked
+  auto portsV1 = portsV0->clone();
+  auto port10 = portsV1->getPort(PortID(10))->clone();
+  port10->setAdminState(cfg::PortState::ENABLED);
+  portsV1->updatePort(port10);
+  // Setting the node that is already there isn't a change
+  portsV1->updatePort(portsV1->getPort(PortID(20)));
+  portsV1->removeNode(PortID(30));
+  portsV1->registerPort(PortID(200), "port200");
+  portsV1->publish();
+  auto changedKeys = portsV1->getChangedKeysSince(*portsV0);
+  ASSERT_NE(nullptr, changedKeys);
+  EXPECT_EQ(
+      std::vector<PortID>({PortID(10), PortID(30), PortID(200)}),
+      *changedKeys);
+  checkChangedPorts(portsV0, portsV1, {10});
+
+  std::vector<std::pair<bool, bool>> oldAndNew;
+  NodeMapDelta<PortMap> delta(portsV0.get(), portsV1.get());
+  for (const auto& portDelta : delta) {
+    oldAndNew.emplace_back(
+        portDelta.getOld() != nullptr, portDelta.getNew() != nullptr);
+  }
+  EXPECT_EQ(
+      std::vector<std::pair<bool, bool>>(
+          {{true, true}, {true, false}, {false, true}}),
+      oldAndNew);
+
+  // Keys only mean something relative to the map cloned from
+  EXPECT_EQ(nullptr, portsV1->getChangedKeysSince(*portsV1));
+  checkChangedPorts(portsV1, portsV0, {10});
+
+  // Changes through the raw container aren't tracked, so the delta falls back
+  // to walking both maps.
+  auto portsV2 = portsV1->clone();
+  auto port40 = portsV2->getPort(PortID(40))->clone();
+  port40->setAdminState(cfg::PortState::ENABLED);
+  portsV2->writableNodes()[PortID(40)] = port40;
+  portsV2->publish();
+  EXPECT_EQ(nullptr, portsV2->getChangedKeysSince(*portsV1));
+  checkChangedPorts(portsV1, portsV2, {40});
+}
+
 TEST(PortMap, iterateOrder) {
   // The NodeMapDelta::Iterator code assumes that the PortMap iterator walks
   // through the ports in sorted order (sorted by PortID).
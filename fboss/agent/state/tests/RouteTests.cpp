@@ -29,6 +29,7 @@
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/TestUtils.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/logging/xlog.h>
 #include <gtest/gtest.h>
 #include <optional>
@@ -1693,6 +1694,36 @@ TEST(Route, equality) {
   EXPECT_TRUE(nhm1 == nhm2);
 }
 
+// Routes with equal next hops share a single interned next hop set
+TEST(Route, nextHopSetsInterned) {
+  RouteNextHopEntry entry1(newNextHops(3, "1.1.1."), DISTANCE);
+  RouteNextHopEntry entry2(newNextHops(3, "1.1.1."), DISTANCE);
+  RouteNextHopEntry entry3(newNextHops(2, "1.1.1."), DISTANCE);
+  EXPECT_EQ(entry1.getInternedNextHopSet(), entry2.getInternedNextHopSet());
+  EXPECT_EQ(entry1, entry2);
+  EXPECT_NE(entry1.getInternedNextHopSet(), entry3.getInternedNextHopSet());
+  EXPECT_FALSE(entry1 == entry3);
+
+  // Same next hops, but different weights
+  RouteNextHopSet weighted;
+  for (const auto& nhop : entry1.getNextHopSet()) {
+    weighted.emplace(UnresolvedNextHop(nhop.addr(), nhop.weight() + 1));
+  }
+  RouteNextHopEntry entry4(weighted, DISTANCE);
+  EXPECT_NE(entry1.getInternedNextHopSet(), entry4.getInternedNextHopSet());
+
+  // Serialization round trip lands on the same set
+  auto entry5 = RouteNextHopEntry::fromFollyDynamic(entry1.toFollyDynamic());
+  EXPECT_EQ(entry1.getInternedNextHopSet(), entry5.getInternedNextHopSet());
+
+  // DROP and TO_CPU entries share the empty set
+  RouteNextHopEntry drop(RouteForwardAction::DROP, DISTANCE);
+  RouteNextHopEntry toCpu(RouteForwardAction::TO_CPU, DISTANCE);
+  EXPECT_EQ(drop.getInternedNextHopSet(), toCpu.getInternedNextHopSet());
+  entry1.reset();
+  EXPECT_EQ(entry1, drop);
+}
+
 // Test that a copy of a RouteNextHopsMulti is a deep copy, and that the
 // resulting objects can be modified independently.
 TEST(Route, deepCopy) {
@@ -2137,6 +2168,38 @@ TEST(Route, serializeRouteTable) {
   EXPECT_ROUTETABLERIB_MATCH(origRt->getRibV6(), desRt->getRibV6());
 }
 
+TEST(Route, restoreSwitchState) {
+  auto stateV1 = testStateA();
+  stateV1->publish();
+
+  RouteUpdater u1(stateV1->getRouteTables());
+  for (auto rid : {RouterID(0), RouterID(1)}) {
+    u1.addRoute(
+        rid,
+        IPAddress("10.1.1.0"),
+        24,
+        CLIENT_A,
+        RouteNextHopEntry(makeNextHops({"1.1.1.10"}), DISTANCE));
+    u1.addRoute(
+        rid,
+        IPAddress("1001::0"),
+        48,
+        CLIENT_A,
+        RouteNextHopEntry(makeNextHops({"1.1.1.10"}), DISTANCE));
+  }
+  auto stateV2 = stateV1->clone();
+  stateV2->resetRouteTables(u1.updateDone());
+  stateV2->publish();
+
+  // Restore each part of the state on its own thread
+  folly::CPUThreadPoolExecutor executor(4);
+  auto restored =
+      SwitchState::restoreFromFollyDynamic(stateV2->toFollyDynamic(), &executor)
+          .get();
+  EXPECT_EQ(2, restored->getRouteTables()->size());
+  EXPECT_EQ(restored->toFollyDynamic(), stateV2->toFollyDynamic());
+}
+
 // Test utility functions for converting RouteNextHopSet to thrift and back
 TEST(RouteTypes, toFromRouteNextHops) {
   RouteNextHopSet nhs;
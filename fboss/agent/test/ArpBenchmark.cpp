@@ -10,6 +10,7 @@
 #include <boost/cast.hpp>
 
 #include <folly/Benchmark.h>
+#include <folly/Format.h>
 #include <folly/Memory.h>
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/TunManager.h"
@@ -18,10 +19,13 @@
 #include "fboss/agent/hw/sim/SimSwitch.h"
 #include "fboss/agent/state/ArpResponseTable.h"
 #include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/RouteUpdater.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/state/VlanMap.h"
 
+#include <vector>
+
 using namespace facebook::fboss;
 using folly::IPAddress;
 using folly::IPAddressV4;
@@ -32,11 +36,15 @@ using std::shared_ptr;
 using std::unique_ptr;
 
 namespace {
+// Unresolved destinations trapped packets are spread across
+constexpr uint32_t kNumFloodDsts = 64;
 
 // Global state used by the benchmarks
 unique_ptr<SwSwitch> sw;
 unique_ptr<MockRxPacket> arpRequest_10_0_0_1;
 unique_ptr<MockRxPacket> arpRequest_10_0_0_5;
+// Next unused host in 10.1.0.0/16
+uint32_t nextFloodDst = 2;
 
 unique_ptr<SwSwitch> setupSwitch() {
   MacAddress localMac("02:00:01:00:00:01");
@@ -65,6 +73,7 @@ unique_ptr<SwSwitch> setupSwitch() {
     Interface::Addresses addrs1;
     addrs1.emplace(IPAddress("10.0.0.1"), 24);
     addrs1.emplace(IPAddress("192.168.0.1"), 24);
+    addrs1.emplace(IPAddress("10.1.0.1"), 16);
     intf1->setAddresses(addrs1);
     state->addIntf(intf1);
 
@@ -80,6 +89,10 @@ unique_ptr<SwSwitch> setupSwitch() {
         MacAddress("00:02:00:00:00:02"),
         InterfaceID(4));
     state->getVlans()->getVlan(VlanID(1))->setArpResponseTable(respTable1);
+
+    RouteUpdater updater(state->getRouteTables());
+    updater.addInterfaceAndLinkLocalRoutes(state->getInterfaces());
+    state->resetRouteTables(updater.updateDone());
     return state;
   };
 
@@ -136,6 +149,36 @@ void init() {
   arpRequest_10_0_0_5->setSrcVlan(VlanID(1));
 }
 
+// An IPv4 packet routed to dst, trapped since dst is unresolved
+unique_ptr<MockRxPacket> makeTrappedPacket(IPAddressV4 dst) {
+  auto bytes = dst.toByteArray();
+  auto pkt = MockRxPacket::fromHex(folly::sformat(
+      // dst mac, src mac
+      "02 00 01 00 00 01  00 02 00 01 02 03"
+      // 802.1q, VLAN 1
+      "81 00  00 01"
+      // IPv4
+      "08 00"
+      // Version(4), IHL(5), DSCP(0), ECN(0), Total Length(20)
+      "45  00  00 14"
+      // Identification(0), Flags(0), Fragment offset(0)
+      "00 00  00 00"
+      // TTL(31), Protocol(6), Checksum (0, fake)
+      "1F  06  00 00"
+      // Source IP (1.2.3.4)
+      "01 02 03 04"
+      // Destination IP
+      "{:02x} {:02x} {:02x} {:02x}",
+      bytes[0],
+      bytes[1],
+      bytes[2],
+      bytes[3]));
+  pkt->padToLength(68);
+  pkt->setSrcPort(PortID(1));
+  pkt->setSrcVlan(VlanID(1));
+  return pkt;
+}
+
 } // unnamed namespace
 
 BENCHMARK(ArpRequest, numIters) {
@@ -176,6 +219,33 @@ BENCHMARK(ArpRequestNotMine, numIters) {
   }
 }
 
+/*
+ * Trapped packets for kNumFloodDsts destinations nobody has resolved yet, as
+ * when a prefix gets traffic before its neighbors are learnt. Each run uses
+ * fresh destinations, and reports how many ARP requests went out.
+ */
+BENCHMARK_COUNTERS(UnresolvedFlood, counters, numIters) {
+  std::vector<unique_ptr<MockRxPacket>> pkts;
+  BENCHMARK_SUSPEND {
+    SimSwitch* sim = boost::polymorphic_downcast<SimSwitch*>(sw->getHw());
+    sim->resetTxCount();
+    for (uint32_t i = 0; i < kNumFloodDsts; ++i) {
+      pkts.push_back(makeTrappedPacket(
+          IPAddressV4::fromLongHBO(0x0a010000 + nextFloodDst)));
+      nextFloodDst = nextFloodDst < 0xfffe ? nextFloodDst + 1 : 2;
+    }
+  }
+
+  for (size_t n = 0; n < numIters; ++n) {
+    sw->packetReceived(pkts[n % kNumFloodDsts]->clone());
+  }
+
+  BENCHMARK_SUSPEND {
+    SimSwitch* sim = boost::polymorphic_downcast<SimSwitch*>(sw->getHw());
+    counters["arp_requests"] = sim->getTxCount();
+  }
+}
+
 int main(int argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
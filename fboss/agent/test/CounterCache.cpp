@@ -10,13 +10,12 @@
 #include "fboss/agent/test/CounterCache.h"
 
 #include <fb303/ServiceData.h>
-#include <fb303/ThreadCachedServiceData.h>
 #include "fboss/agent/SwSwitch.h"
 
 namespace facebook::fboss {
 
 void CounterCache::update() {
-  fb303::ThreadCachedServiceData::get()->publishStats();
+  sw_->publishStats();
   prev_.swap(current_);
   current_.clear();
   fb303::fbData->getCounters(current_);
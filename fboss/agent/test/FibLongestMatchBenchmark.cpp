@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/state/ForwardingInformationBase.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/state/RouteTypes.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddressV6.h>
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr size_t kNumLookups = 10'000;
+
+// 2401:db00:<index>::/64
+folly::IPAddressV6 routeAddr(uint32_t index, uint64_t host = 0) {
+  folly::ByteArray16 bytes{};
+  bytes[0] = 0x24;
+  bytes[1] = 0x01;
+  bytes[2] = 0xdb;
+  for (auto i = 0; i < 4; ++i) {
+    bytes[4 + i] = (index >> (24 - 8 * i)) & 0xff;
+  }
+  for (auto i = 0; i < 8; ++i) {
+    bytes[8 + i] = (host >> (56 - 8 * i)) & 0xff;
+  }
+  return folly::IPAddressV6(bytes);
+}
+
+std::shared_ptr<ForwardingInformationBaseV6> makeFib(uint32_t numRoutes) {
+  auto fib = std::make_shared<ForwardingInformationBaseV6>();
+  fib->addNode(std::make_shared<Route<folly::IPAddressV6>>(
+      RouteFields<folly::IPAddressV6>(RoutePrefixV6{folly::IPAddressV6(), 0})));
+  for (uint32_t i = 0; i < numRoutes; ++i) {
+    fib->addNode(std::make_shared<Route<folly::IPAddressV6>>(
+        RouteFields<folly::IPAddressV6>(RoutePrefixV6{routeAddr(i), 64})));
+  }
+  return fib;
+}
+
+/*
+ * Time kNumLookups longest matches, of hosts spread across the routes, in a
+ * published FIB of numRoutes /64s and a default route. Publishing, which
+ * builds the index, is not timed.
+ */
+void fibLongestMatch(uint32_t numRoutes, bool published) {
+  folly::BenchmarkSuspender suspender;
+  auto fib = makeFib(numRoutes);
+  std::vector<folly::IPAddressV6> addrs;
+  addrs.reserve(kNumLookups);
+  for (size_t i = 0; i < kNumLookups; ++i) {
+    // Every 8th lookup only matches the default route
+    auto index = i % 8 ? (i * 7919) % numRoutes : numRoutes + i;
+    addrs.push_back(routeAddr(index, i + 1));
+  }
+  if (published) {
+    fib->publish();
+  }
+
+  suspender.dismiss();
+  for (const auto& addr : addrs) {
+    folly::doNotOptimizeAway(fib->longestMatch(addr));
+  }
+  suspender.rehire();
+}
+} // namespace
+
+// Linear scan of an unpublished FIB, for reference
+BENCHMARK(FibLongestMatchScan1k) {
+  fibLongestMatch(1'000, false);
+}
+
+BENCHMARK(FibLongestMatch1k) {
+  fibLongestMatch(1'000, true);
+}
+
+BENCHMARK(FibLongestMatch100k) {
+  fibLongestMatch(100'000, true);
+}
+
+BENCHMARK(FibLongestMatch500k) {
+  fibLongestMatch(500'000, true);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
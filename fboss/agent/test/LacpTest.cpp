@@ -21,6 +21,8 @@
 #include <folly/MacAddress.h>
 #include <folly/Range.h>
 #include <folly/Synchronized.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
 #include <folly/logging/xlog.h>
 #include <folly/synchronization/Baton.h>
 #include <folly/system/ThreadName.h>
@@ -30,7 +32,15 @@
 #include "fboss/agent/LacpController.h"
 #include "fboss/agent/LacpTypes.h"
 #include "fboss/agent/LinkAggregationManager.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/TxPacket.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
+#include "fboss/agent/hw/mock/MockHwSwitch.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/HwTestHandle.h"
+#include "fboss/agent/test/TestUtils.h"
 #include "fboss/agent/types.h"
 
 using namespace facebook::fboss;
@@ -188,6 +198,26 @@ class MockLacpServicer : public LacpServicerIf {
       std::vector<std::shared_ptr<LacpController>>(
           folly::Range<std::vector<PortID>::const_iterator>));
 };
+
+// The frame carrying lacpdu out of portID, serialized from scratch
+std::string serializeLacpFrame(
+    SwSwitch* sw,
+    const LACPDU& lacpdu,
+    PortID portID) {
+  auto port = sw->getState()->getPorts()->getPort(portID);
+  folly::IOBuf buf(folly::IOBuf::CREATE, LACPDU::LENGTH);
+  buf.append(LACPDU::LENGTH);
+  folly::io::RWPrivateCursor writer(&buf);
+  TxPacket::writeEthHeader(
+      &writer,
+      LACPDU::kSlowProtocolsDstMac(),
+      sw->getPlatform()->getLocalMac(),
+      port->getIngressVlan(),
+      LACPDU::EtherType::SLOW_PROTOCOLS);
+  writer.writeBE<uint8_t>(LACPDU::EtherSubtype::LACP);
+  lacpdu.to(&writer);
+  return std::string(reinterpret_cast<const char*>(buf.data()), buf.length());
+}
 } // namespace
 
 /*
@@ -867,3 +897,65 @@ TEST_F(LacpTest, selfInteroperability) {
       LacpState::AGGREGATABLE | LacpState::ACTIVE | LacpState::SHORT_TIMEOUT |
           LacpState::IN_SYNC | LacpState::COLLECTING | LacpState::DISTRIBUTING);
 }
+
+/*
+ * LinkAggregationManager sends LACPDUs from a cached frame, patching the
+ * actor and partner state into it. Check the frames on the wire are the
+ * same, byte for byte, as frames serialized from scratch.
+ */
+TEST(LacpTxTest, cachedFramesMatchSerializedFrames) {
+  auto handle = createTestHandle(testStateAWithPortsUp());
+  auto sw = handle->getSw();
+  LinkAggregationManager lagManager(sw);
+  const PortID portID(1);
+
+  std::vector<std::string> sent;
+  EXPECT_HW_CALL(sw, sendPacketOutOfPortAsync_(testing::_, portID, testing::_))
+      .Times(3)
+      .WillRepeatedly(testing::Invoke(
+          [&sent](TxPacket* pkt, PortID, std::optional<uint8_t>) {
+            sent.emplace_back(
+                reinterpret_cast<const char*>(pkt->buf()->data()),
+                pkt->buf()->length());
+            delete pkt;
+            return true;
+          }));
+
+  ParticipantInfo actor;
+  actor.systemPriority = 65535;
+  actor.systemID = {{0x02, 0x90, 0xfb, 0x5e, 0x1e, 0x8d}};
+  actor.key = 1;
+  actor.portPriority = 32768;
+  actor.port = 1;
+  actor.state = LacpState::ACTIVE | LacpState::AGGREGATABLE;
+  auto partner = ParticipantInfo::defaultParticipantInfo();
+  partner.state = LacpState::DEFAULTED;
+
+  std::vector<LACPDU> lacpdus;
+  lacpdus.emplace_back(actor, partner);
+  // Only the states change, so the cached frame is patched
+  actor.state |= LacpState::IN_SYNC | LacpState::COLLECTING |
+      LacpState::DISTRIBUTING;
+  partner.state = LacpState::ACTIVE | LacpState::IN_SYNC;
+  lacpdus.emplace_back(actor, partner);
+  // The key changes, so the frame is rebuilt
+  actor.key = 2;
+  lacpdus.emplace_back(actor, partner);
+
+  sw->getLacpEvb()->runInEventBaseThreadAndWait([&]() {
+    for (const auto& lacpdu : lacpdus) {
+      EXPECT_TRUE(lagManager.transmit(lacpdu, portID));
+    }
+  });
+
+  ASSERT_EQ(lacpdus.size(), sent.size());
+  for (size_t i = 0; i < lacpdus.size(); ++i) {
+    EXPECT_EQ(serializeLacpFrame(sw, lacpdus[i], portID), sent[i]);
+  }
+  // Patching the cached frame changed nothing but the two state bytes
+  auto differingBytes = 0;
+  for (size_t i = 0; i < sent[0].size(); ++i) {
+    differingBytes += sent[0][i] != sent[1][i];
+  }
+  EXPECT_EQ(2, differingBytes);
+}
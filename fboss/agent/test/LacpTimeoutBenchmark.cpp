@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <folly/Benchmark.h>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+#include "fboss/agent/LacpMachines.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+// Member ports running LACP at fast rate, each with a periodic machine
+// rearming its timeout every short period
+constexpr size_t kNumPorts = 512;
+constexpr std::chrono::milliseconds kShortPeriod(1000);
+
+// A timeout on its own EventBase timer, as the LACP machines used
+class PortAsyncTimeout : public folly::AsyncTimeout {
+ public:
+  explicit PortAsyncTimeout(folly::EventBase* evb) : folly::AsyncTimeout(evb) {}
+  void timeoutExpired() noexcept override {}
+};
+
+// A timeout on the EventBase timing wheel, as the LACP machines use
+class PortLacpTimeout : public LacpTimeout {
+ public:
+  explicit PortLacpTimeout(folly::EventBase* evb) : LacpTimeout(evb) {}
+  void timeoutExpired() noexcept override {}
+};
+
+/*
+ * Rearm the timeouts of kNumPorts ports round robin, while all of them are
+ * scheduled.
+ */
+template <typename Timeout>
+void rearmTimeouts(size_t numIters) {
+  folly::EventBase evb;
+  std::vector<std::unique_ptr<Timeout>> timeouts;
+  BENCHMARK_SUSPEND {
+    for (size_t i = 0; i < kNumPorts; ++i) {
+      timeouts.push_back(std::make_unique<Timeout>(&evb));
+      timeouts.back()->scheduleTimeout(kShortPeriod);
+    }
+  }
+  for (size_t n = 0; n < numIters; ++n) {
+    timeouts[n % kNumPorts]->scheduleTimeout(kShortPeriod);
+  }
+  BENCHMARK_SUSPEND {
+    timeouts.clear();
+  }
+}
+
+} // unnamed namespace
+
+BENCHMARK(AsyncTimeoutRearm, numIters) {
+  rearmTimeouts<PortAsyncTimeout>(numIters);
+}
+
+BENCHMARK_RELATIVE(LacpTimeoutRearm, numIters) {
+  rearmTimeouts<PortLacpTimeout>(numIters);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -142,6 +142,27 @@ TEST(LldpManagerTest, LldpSend) {
   lldpManager.sendLldpOnAllPorts();
 }
 
+TEST(LldpManagerTest, LldpSendCachedFrames) {
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+  auto numPortsUp = 0;
+  for (const auto& port : *sw->getState()->getPorts()) {
+    numPortsUp += port->isPortUp();
+  }
+
+  // Frames sent the second time around come from the cached frames
+  EXPECT_HW_CALL(
+      sw,
+      sendPacketOutOfPortAsync_(
+          TxPacketMatcher::createMatcher("Lldp PDU", checkLldpPDU()),
+          _,
+          std::optional<uint8_t>(kNCStrictPriorityQueue)))
+      .Times(2 * numPortsUp);
+  LldpManager lldpManager(sw);
+  lldpManager.sendLldpOnAllPorts();
+  lldpManager.sendLldpOnAllPorts();
+}
+
 TEST(LldpManagerTest, LldpSendPeriodic) {
   auto handle = setupTestHandle();
   auto sw = handle->getSw();
@@ -18,6 +18,7 @@
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/TestUtils.h"
 
+#include <folly/Conv.h>
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 
@@ -212,6 +213,74 @@ class LookupClassRouteUpdaterTest : public ::testing::Test {
     waitForStateUpdates(this->sw_);
   }
 
+  std::vector<RoutePrefix<AddrT>> scaleRoutePrefixes(int numRoutes) const {
+    std::vector<RoutePrefix<AddrT>> prefixes;
+    for (int i = 0; i < numRoutes; ++i) {
+      if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+        prefixes.push_back(RoutePrefix<AddrT>{
+            folly::IPAddressV4::fromLongHBO(0x14000000 + (i << 8)), 24});
+      } else {
+        prefixes.push_back(RoutePrefix<AddrT>{
+            folly::IPAddressV6(folly::to<std::string>("2803:6080:", i, "::")),
+            64});
+      }
+    }
+    return prefixes;
+  }
+
+  void addRoutes(
+      const std::vector<RoutePrefix<AddrT>>& routePrefixes,
+      std::vector<AddrT> nextHops) {
+    this->updateState(
+        "Add new routes", [=](const std::shared_ptr<SwitchState>& state) {
+          auto newState = state->clone();
+          auto routeTables = state->getRouteTables();
+
+          RouteNextHopSet nexthops;
+          for (const auto& nextHop : nextHops) {
+            nexthops.emplace(UnresolvedNextHop(nextHop, UCMP_DEFAULT_WEIGHT));
+          }
+
+          RouteUpdater updater(routeTables);
+          for (const auto& routePrefix : routePrefixes) {
+            updater.addRoute(
+                this->kRid(),
+                routePrefix.network,
+                routePrefix.mask,
+                this->kClientID(),
+                RouteNextHopEntry(
+                    nexthops, AdminDistance::MAX_ADMIN_DISTANCE));
+          }
+
+          auto newRouteTables = updater.updateDone();
+          newRouteTables->publish();
+          newState->resetRouteTables(newRouteTables);
+
+          return newState;
+        });
+
+    waitForStateUpdates(this->sw_);
+    this->sw_->getNeighborUpdater()->waitForPendingUpdates();
+    waitForBackgroundThread(this->sw_);
+    waitForStateUpdates(this->sw_);
+  }
+
+  void verifyClassIDsHelper(
+      const std::vector<RoutePrefix<AddrT>>& routePrefixes,
+      std::optional<cfg ::AclLookupClass> classID) {
+    this->verifyStateUpdateAfterNeighborCachePropagation([=]() {
+      auto routeTableRib = sw_->getState()
+                               ->getRouteTables()
+                               ->getRouteTable(kRid())
+                               ->template getRib<AddrT>();
+      for (const auto& routePrefix : routePrefixes) {
+        auto route = routeTableRib->routes()->getRouteIf(routePrefix);
+        ASSERT_NE(route, nullptr);
+        EXPECT_EQ(route->getClassID(), classID);
+      }
+    });
+  }
+
   void removeNeighbor(const AddrT& ip) {
     this->updateState(
         "Add new route", [=](const std::shared_ptr<SwitchState>& state) {
@@ -447,6 +516,26 @@ TYPED_TEST(LookupClassRouteUpdaterTest, VerifyNeighborAddAndRemove) {
   this->verifyClassIDHelper(this->kroutePrefix2(), std::nullopt);
 }
 
+TYPED_TEST(LookupClassRouteUpdaterTest, ScaleNeighborResolveAndUnresolve) {
+  // Many routes sharing a nexthop: every route must be stamped (and cleared)
+  // when the nexthop resolves (and unresolves).
+  auto routePrefixes = this->scaleRoutePrefixes(2048);
+  this->addRoutes(routePrefixes, {this->kIpAddressA(), this->kIpAddressB()});
+  this->verifyClassIDsHelper(routePrefixes, std::nullopt);
+
+  this->resolveNeighbor(this->kIpAddressA(), this->kMacAddressA());
+  this->verifyClassIDsHelper(
+      routePrefixes, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_0);
+
+  this->resolveNeighbor(this->kIpAddressB(), this->kMacAddressB());
+  this->unresolveNeighbor(this->kIpAddressA());
+  this->verifyClassIDsHelper(
+      routePrefixes, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_1);
+
+  this->unresolveNeighbor(this->kIpAddressB());
+  this->verifyClassIDsHelper(routePrefixes, std::nullopt);
+}
+
 // Test cases verifying Port changes
 
 TYPED_TEST(LookupClassRouteUpdaterTest, PortLookupClassesToNoLookupClasses) {
@@ -22,12 +22,15 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
+#include <gflags/gflags.h>
 
 using folly::IPAddress;
 using folly::IPAddressV4;
 using folly::IPAddressV6;
 using folly::MacAddress;
 
+DECLARE_int32(mac_learning_flush_ms);
+
 namespace facebook::fboss {
 
 template <typename AddrT>
@@ -37,6 +40,9 @@ class LookupClassUpdaterTest : public ::testing::Test {
   using StateUpdateFn = SwSwitch::StateUpdateFn;
 
   void SetUp() override {
+    // Apply learned MACs as they arrive, resolveMac() does not wait for the
+    // learning flush timer
+    FLAGS_mac_learning_flush_ms = 0;
     handle_ = createTestHandle(testStateAWithLookupClasses());
     sw_ = handle_->getSw();
   }
@@ -290,6 +296,7 @@ class LookupClassUpdaterTest : public ::testing::Test {
     runInUpdateEventBaseAndWait([]() {});
   }
 
+  gflags::FlagSaver flagSaver_;
   std::unique_ptr<HwTestHandle> handle_;
   SwSwitch* sw_;
 };
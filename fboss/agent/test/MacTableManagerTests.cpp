@@ -11,22 +11,38 @@
 #include <gtest/gtest.h>
 
 #include "fboss/agent/L2Entry.h"
+#include "fboss/agent/MacTableManager.h"
+#include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/state/Port.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/test/CounterCache.h"
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/TestUtils.h"
 
 #include <folly/MacAddress.h>
+#include <gflags/gflags.h>
+
+DECLARE_int32(mac_learning_flush_ms);
+DECLARE_uint32(mac_learning_max_pending);
 
 namespace facebook::fboss {
 
+namespace {
+const std::string kFolded =
+    SwitchStats::kCounterPrefix + "mac_learning.folded.sum";
+const std::string kBackpressure =
+    SwitchStats::kCounterPrefix + "mac_learning.backpressure.sum";
+} // namespace
+
 class MacTableManagerTest : public ::testing::Test {
  public:
   using Func = folly::Function<void()>;
   using StateUpdateFn = SwSwitch::StateUpdateFn;
 
   void SetUp() override {
+    // Apply updates from the switch as they arrive
+    FLAGS_mac_learning_flush_ms = 0;
     handle_ = createTestHandle(testStateA());
     sw_ = handle_->getSw();
   }
@@ -55,6 +71,23 @@ class MacTableManagerTest : public ::testing::Test {
     return MacAddress("01:02:03:04:05:06");
   }
 
+  SwSwitch* sw() const {
+    return sw_;
+  }
+
+  L2Entry l2Entry(uint64_t mac, VlanID vlan) const {
+    return L2Entry(
+        folly::MacAddress::fromHBO(mac),
+        vlan,
+        PortDescriptor(kPortID()),
+        L2Entry::L2EntryType::L2_ENTRY_TYPE_PENDING);
+  }
+
+  bool isMacLearned(uint64_t mac, VlanID vlan) const {
+    auto macTable = sw_->getState()->getVlans()->getVlan(vlan)->getMacTable();
+    return macTable->getNodeIf(folly::MacAddress::fromHBO(mac)) != nullptr;
+  }
+
   void triggerMacLearnedCb() {
     triggerMacCbHelper(
         facebook::fboss::L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD);
@@ -110,6 +143,7 @@ class MacTableManagerTest : public ::testing::Test {
     waitForStateUpdates(sw_);
   }
 
+  gflags::FlagSaver flagSaver_;
   std::unique_ptr<HwTestHandle> handle_;
   SwSwitch* sw_;
 };
@@ -142,4 +176,61 @@ TEST_F(MacTableManagerTest, SameMacAgedCbTwice) {
   verifyMacIsDeleted();
 }
 
+TEST_F(MacTableManagerTest, LearningStorm) {
+  // Long enough to never expire during the test
+  FLAGS_mac_learning_flush_ms = 60 * 1000;
+  MacTableManager manager(sw());
+  CounterCache counters(sw());
+
+  constexpr uint64_t kNumMacs = 4096;
+  const auto kLearned = L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD;
+  const auto kAged = L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_DELETE;
+  // Learn every MAC on both VLANs, age out every other one, and learn every
+  // fourth one again
+  for (auto vlan : {VlanID(1), VlanID(55)}) {
+    for (uint64_t mac = 1; mac <= kNumMacs; ++mac) {
+      manager.handleL2LearningUpdate(l2Entry(mac, vlan), kLearned);
+    }
+    for (uint64_t mac = 2; mac <= kNumMacs; mac += 2) {
+      manager.handleL2LearningUpdate(l2Entry(mac, vlan), kAged);
+    }
+    for (uint64_t mac = 4; mac <= kNumMacs; mac += 4) {
+      manager.handleL2LearningUpdate(l2Entry(mac, vlan), kLearned);
+    }
+  }
+  manager.flush();
+  waitForStateUpdates(sw());
+
+  for (auto vlan : {VlanID(1), VlanID(55)}) {
+    auto macTable = sw()->getState()->getVlans()->getVlan(vlan)->getMacTable();
+    EXPECT_EQ(macTable->size(), kNumMacs / 2 + kNumMacs / 4);
+    for (uint64_t mac = 1; mac <= kNumMacs; ++mac) {
+      EXPECT_EQ(isMacLearned(mac, vlan), mac % 2 || mac % 4 == 0);
+    }
+  }
+  counters.update();
+  counters.checkDelta(kFolded, 2 * (kNumMacs / 2 + kNumMacs / 4));
+  counters.checkDelta(kBackpressure, 0);
+}
+
+TEST_F(MacTableManagerTest, LearningBackpressure) {
+  FLAGS_mac_learning_flush_ms = 60 * 1000;
+  FLAGS_mac_learning_max_pending = 100;
+  MacTableManager manager(sw());
+  CounterCache counters(sw());
+
+  for (uint64_t mac = 1; mac <= 1000; ++mac) {
+    manager.handleL2LearningUpdate(
+        l2Entry(mac, kVlan()), L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD);
+  }
+  // Full buffers are applied without waiting for the flush interval
+  waitForStateUpdates(sw());
+
+  auto vlan = sw()->getState()->getVlans()->getVlan(kVlan());
+  EXPECT_EQ(vlan->getMacTable()->size(), 1000);
+  counters.update();
+  counters.checkDelta(kFolded, 0);
+  counters.checkDelta(kBackpressure, 10);
+}
+
 } // namespace facebook::fboss
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/NeighborResolutionLimiter.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/test/CounterCache.h"
+#include "fboss/agent/test/HwTestHandle.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/Format.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using folly::IPAddress;
+
+DECLARE_int32(neighbor_resolution_dedup_ms);
+DECLARE_uint32(neighbor_resolution_rate);
+DECLARE_uint32(neighbor_resolution_burst);
+
+namespace {
+const std::string kDeduped =
+    SwitchStats::kCounterPrefix + "neighbor.resolution.deduped.sum";
+const std::string kRateLimited =
+    SwitchStats::kCounterPrefix + "neighbor.resolution.rate_limited.sum";
+} // namespace
+
+TEST(NeighborResolutionLimiter, dedup) {
+  gflags::FlagSaver flagSaver;
+  // Long enough to never expire during the test
+  FLAGS_neighbor_resolution_dedup_ms = 60 * 1000;
+  auto handle = createTestHandle();
+  auto sw = handle->getSw();
+  CounterCache counters(sw);
+
+  NeighborResolutionLimiter limiter;
+  IPAddress v4("10.0.0.10");
+  IPAddress v6("2401:db00:2110:3001::10");
+  EXPECT_TRUE(limiter.shouldSend(VlanID(1), v4, sw->stats()));
+  EXPECT_TRUE(limiter.shouldSend(VlanID(1), v6, sw->stats()));
+  // Same address on another VLAN is a different neighbor
+  EXPECT_TRUE(limiter.shouldSend(VlanID(2), v4, sw->stats()));
+  EXPECT_FALSE(limiter.shouldSend(VlanID(1), v4, sw->stats()));
+  EXPECT_FALSE(limiter.shouldSend(VlanID(1), v6, sw->stats()));
+  EXPECT_EQ(limiter.inFlight(), 3);
+
+  counters.update();
+  counters.checkDelta(kDeduped, 2);
+  counters.checkDelta(kRateLimited, 0);
+
+  // Once resolved, the next request goes out right away
+  limiter.resolutionDone(VlanID(1), v4);
+  EXPECT_EQ(limiter.inFlight(), 2);
+  EXPECT_TRUE(limiter.shouldSend(VlanID(1), v4, sw->stats()));
+}
+
+TEST(NeighborResolutionLimiter, dedupExpires) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_neighbor_resolution_dedup_ms = 0;
+  auto handle = createTestHandle();
+  auto sw = handle->getSw();
+
+  NeighborResolutionLimiter limiter;
+  IPAddress v4("10.0.0.10");
+  EXPECT_TRUE(limiter.shouldSend(VlanID(1), v4, sw->stats()));
+  EXPECT_TRUE(limiter.shouldSend(VlanID(1), v4, sw->stats()));
+}
+
+TEST(NeighborResolutionLimiter, rateLimit) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_neighbor_resolution_dedup_ms = 60 * 1000;
+  // Effectively no refill during the test
+  FLAGS_neighbor_resolution_rate = 1;
+  FLAGS_neighbor_resolution_burst = 4;
+  auto handle = createTestHandle();
+  auto sw = handle->getSw();
+  CounterCache counters(sw);
+
+  NeighborResolutionLimiter limiter;
+  auto numSent = 0;
+  for (auto i = 1; i <= 10; ++i) {
+    auto ip = IPAddress(folly::sformat("10.0.0.{}", i));
+    numSent += limiter.shouldSend(VlanID(1), ip, sw->stats());
+  }
+  EXPECT_EQ(numSent, 4);
+  // Rate limited requests aren't in flight, so they are retried later
+  EXPECT_EQ(limiter.inFlight(), 4);
+
+  counters.update();
+  counters.checkDelta(kDeduped, 0);
+  counters.checkDelta(kRateLimited, 6);
+}
@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/NetlinkBatch.h"
+
+#include <folly/io/async/EventBase.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+extern "C" {
+#include <linux/fib_rules.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <netlink/msg.h>
+}
+
+using namespace facebook::fboss;
+
+namespace {
+
+// The kernel ACKs a NOOP request successfully, whatever our privileges
+struct nl_msg* noopRequest() {
+  return nlmsg_alloc_simple(NLMSG_NOOP, 0);
+}
+
+// A rule delete for an unknown address family is always rejected
+struct nl_msg* badRequest() {
+  auto msg = nlmsg_alloc_simple(RTM_DELRULE, 0);
+  struct fib_rule_hdr hdr = {};
+  hdr.family = 250;
+  nlmsg_append(msg, &hdr, sizeof(hdr), NLMSG_ALIGNTO);
+  return msg;
+}
+
+} // namespace
+
+TEST(NetlinkBatchTest, AcksInRequestOrder) {
+  folly::EventBase evb;
+  NetlinkBatch batch(&evb);
+
+  // Enough requests for many chunks, and more ACKs than would fit in the
+  // socket receive buffer at once
+  const int kNumRequests = 5000;
+  std::vector<int> acked;
+  for (int i = 0; i < kNumRequests; ++i) {
+    batch.add(noopRequest(), [&acked, i](int error) {
+      EXPECT_EQ(0, error);
+      acked.push_back(i);
+    });
+  }
+  EXPECT_EQ(kNumRequests, batch.pending());
+  batch.flushAndWait();
+
+  EXPECT_EQ(0, batch.pending());
+  ASSERT_EQ(kNumRequests, acked.size());
+  for (int i = 0; i < kNumRequests; ++i) {
+    EXPECT_EQ(i, acked[i]);
+  }
+}
+
+TEST(NetlinkBatchTest, FlushAndWaitWithRequestsInFlight) {
+  // TunManager removes an interface's rules and routes while requests of
+  // earlier changes may still be in flight, and must not delete the
+  // interface before the kernel processed them.
+  folly::EventBase evb;
+  NetlinkBatch batch(&evb);
+
+  std::vector<int> acked;
+  for (int i = 0; i < 10; ++i) {
+    batch.add(noopRequest(), [&acked, i](int) { acked.push_back(i); });
+  }
+  // Sent, but ACKs are not read as the EventBase does not loop
+  batch.flush();
+  for (int i = 10; i < 20; ++i) {
+    batch.add(noopRequest(), [&acked, i](int) { acked.push_back(i); });
+  }
+  batch.flushAndWait();
+
+  EXPECT_EQ(0, batch.pending());
+  ASSERT_EQ(20, acked.size());
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(i, acked[i]);
+  }
+}
+
+TEST(NetlinkBatchTest, AcksReadOnEventBase) {
+  folly::EventBase evb;
+  NetlinkBatch batch(&evb);
+
+  const int kNumRequests = 5000;
+  int numAcked = 0;
+  for (int i = 0; i < kNumRequests; ++i) {
+    batch.add(noopRequest(), [&numAcked](int) { ++numAcked; });
+  }
+  batch.flush();
+  while (batch.pending() > 0) {
+    evb.loopOnce();
+  }
+  EXPECT_EQ(kNumRequests, numAcked);
+}
+
+TEST(NetlinkBatchTest, ErrorsReportedPerRequest) {
+  folly::EventBase evb;
+  NetlinkBatch batch(&evb);
+
+  std::vector<int> errors;
+  batch.add(noopRequest(), [&errors](int error) { errors.push_back(error); });
+  batch.add(badRequest(), [&errors](int error) { errors.push_back(error); });
+  batch.add(noopRequest(), [&errors](int error) { errors.push_back(error); });
+  batch.flushAndWait();
+
+  ASSERT_EQ(3, errors.size());
+  EXPECT_EQ(0, errors[0]);
+  EXPECT_LT(errors[1], 0);
+  EXPECT_EQ(0, errors[2]);
+}
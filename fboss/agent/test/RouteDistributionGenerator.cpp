@@ -18,7 +18,11 @@
 #include "fboss/agent/test/ResourceLibUtil.h"
 
 #include <glog/logging.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <optional>
+#include <thread>
 
 namespace {
 
@@ -64,19 +68,70 @@ const RouteDistributionGenerator::RouteChunks& RouteDistributionGenerator::get()
   if (generatedRouteChunks_) {
     return *generatedRouteChunks_;
   }
-  generatedRouteChunks_ = RouteChunks();
-  genRouteDistribution<folly::IPAddressV6>(v6DistributionSpec_);
-  genRouteDistribution<folly::IPAddressV4>(v4DistributionSpec_);
+
+  // Lay out every bucket (one per address family and mask length) at its
+  // offset in the final route order, so buckets can be generated
+  // independently of each other.
+  std::vector<std::function<void()>> buckets;
+  size_t totalRoutes = 0;
+  auto v6Nhops = v6DistributionSpec_.empty()
+      ? std::vector<folly::IPAddress>{}
+      : getNhops<folly::IPAddressV6>();
+  auto v4Nhops = v4DistributionSpec_.empty()
+      ? std::vector<folly::IPAddress>{}
+      : getNhops<folly::IPAddressV4>();
+  for (const auto& maskLenAndNumPrefixes : v6DistributionSpec_) {
+    buckets.emplace_back(
+        [this, maskLenAndNumPrefixes, totalRoutes, &v6Nhops]() {
+          genRoutes<folly::IPAddressV6>(
+              maskLenAndNumPrefixes.first,
+              maskLenAndNumPrefixes.second,
+              totalRoutes,
+              v6Nhops);
+        });
+    totalRoutes += maskLenAndNumPrefixes.second;
+  }
+  for (const auto& maskLenAndNumPrefixes : v4DistributionSpec_) {
+    buckets.emplace_back(
+        [this, maskLenAndNumPrefixes, totalRoutes, &v4Nhops]() {
+          genRoutes<folly::IPAddressV4>(
+              maskLenAndNumPrefixes.first,
+              maskLenAndNumPrefixes.second,
+              totalRoutes,
+              v4Nhops);
+        });
+    totalRoutes += maskLenAndNumPrefixes.second;
+  }
+
+  generatedRouteChunks_ =
+      RouteChunks((totalRoutes + chunkSize_ - 1) / chunkSize_);
+  for (auto i = 0; i < generatedRouteChunks_->size(); ++i) {
+    (*generatedRouteChunks_)[i].resize(
+        std::min<size_t>(chunkSize_, totalRoutes - i * chunkSize_));
+  }
+
+  std::atomic<size_t> nextBucket{0};
+  auto worker = [&buckets, &nextBucket]() {
+    for (auto i = nextBucket++; i < buckets.size(); i = nextBucket++) {
+      buckets[i]();
+    }
+  };
+  auto numThreads = std::min<size_t>(
+      buckets.size(), std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::thread> threads;
+  for (auto i = 1; i < numThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
   return *generatedRouteChunks_;
 }
 
 template <typename AddrT>
-const std::vector<folly::IPAddress>& RouteDistributionGenerator::getNhops()
-    const {
-  static std::vector<folly::IPAddress> nhops;
-  if (nhops.size()) {
-    return nhops;
-  }
+std::vector<folly::IPAddress> RouteDistributionGenerator::getNhops() const {
+  std::vector<folly::IPAddress> nhops;
   EcmpSetupAnyNPorts<AddrT> ecmpHelper(startingState_, routerId_);
   for (auto i = 0; i < ecmpWidth_; ++i) {
     nhops.emplace_back(folly::IPAddress(ecmpHelper.nhop(i).ip));
@@ -85,21 +140,18 @@ const std::vector<folly::IPAddress>& RouteDistributionGenerator::getNhops()
 }
 
 template <typename AddrT>
-void RouteDistributionGenerator::genRouteDistribution(
-    const Masklen2NumPrefixes& routeDistribution) const {
-  for (const auto& maskLenAndNumPrefixes : routeDistribution) {
-    auto prefixGenerator = PrefixGenerator<AddrT>(maskLenAndNumPrefixes.first);
-    for (auto i = 0; i < maskLenAndNumPrefixes.second; ++i) {
-      if (generatedRouteChunks_->empty() ||
-          generatedRouteChunks_->back().size() == chunkSize_) {
-        // Last chunk was full or we are just staring.
-        // Start a new one
-        generatedRouteChunks_->emplace_back(RouteChunk{});
-      }
-      generatedRouteChunks_->back().emplace_back(
-          Route{getNewPrefix(prefixGenerator, startingState_, routerId_),
-                getNhops<AddrT>()});
-    }
+void RouteDistributionGenerator::genRoutes(
+    uint8_t mask,
+    uint32_t numPrefixes,
+    size_t startIndex,
+    const std::vector<folly::IPAddress>& nhops) const {
+  // Only reads the (published) starting state and writes to the slots
+  // reserved for this bucket, so this is safe to run concurrently.
+  auto prefixGenerator = PrefixGenerator<AddrT>(mask);
+  for (size_t i = startIndex; i < startIndex + numPrefixes; ++i) {
+    auto& route = (*generatedRouteChunks_)[i / chunkSize_][i % chunkSize_];
+    route.prefix = getNewPrefix(prefixGenerator, startingState_, routerId_);
+    route.nhops = nhops;
   }
 }
 
@@ -123,6 +175,8 @@ RouteDistributionGenerator::getSwitchStates() const {
   for (const auto& routeChunk : get()) {
     std::vector<RoutePrefixV6> v6Prefixes;
     std::vector<RoutePrefixV4> v4Prefixes;
+    v6Prefixes.reserve(routeChunk.size());
+    v4Prefixes.reserve(routeChunk.size());
     for (const auto& route : routeChunk) {
       const auto& cidrNetwork = route.prefix;
       if (cidrNetwork.first.isV6()) {
@@ -29,6 +29,10 @@ using Masklen2NumPrefixes = std::map<uint8_t, uint32_t>;
  * RouteDistributionGenerator takes a input state, distribution spec and
  * chunk size to generate a vector of vector<Routes> (chunk) satisfying that
  * distribution spec and chunk size.
+ *
+ * Chunks are sized upfront and each (address family, mask length) bucket of
+ * the spec is generated on its own thread, writing straight into its slots.
+ * The resulting route order is the same as generating the buckets serially.
  */
 class RouteDistributionGenerator {
  public:
@@ -65,9 +69,13 @@ class RouteDistributionGenerator {
 
  private:
   template <typename AddrT>
-  const std::vector<folly::IPAddress>& getNhops() const;
-  template <typename AddT>
-  void genRouteDistribution(const Masklen2NumPrefixes& routeDistribution) const;
+  std::vector<folly::IPAddress> getNhops() const;
+  template <typename AddrT>
+  void genRoutes(
+      uint8_t mask,
+      uint32_t numPrefixes,
+      size_t startIndex,
+      const std::vector<folly::IPAddress>& nhops) const;
 
   const std::shared_ptr<SwitchState> startingState_;
   const Masklen2NumPrefixes v6DistributionSpec_;
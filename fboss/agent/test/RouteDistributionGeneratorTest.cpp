@@ -14,6 +14,8 @@
 #include "fboss/agent/test/RouteDistributionGenerator.h"
 #include "fboss/agent/test/RouteGeneratorTestUtils.h"
 
+#include <set>
+
 namespace facebook::fboss {
 
 TEST(RouteDistributionGeneratorsTest, v4AndV6DistributionSingleChunk) {
@@ -127,4 +129,40 @@ TEST(RouteDistributionGeneratorsTest, emptyV4AndV6Distribution) {
   verifyChunking(routeDistributionSwitchStatesGen, 0, 5);
 }
 
+TEST(RouteDistributionGeneratorsTest, routesInDistributionOrder) {
+  auto mockPlatform = std::make_unique<testing::NiceMock<MockPlatform>>();
+  utility::Masklen2NumPrefixes v6Distribution{
+      {64, 100}, {65, 100}, {127, 100}, {128, 100}};
+  utility::Masklen2NumPrefixes v4Distribution{
+      {24, 100}, {25, 100}, {31, 100}, {32, 100}};
+  auto routeDistributionSwitchStatesGen = utility::RouteDistributionGenerator(
+      createTestState(mockPlatform.get()),
+      v6Distribution,
+      v4Distribution,
+      33,
+      2);
+
+  // Buckets are generated concurrently, but routes must still come out
+  // ordered by address family and mask length, without duplicates.
+  std::vector<std::pair<bool, uint8_t>> expected;
+  for (const auto& [mask, numPrefixes] : v6Distribution) {
+    expected.insert(expected.end(), numPrefixes, {true, mask});
+  }
+  for (const auto& [mask, numPrefixes] : v4Distribution) {
+    expected.insert(expected.end(), numPrefixes, {false, mask});
+  }
+  std::vector<std::pair<bool, uint8_t>> generated;
+  std::set<folly::CIDRNetwork> prefixes;
+  for (const auto& routeChunk : routeDistributionSwitchStatesGen.get()) {
+    for (const auto& route : routeChunk) {
+      generated.emplace_back(route.prefix.first.isV6(), route.prefix.second);
+      prefixes.insert(route.prefix);
+      EXPECT_EQ(route.nhops.size(), 2);
+    }
+  }
+  EXPECT_EQ(generated, expected);
+  EXPECT_EQ(prefixes.size(), expected.size());
+  verifyChunking(routeDistributionSwitchStatesGen.get(), expected.size(), 33);
+}
+
 } // namespace facebook::fboss
@@ -17,10 +17,14 @@
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/TestUtils.h"
 
+#include <folly/synchronization/Baton.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 #include <memory>
 #include <vector>
 
+DECLARE_int32(route_update_log_queue_size);
+
 using namespace facebook::fboss;
 
 namespace {
@@ -52,6 +56,23 @@ class MockRouteLogger : public RouteLogger<AddrT> {
   std::vector<std::pair<std::string, std::string>> changed;
 };
 
+// Holds up the logging thread until unblocked
+class BlockingRouteLogger : public MockRouteLogger<folly::IPAddressV4> {
+ public:
+  explicit BlockingRouteLogger(folly::Baton<>* unblocked)
+      : unblocked_(unblocked) {}
+
+  void logAddedRoute(
+      const std::shared_ptr<Route<folly::IPAddressV4>>& newRoute,
+      const std::vector<std::string>& identifiers) override {
+    unblocked_->wait();
+    MockRouteLogger<folly::IPAddressV4>::logAddedRoute(newRoute, identifiers);
+  }
+
+ private:
+  folly::Baton<>* unblocked_;
+};
+
 class MockMplsRouteLogger : public MplsRouteLogger {
  public:
   void logAddedRoute(
@@ -168,6 +189,12 @@ class RouteUpdateLoggerTest : public ::testing::Test {
     routeUpdateLogger->stopLoggingForLabel(label, identifier);
   }
 
+  // Logging happens on the logger's own thread, wait for it to catch up
+  void stateUpdated(const StateDelta& delta) {
+    routeUpdateLogger->stateUpdated(delta);
+    routeUpdateLogger->flush();
+  }
+
   void logAllRouteUpdates() {
     startLogging("::", 0);
     startLogging("0.0.0.0", 0);
@@ -239,7 +266,7 @@ class RouteUpdateLoggerTest : public ::testing::Test {
 // Adding some routes will get logged correctly
 TEST_F(RouteUpdateLoggerTest, LogAdded) {
   logAllRouteUpdates();
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(5, mockRouteLoggerV4->added.size());
   EXPECT_EQ(3, mockRouteLoggerV6->added.size());
   // Default route changes
@@ -251,7 +278,7 @@ TEST_F(RouteUpdateLoggerTest, LogAdded) {
 // Removing some routes will get logged correctly
 TEST_F(RouteUpdateLoggerTest, LogRemoved) {
   logAllRouteUpdates();
-  routeUpdateLogger->stateUpdated(*deltaRemove);
+  stateUpdated(*deltaRemove);
   EXPECT_EQ(5, mockRouteLoggerV4->removed.size());
   EXPECT_EQ(3, mockRouteLoggerV6->removed.size());
   // Default route changes
@@ -262,8 +289,8 @@ TEST_F(RouteUpdateLoggerTest, LogRemoved) {
 
 // If no logging is enabled, nothing gets logged
 TEST_F(RouteUpdateLoggerTest, LogUntracked) {
-  routeUpdateLogger->stateUpdated(*deltaAdd);
-  routeUpdateLogger->stateUpdated(*deltaRemove);
+  stateUpdated(*deltaAdd);
+  stateUpdated(*deltaRemove);
   expectNoLogging();
 }
 
@@ -271,7 +298,7 @@ TEST_F(RouteUpdateLoggerTest, LogUntracked) {
 TEST_F(RouteUpdateLoggerTest, TrackWrongPrefix) {
   startLogging("1:1:1:1::", 64);
   startLogging("1.1.1.1", 16);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   expectNoChanged();
 }
 
@@ -280,7 +307,7 @@ TEST_F(RouteUpdateLoggerTest, TrackWrongPrefix) {
 TEST_F(RouteUpdateLoggerTest, LogTrackedPrefix) {
   startLogging("192.168.0.0", 24);
   startLogging("2401:db00:2110:3001::", 64);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(1, mockRouteLoggerV4->added.size());
   EXPECT_EQ(1, mockRouteLoggerV6->added.size());
 }
@@ -289,7 +316,7 @@ TEST_F(RouteUpdateLoggerTest, LogTrackedPrefix) {
 TEST_F(RouteUpdateLoggerTest, MoreSpecificPrefix) {
   startLogging("192.168.0.0", 16);
   startLogging("2401:db00::", 32);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
 }
@@ -299,7 +326,7 @@ TEST_F(RouteUpdateLoggerTest, MoreSpecificPrefix) {
 TEST_F(RouteUpdateLoggerTest, MoreSpecificPrefixExactLogging) {
   startLogging("192.168.0.0", 16, "", true);
   startLogging("2401:db00::", 32, "", true);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   expectNoChanged();
   expectNoRemoved();
 }
@@ -308,15 +335,15 @@ TEST_F(RouteUpdateLoggerTest, MoreSpecificPrefixExactLogging) {
 TEST_F(RouteUpdateLoggerTest, StopLogging) {
   startLogging("192.168.0.0", 16);
   startLogging("2401:db00::", 32);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   stopLogging("2401:db00::", 32);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(4, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   stopLogging("192.168.0.0", 16);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(4, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   expectNoChanged();
@@ -327,16 +354,16 @@ TEST_F(RouteUpdateLoggerTest, StopLogging) {
 TEST_F(RouteUpdateLoggerTest, RestartLogging) {
   startLogging("192.168.0.0", 16);
   startLogging("2401:db00::", 32);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   stopLogging("192.168.0.0", 16);
   stopLogging("2401:db00::", 32);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   startLogging("2401:db00::", 32);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(4, mockRouteLoggerV6->added.size());
   expectNoChanged();
@@ -348,12 +375,12 @@ TEST_F(RouteUpdateLoggerTest, RestartLogging) {
 TEST_F(RouteUpdateLoggerTest, SwitchToExact) {
   startLogging("192.168.0.0", 16);
   startLogging("2401:db00::", 32);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   startLogging("192.168.0.0", 16, "", true);
   startLogging("2401:db00::", 32, "", true);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   expectNoChanged();
@@ -365,11 +392,11 @@ TEST_F(RouteUpdateLoggerTest, SwitchToExact) {
 TEST_F(RouteUpdateLoggerTest, SwitchToAllowMoreSpecific) {
   startLogging("192.168.0.0", 16, "", true);
   startLogging("2401:db00::", 32, "", true);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   expectNoLogging();
   startLogging("192.168.0.0", 16);
   startLogging("2401:db00::", 32);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   expectNoChanged();
@@ -380,7 +407,7 @@ TEST_F(RouteUpdateLoggerTest, SwitchToAllowMoreSpecific) {
 TEST_F(RouteUpdateLoggerTest, StartLoggingFromDifferentUsers) {
   startLogging("192.168.0.0", 16, "foo", false);
   startLogging("2401:db00::", 32, "bar", false);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   expectNoChanged();
@@ -391,15 +418,15 @@ TEST_F(RouteUpdateLoggerTest, StartLoggingFromDifferentUsers) {
 TEST_F(RouteUpdateLoggerTest, StopForOneUser) {
   startLogging("2401:db00::", 32, "foo", false);
   startLogging("2401:db00::", 32, "bar", false);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(0, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   stopLogging("2401:db00::", 32, "bar");
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(0, mockRouteLoggerV4->added.size());
   EXPECT_EQ(4, mockRouteLoggerV6->added.size());
   stopLogging("2401:db00::", 32, "foo");
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(0, mockRouteLoggerV4->added.size());
   EXPECT_EQ(4, mockRouteLoggerV6->added.size());
   expectNoChanged();
@@ -411,11 +438,11 @@ TEST_F(RouteUpdateLoggerTest, ClearForOneUser) {
   startLogging("192.168.0.0", 16, "foo", false);
   startLogging("2401:db00::", 32, "foo", false);
   startLogging("2401:db00::", 32, "bar", false);
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(2, mockRouteLoggerV6->added.size());
   routeUpdateLogger->stopLoggingForIdentifier("foo");
-  routeUpdateLogger->stateUpdated(*deltaAdd);
+  stateUpdated(*deltaAdd);
   EXPECT_EQ(2, mockRouteLoggerV4->added.size());
   EXPECT_EQ(4, mockRouteLoggerV6->added.size());
 }
@@ -429,7 +456,7 @@ TEST_F(RouteUpdateLoggerTest, LabelAdded) {
   state = addLabel(state, 200);
   state = addLabel(state, 300);
 
-  routeUpdateLogger->stateUpdated(StateDelta(initState, state));
+  stateUpdated(StateDelta(initState, state));
   EXPECT_EQ(3, mockMplsRouteLogger->added.size());
 }
 
@@ -441,11 +468,11 @@ TEST_F(RouteUpdateLoggerTest, LabelRemoved) {
   auto state = addLabel(initState, 100);
   state = addLabel(state, 200);
   state = addLabel(state, 300);
-  routeUpdateLogger->stateUpdated(StateDelta(initState, state));
+  stateUpdated(StateDelta(initState, state));
   EXPECT_EQ(3, mockMplsRouteLogger->added.size());
 
   auto newState = removeLabel(state, 300);
-  routeUpdateLogger->stateUpdated(StateDelta(state, newState));
+  stateUpdated(StateDelta(state, newState));
   EXPECT_EQ(1, mockMplsRouteLogger->removed.size());
 }
 
@@ -453,11 +480,11 @@ TEST_F(RouteUpdateLoggerTest, LabelChanged) {
   startLogging(100);
 
   auto state = addLabel(initState, 100);
-  routeUpdateLogger->stateUpdated(StateDelta(initState, state));
+  stateUpdated(StateDelta(initState, state));
   EXPECT_EQ(1, mockMplsRouteLogger->added.size());
   auto newState = removeLabel(state, 100);
   newState = addLabel(newState, 100, ClientID::STATIC_ROUTE);
-  routeUpdateLogger->stateUpdated(StateDelta(state, newState));
+  stateUpdated(StateDelta(state, newState));
   EXPECT_EQ(1, mockMplsRouteLogger->changed.size());
 }
 
@@ -469,13 +496,13 @@ TEST_F(RouteUpdateLoggerTest, MultipleSubscribers) {
   auto state = addLabel(initState, 100);
   state = addLabel(state, 200);
 
-  routeUpdateLogger->stateUpdated(StateDelta(initState, state));
+  stateUpdated(StateDelta(initState, state));
   EXPECT_EQ(1, mockMplsRouteLogger->added.size());
   EXPECT_EQ(3, mockMplsRouteLogger->addedFor.size());
 
   stopLogging(100, "foo");
   auto newState = removeLabel(state, 100);
-  routeUpdateLogger->stateUpdated(StateDelta(state, newState));
+  stateUpdated(StateDelta(state, newState));
   EXPECT_EQ(1, mockMplsRouteLogger->removed.size());
   EXPECT_EQ(2, mockMplsRouteLogger->removedFor.size());
 
@@ -484,7 +511,7 @@ TEST_F(RouteUpdateLoggerTest, MultipleSubscribers) {
   startLogging(200, "foobar");
   auto anotherNewState = removeLabel(newState, 200);
   anotherNewState = addLabel(anotherNewState, 200, ClientID::STATIC_ROUTE);
-  routeUpdateLogger->stateUpdated(StateDelta(newState, anotherNewState));
+  stateUpdated(StateDelta(newState, anotherNewState));
   EXPECT_EQ(1, mockMplsRouteLogger->changed.size());
   EXPECT_EQ(3, mockMplsRouteLogger->changedFor.size());
 
@@ -495,7 +522,7 @@ TEST_F(RouteUpdateLoggerTest, MultipleSubscribers) {
       removeLabel(anotherNewState, 200, ClientID::STATIC_ROUTE);
   oneMoreNewState = addLabel(oneMoreNewState, 200);
 
-  routeUpdateLogger->stateUpdated(StateDelta(anotherNewState, oneMoreNewState));
+  stateUpdated(StateDelta(anotherNewState, oneMoreNewState));
   EXPECT_EQ(1, mockMplsRouteLogger->changed.size());
   EXPECT_EQ(2, mockMplsRouteLogger->changedFor.size());
 }
@@ -508,15 +535,41 @@ TEST_F(RouteUpdateLoggerTest, TrackAllLabelsManySubscribers) {
   state = addLabel(state, 200);
   state = addLabel(state, 300);
 
-  routeUpdateLogger->stateUpdated(StateDelta(initState, state));
+  stateUpdated(StateDelta(initState, state));
   EXPECT_EQ(3, mockMplsRouteLogger->added.size());
   EXPECT_EQ(6, mockMplsRouteLogger->addedFor.size());
 
   stopLogging(-1, "bar");
   auto newState = removeLabel(state, 100);
   newState = addLabel(newState, 100, ClientID::STATIC_ROUTE);
-  routeUpdateLogger->stateUpdated(StateDelta(state, newState));
+  stateUpdated(StateDelta(state, newState));
   EXPECT_EQ(1, mockMplsRouteLogger->changed.size());
   EXPECT_EQ(1, mockMplsRouteLogger->changedFor.size());
 }
+
+TEST_F(RouteUpdateLoggerTest, DropWhenQueueFull) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_route_update_log_queue_size = 1;
+
+  folly::Baton<> unblocked;
+  auto blockingLogger = std::make_unique<BlockingRouteLogger>(&unblocked);
+  auto blockingLoggerPtr = blockingLogger.get();
+  RouteUpdateLogger logger(
+      sw,
+      std::move(blockingLogger),
+      std::make_unique<MockRouteLogger<folly::IPAddressV6>>(),
+      std::make_unique<MockMplsRouteLogger>());
+  RoutePrefix<folly::IPAddress> prefix{folly::IPAddress{"0.0.0.0"}, 0};
+  logger.startLoggingForPrefix(RouteUpdateLoggingInstance(prefix, "", false));
+
+  // 5 v4 routes get added. With the logging thread stuck on the first one
+  // and room for one more in the queue, the rest must be dropped rather than
+  // block the update.
+  logger.stateUpdated(*deltaAdd);
+  unblocked.post();
+  logger.flush();
+
+  EXPECT_GE(logger.getDroppedUpdates(), 3);
+  EXPECT_EQ(5, blockingLoggerPtr->added.size() + logger.getDroppedUpdates());
+}
 } // namespace
@@ -14,6 +14,7 @@
 #include "fboss/agent/Main.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/PortStats.h"
+#include "fboss/agent/StateObserver.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/state/ArpTable.h"
 #include "fboss/agent/state/Interface.h"
@@ -27,8 +28,12 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
+#include <folly/Synchronized.h>
+#include <folly/synchronization/Baton.h>
+#include <gflags/gflags.h>
 
 #include <algorithm>
+#include <thread>
 
 using namespace facebook::fboss;
 using folly::IPAddressV4;
@@ -38,6 +43,42 @@ using std::string;
 using ::testing::_;
 using ::testing::Return;
 
+DECLARE_int32(state_observer_threads);
+
+namespace {
+// Records the order it is notified in, and whether it ran on the update thread
+class OrderedStateObserver : public AutoRegisterStateObserver {
+ public:
+  OrderedStateObserver(
+      SwSwitch* sw,
+      const std::string& name,
+      std::vector<std::string> after,
+      folly::Synchronized<std::vector<std::pair<std::string, bool>>>* notified)
+      : AutoRegisterStateObserver(sw, name),
+        sw_(sw),
+        name_(name),
+        after_(std::move(after)),
+        notified_(notified) {}
+
+  void stateUpdated(const StateDelta& /*delta*/) override {
+    notified_->wlock()->emplace_back(
+        name_, sw_->getUpdateEvb()->isInEventBaseThread());
+  }
+  bool notifyConcurrently() const override {
+    return true;
+  }
+  std::vector<std::string> notifyAfter() const override {
+    return after_;
+  }
+
+ private:
+  SwSwitch* sw_;
+  std::string name_;
+  std::vector<std::string> after_;
+  folly::Synchronized<std::vector<std::pair<std::string, bool>>>* notified_;
+};
+} // namespace
+
 class SwSwitchTest : public ::testing::Test {
  public:
   void SetUp() override {
@@ -77,6 +118,47 @@ TEST_F(SwSwitchTest, GetPortStats) {
   EXPECT_EQ(sw->stats()->getPortStats()->size(), 2);
   EXPECT_EQ(portStats->getPortName(), "port0");
 }
+
+TEST_F(SwSwitchTest, DeletePortStats) {
+  auto portStats = sw->portStats(PortID(5));
+  EXPECT_EQ(sw->stats()->port(PortID(5)), portStats);
+  EXPECT_EQ(sw->stats()->port(PortID(4)), nullptr);
+  EXPECT_EQ(sw->stats()->port(PortID(1000)), nullptr);
+
+  sw->stats()->deletePortStats(PortID(5));
+  EXPECT_EQ(sw->stats()->port(PortID(5)), nullptr);
+  EXPECT_EQ(sw->stats()->getPortStats()->size(), 0);
+}
+
+TEST_F(SwSwitchTest, PacketCountersFromAllThreads) {
+  CounterCache counters(sw);
+
+  sw->portStats(PortID(5))->trappedPkt();
+  sw->portStats(PortID(5))->pktToHost(100);
+  // Counted on another thread, which is still running when counters are
+  // published
+  folly::Baton<> counted;
+  folly::Baton<> published;
+  std::thread otherThread([&]() {
+    sw->portStats(PortID(5))->trappedPkt();
+    sw->portStats(PortID(5))->pktBogus();
+    counted.post();
+    published.wait();
+  });
+  counted.wait();
+
+  counters.update();
+  published.post();
+  otherThread.join();
+  counters.checkDelta(SwitchStats::kCounterPrefix + "trapped.pkts.sum", 2);
+  counters.checkDelta(SwitchStats::kCounterPrefix + "trapped.bogus.sum", 1);
+  counters.checkDelta(SwitchStats::kCounterPrefix + "trapped.drops.sum", 1);
+  counters.checkDelta(SwitchStats::kCounterPrefix + "host.rx.bytes.sum", 100);
+
+  // Already flushed counts are not added again
+  counters.update();
+  counters.checkDelta(SwitchStats::kCounterPrefix + "trapped.pkts.sum", 0);
+}
 ACTION(ThrowException) {
   throw std::exception();
 }
@@ -185,3 +267,46 @@ TEST_F(SwSwitchTest, TestStateNonCoalescing) {
   // 0 neighbor entries expected, i.e. entries must be purged
   verifyReachableCnt(0);
 }
+
+TEST_F(SwSwitchTest, ConcurrentStateObserversHonorOrdering) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_state_observer_threads = 4;
+  // The state observer threads are created along with the switch
+  auto concurrentHandle = createTestHandle(testStateA());
+  auto concurrentSw = concurrentHandle->getSw();
+  concurrentSw->initialConfigApplied(std::chrono::steady_clock::now());
+
+  folly::Synchronized<std::vector<std::pair<std::string, bool>>> notified;
+  // Register the dependent observer first, so registration order can not
+  // be what orders them
+  OrderedStateObserver second(concurrentSw, "second", {"first"}, &notified);
+  OrderedStateObserver first(concurrentSw, "first", {}, &notified);
+
+  concurrentSw->updateStateBlocking("Bring Ports Up", [](const auto& state) {
+    return bringAllPortsUp(state);
+  });
+
+  // Later updates triggered by this one may notify them again
+  auto notifiedLocked = notified.rlock();
+  ASSERT_GE(notifiedLocked->size(), 2);
+  std::vector<std::pair<std::string, bool>> expected{
+      {"first", false}, {"second", false}};
+  EXPECT_EQ(
+      expected,
+      std::vector<std::pair<std::string, bool>>(
+          notifiedLocked->begin(), notifiedLocked->begin() + 2));
+}
+
+TEST_F(SwSwitchTest, StateObserversNotifiedSeriallyByDefault) {
+  folly::Synchronized<std::vector<std::pair<std::string, bool>>> notified;
+  OrderedStateObserver observer(sw, "observer", {}, &notified);
+
+  sw->updateStateBlocking("Bring Ports Up", [](const auto& state) {
+    return bringAllPortsUp(state);
+  });
+
+  auto notifiedLocked = notified.rlock();
+  ASSERT_GE(notifiedLocked->size(), 1);
+  // Opting in is not enough without state observer threads
+  EXPECT_TRUE(notifiedLocked->front().second);
+}
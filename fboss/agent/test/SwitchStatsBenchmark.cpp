@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <boost/container/flat_map.hpp>
+
+#include <fb303/ThreadCachedServiceData.h>
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include "fboss/agent/PortStats.h"
+#include "fboss/agent/SwitchStats.h"
+
+#include <memory>
+
+using namespace facebook::fboss;
+using facebook::fb303::RATE;
+using facebook::fb303::SUM;
+using facebook::fb303::ThreadCachedServiceData;
+using std::make_unique;
+using std::unique_ptr;
+
+namespace {
+// Ports trapped packets are spread across
+constexpr uint16_t kNumPorts = 128;
+constexpr uint32_t kPktBytes = 68;
+
+/*
+ * Per packet accounting as SwitchStats did it before packet counters: port
+ * stats looked up in a flat_map, and a TLTimeseries bumped for every counter.
+ */
+struct TimeseriesStats {
+  explicit TimeseriesStats(ThreadCachedServiceData::ThreadLocalStatsMap* map)
+      : trapPkts(map, "benchmark.trapped.pkts", SUM, RATE),
+        ipv4Rx(map, "benchmark.trapped.ipv4", SUM, RATE),
+        toHost(map, "benchmark.host.rx", SUM, RATE),
+        toHostBytes(map, "benchmark.host.rx.bytes", SUM, RATE) {}
+
+  ThreadCachedServiceData::TLTimeseries trapPkts;
+  ThreadCachedServiceData::TLTimeseries ipv4Rx;
+  ThreadCachedServiceData::TLTimeseries toHost;
+  ThreadCachedServiceData::TLTimeseries toHostBytes;
+  boost::container::flat_map<PortID, unique_ptr<PortStats>> ports;
+};
+
+// Global state used by the benchmarks
+unique_ptr<TimeseriesStats> timeseriesStats;
+unique_ptr<SwitchStats> switchStats;
+
+void init() {
+  timeseriesStats = make_unique<TimeseriesStats>(
+      ThreadCachedServiceData::get()->getThreadStats());
+  switchStats = make_unique<SwitchStats>();
+  for (uint16_t i = 1; i <= kNumPorts; ++i) {
+    auto name = folly::to<std::string>("port", i);
+    timeseriesStats->ports.emplace(
+        PortID(i), make_unique<PortStats>(PortID(i), name, nullptr));
+    switchStats->createPortStats(PortID(i), name);
+  }
+}
+
+} // unnamed namespace
+
+/*
+ * The counters bumped for an IPv4 packet trapped to the host, as accounted
+ * for before packet counters.
+ */
+BENCHMARK(TimeseriesAccounting, numIters) {
+  for (size_t n = 0; n < numIters; ++n) {
+    auto it = timeseriesStats->ports.find(PortID(n % kNumPorts + 1));
+    folly::doNotOptimizeAway(it);
+    timeseriesStats->trapPkts.addValue(1);
+    timeseriesStats->ipv4Rx.addValue(1);
+    timeseriesStats->toHost.addValue(1);
+    timeseriesStats->toHostBytes.addValue(kPktBytes);
+  }
+}
+
+/*
+ * The same counters bumped through PortStats, as the packet handlers do.
+ */
+BENCHMARK_RELATIVE(PacketCounterAccounting, numIters) {
+  for (size_t n = 0; n < numIters; ++n) {
+    auto portStats = switchStats->port(PortID(n % kNumPorts + 1));
+    portStats->trappedPkt();
+    portStats->ipv4Rx();
+    portStats->pktToHost(kPktBytes);
+  }
+  BENCHMARK_SUSPEND {
+    switchStats->flushPacketCounters();
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+/*
+ * The cost the flushing thread pays per SwitchStats, every second.
+ */
+BENCHMARK(FlushPacketCounters, numIters) {
+  for (size_t n = 0; n < numIters; ++n) {
+    switchStats->port(PortID(n % kNumPorts + 1))->trappedPkt();
+    switchStats->flushPacketCounters();
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  init();
+
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/ThreadHeartbeat.h"
+
+#include <folly/Conv.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace facebook::fboss;
+using namespace std::chrono;
+
+TEST(ThreadHeartbeat, profile) {
+  folly::ScopedEventBaseThread thread;
+  auto* evb = thread.getEventBase();
+  ThreadHeartbeat heartbeat(
+      evb, "testThread", 10, [](int /*delay*/, int /*backlog*/) {});
+
+  // Callbacks are only timed on the thread with the heartbeat
+  ThreadHeartbeat::callbackDone("elsewhere", milliseconds(100));
+  evb->runInEventBaseThreadAndWait([]() {
+    ThreadHeartbeat::callbackDone("fast", microseconds(10));
+    ThreadHeartbeat::callbackDone("slow", milliseconds(5));
+    ThreadHeartbeat::callbackDone("slow", milliseconds(3));
+  });
+
+  // Profiles cover the last heartbeat interval, wait for the one with the
+  // callbacks
+  ThreadProfile profile;
+  auto deadline = steady_clock::now() + seconds(10);
+  while (profile.slowestCallbacks_ref()->empty() &&
+         steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(milliseconds(1));
+    profile = heartbeat.getProfile();
+  }
+  EXPECT_EQ(*profile.name_ref(), "testThread");
+  const auto& callbacks = *profile.slowestCallbacks_ref();
+  ASSERT_EQ(callbacks.size(), 2);
+  EXPECT_EQ(*callbacks[0].name_ref(), "slow");
+  EXPECT_EQ(*callbacks[0].count_ref(), 2);
+  EXPECT_EQ(*callbacks[0].avgUsecs_ref(), 4000);
+  EXPECT_EQ(*callbacks[0].maxUsecs_ref(), 5000);
+  EXPECT_EQ(*callbacks[1].name_ref(), "fast");
+}
+
+TEST(ThreadHeartbeat, slowCallbacksNotCrowdedOut) {
+  folly::ScopedEventBaseThread thread;
+  auto* evb = thread.getEventBase();
+  ThreadHeartbeat heartbeat(
+      evb, "testThread", 10, [](int /*delay*/, int /*backlog*/) {});
+
+  // Many more distinct callbacks than are tracked, as when names carry
+  // per entity data, run before the slow one
+  evb->runInEventBaseThreadAndWait([]() {
+    for (auto i = 0; i < 5000; ++i) {
+      ThreadHeartbeat::callbackDone(
+          folly::to<std::string>("fast", i), microseconds(10 + i % 7));
+    }
+    ThreadHeartbeat::callbackDone("slow", milliseconds(5));
+  });
+
+  ThreadProfile profile;
+  auto deadline = steady_clock::now() + seconds(10);
+  while (profile.slowestCallbacks_ref()->empty() &&
+         steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(milliseconds(1));
+    profile = heartbeat.getProfile();
+  }
+  const auto& callbacks = *profile.slowestCallbacks_ref();
+  ASSERT_FALSE(callbacks.empty());
+  EXPECT_EQ(*callbacks[0].name_ref(), "slow");
+  EXPECT_EQ(*callbacks[0].maxUsecs_ref(), 5000);
+}
@@ -12,6 +12,8 @@
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/ThriftHandler.h"
 #include "fboss/agent/hw/mock/MockPlatform.h"
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/InterfaceMap.h"
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/RouteUpdater.h"
 #include "fboss/agent/state/SwitchState.h"
@@ -19,6 +21,8 @@
 #include "fboss/agent/test/TestUtils.h"
 
 #include <folly/IPAddress.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 
@@ -32,8 +36,12 @@ using folly::IPAddressV6;
 using folly::StringPiece;
 using std::shared_ptr;
 using std::unique_ptr;
+using testing::_;
+using testing::Return;
 using testing::UnorderedElementsAreArray;
 
+DECLARE_int32(route_table_stream_chunk_size);
+
 namespace {
 
 unique_ptr<HwTestHandle> setupTestHandle() {
@@ -325,3 +333,189 @@ TEST(ThriftTest, syncFib) {
   EXPECT_EQ(4 + 1, tables3->getRouteTable(rid)->getRibV4()->size());
   EXPECT_EQ(4 + 1, tables3->getRouteTable(rid)->getRibV6()->size());
 }
+
+TEST(ThriftTest, getRouteTableDetailsPage) {
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+  sw->fibSynced();
+  ThriftHandler handler(sw);
+
+  handler.addUnicastRoute(10, makeUnicastRoute("7.1.0.0/16", "10.0.0.2"));
+  handler.addUnicastRoute(10, makeUnicastRoute("7.2.0.0/16", "10.0.0.2"));
+  handler.addUnicastRoute(20, makeUnicastRoute("7.2.1.0/24", "10.0.0.3"));
+  handler.addUnicastRoute(
+      10, makeUnicastRoute("aaaa:1::0/64", "2401:db00:2110:3001::2"));
+
+  std::vector<RouteDetails> allRoutes;
+  handler.getRouteTableDetails(allRoutes);
+
+  // Walk the whole route table, a few routes at a time
+  auto getAllPages = [&handler](
+                         const RouteTableFilter& filter, int32_t pageSize) {
+    std::vector<IpPrefix> prefixes;
+    auto request = std::make_unique<RouteTablePageRequest>();
+    *request->filter_ref() = filter;
+    *request->pageSize_ref() = pageSize;
+    while (true) {
+      RouteTablePage page;
+      handler.getRouteTableDetailsPage(
+          page, std::make_unique<RouteTablePageRequest>(*request));
+      EXPECT_LE(page.routes_ref()->size(), pageSize);
+      for (const auto& route : *page.routes_ref()) {
+        prefixes.push_back(*route.dest_ref());
+      }
+      if (!page.nextCursor_ref()) {
+        break;
+      }
+      request->cursor_ref() = *page.nextCursor_ref();
+    }
+    return prefixes;
+  };
+
+  std::vector<IpPrefix> expected;
+  for (const auto& route : allRoutes) {
+    expected.push_back(*route.dest_ref());
+  }
+  EXPECT_THAT(
+      getAllPages(RouteTableFilter(), 2), UnorderedElementsAreArray(expected));
+  EXPECT_EQ(expected.size(), getAllPages(RouteTableFilter(), 1000).size());
+
+  RouteTableFilter clientFilter;
+  clientFilter.clientId_ref() = 10;
+  EXPECT_THAT(
+      getAllPages(clientFilter, 1),
+      UnorderedElementsAreArray({ipPrefix("7.1.0.0", 16),
+                                 ipPrefix("7.2.0.0", 16),
+                                 ipPrefix("aaaa:1::0", 64)}));
+
+  RouteTableFilter prefixFilter;
+  prefixFilter.prefix_ref() = ipPrefix("7.2.0.0", 16);
+  EXPECT_THAT(
+      getAllPages(prefixFilter, 1),
+      UnorderedElementsAreArray(
+          {ipPrefix("7.2.0.0", 16), ipPrefix("7.2.1.0", 24)}));
+
+  RouteTableFilter vrfFilter;
+  vrfFilter.vrf_ref() = 1;
+  EXPECT_TRUE(getAllPages(vrfFilter, 2).empty());
+
+  auto badRequest = std::make_unique<RouteTablePageRequest>();
+  *badRequest->pageSize_ref() = 0;
+  RouteTablePage page;
+  EXPECT_THROW(
+      handler.getRouteTableDetailsPage(page, std::move(badRequest)),
+      FbossError);
+}
+
+TEST(ThriftTest, getAllInterfacesTracksInterfaceChanges) {
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+  ThriftHandler handler(sw);
+
+  std::map<int32_t, InterfaceDetail> interfaces;
+  handler.getAllInterfaces(interfaces);
+  EXPECT_EQ(sw->getState()->getInterfaces()->size(), interfaces.size());
+  EXPECT_EQ("interface55", *interfaces.at(55).interfaceName_ref());
+
+  // Updates that do not touch interfaces leave the response unchanged
+  handler.setPortState(1, false);
+  std::map<int32_t, InterfaceDetail> unchanged;
+  handler.getAllInterfaces(unchanged);
+  EXPECT_EQ(interfaces, unchanged);
+
+  sw->updateStateBlocking(
+      "rename interface", [](const shared_ptr<SwitchState>& state) {
+        auto newState = state->clone();
+        auto newIntfs = newState->getInterfaces()->clone();
+        auto newIntf = newIntfs->getInterface(InterfaceID(55))->clone();
+        newIntf->setName("renamed55");
+        newIntfs->updateNode(newIntf);
+        newState->resetIntfs(newIntfs);
+        return newState;
+      });
+  std::map<int32_t, InterfaceDetail> renamed;
+  handler.getAllInterfaces(renamed);
+  EXPECT_EQ("renamed55", *renamed.at(55).interfaceName_ref());
+}
+
+TEST(ThriftTest, streamRouteTableDetails) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_route_table_stream_chunk_size = 2;
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+  sw->fibSynced();
+  ThriftHandler handler(sw);
+
+  handler.addUnicastRoute(10, makeUnicastRoute("7.1.0.0/16", "10.0.0.2"));
+  handler.addUnicastRoute(10, makeUnicastRoute("7.2.0.0/16", "10.0.0.2"));
+  handler.addUnicastRoute(
+      10, makeUnicastRoute("aaaa:1::0/64", "2401:db00:2110:3001::2"));
+
+  std::vector<RouteDetails> allRoutes;
+  handler.getRouteTableDetails(allRoutes);
+  std::vector<IpPrefix> expected;
+  for (const auto& route : allRoutes) {
+    expected.push_back(*route.dest_ref());
+  }
+
+  std::vector<size_t> chunkSizes;
+  std::vector<IpPrefix> prefixes;
+  bool completed = false;
+  folly::ScopedEventBaseThread clientThread;
+  auto subscription =
+      handler.streamRouteTableDetails(std::make_unique<RouteTableFilter>())
+          .toClientStreamUnsafeDoNotUse()
+          .subscribeExTry(
+              clientThread.getEventBase(),
+              [&](folly::Try<std::vector<RouteDetails>>&& chunk) {
+                ASSERT_FALSE(chunk.hasException());
+                if (!chunk.hasValue()) {
+                  completed = true;
+                  return;
+                }
+                chunkSizes.push_back(chunk->size());
+                for (const auto& route : *chunk) {
+                  prefixes.push_back(*route.dest_ref());
+                }
+              });
+  // Chunks are published from the background thread, wait for all of them
+  std::move(subscription).join();
+
+  EXPECT_TRUE(completed);
+  EXPECT_THAT(prefixes, UnorderedElementsAreArray(expected));
+  // Every chunk but the last is full
+  ASSERT_EQ(chunkSizes.size(), (expected.size() + 1) / 2);
+  for (size_t i = 0; i + 1 < chunkSizes.size(); ++i) {
+    EXPECT_EQ(chunkSizes[i], 2);
+  }
+  EXPECT_LE(chunkSizes.back(), 2);
+}
+
+TEST(ThriftTest, getPortInfoWhileHwOutOfSync) {
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+  ThriftHandler handler(sw);
+
+  // Have HwSwitch reject the update, so applied and desired states differ
+  auto origState = sw->getAppliedState();
+  EXPECT_HW_CALL(sw, stateChanged(_)).WillRepeatedly(Return(origState));
+  sw->updateState(
+      "describe port", [](const shared_ptr<SwitchState>& state) {
+        auto newState = state->clone();
+        auto newPort =
+            newState->getPorts()->getPort(PortID(1))->modify(&newState);
+        newPort->setDescription("desired");
+        return newState;
+      });
+  waitForStateUpdates(sw);
+  ASSERT_NE(sw->getAppliedState(), sw->getDesiredState());
+
+  // Ports are described as desired
+  PortInfoThrift portInfo;
+  handler.getPortInfo(portInfo, 1);
+  EXPECT_EQ("desired", *portInfo.description_ref());
+  std::map<int32_t, PortInfoThrift> allPortInfo;
+  handler.getAllPortInfo(allPortInfo);
+  EXPECT_EQ("desired", *allPortInfo.at(1).description_ref());
+  EXPECT_EQ(sw->getState()->getPorts()->size(), allPortInfo.size());
+}
@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/WarmBootJournal.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/MacEntry.h"
+#include "fboss/agent/state/MacTable.h"
+#include "fboss/agent/state/NdpTable.h"
+#include "fboss/agent/state/RouteUpdater.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/Format.h>
+#include <folly/experimental/TestUtil.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+using namespace facebook::fboss;
+using folly::IPAddress;
+using std::shared_ptr;
+
+DECLARE_uint32(warm_boot_journal_compact_mb);
+
+namespace {
+const ClientID kClientID(1001);
+
+shared_ptr<SwitchState> addRoute(
+    const shared_ptr<SwitchState>& state,
+    const IPAddress& network,
+    uint8_t mask) {
+  RouteUpdater updater(state->getRouteTables());
+  updater.addRoute(
+      RouterID(0),
+      network,
+      mask,
+      kClientID,
+      RouteNextHopEntry(RouteForwardAction::DROP, AdminDistance::STATIC_ROUTE));
+  auto newState = state->clone();
+  newState->resetRouteTables(updater.updateDone());
+  newState->publish();
+  return newState;
+}
+
+shared_ptr<SwitchState> delRoute(
+    const shared_ptr<SwitchState>& state,
+    const IPAddress& network,
+    uint8_t mask) {
+  RouteUpdater updater(state->getRouteTables());
+  updater.delRoute(RouterID(0), network, mask, kClientID);
+  auto newState = state->clone();
+  newState->resetRouteTables(updater.updateDone());
+  newState->publish();
+  return newState;
+}
+
+void checkReplay(
+    const std::string& path,
+    const shared_ptr<SwitchState>& state) {
+  auto replayed = SwitchState::fromFollyDynamic(WarmBootJournal::replay(path));
+  EXPECT_EQ(replayed->toFollyDynamic(), state->toFollyDynamic());
+}
+
+class WarmBootJournalTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = WarmBootJournal::path(tmpDir_.path().string());
+    state_ = testStateA();
+    state_->publish();
+    journal_ = std::make_unique<WarmBootJournal>(path_);
+    journal_->checkpoint(state_);
+  }
+
+  void apply(shared_ptr<SwitchState> newState) {
+    newState->publish();
+    journal_->append(StateDelta(state_, newState));
+    state_ = newState;
+  }
+
+  folly::test::TemporaryDirectory tmpDir_;
+  std::string path_;
+  shared_ptr<SwitchState> state_;
+  std::unique_ptr<WarmBootJournal> journal_;
+};
+} // namespace
+
+TEST_F(WarmBootJournalTest, replaySnapshot) {
+  journal_->sync();
+  checkReplay(path_, state_);
+}
+
+TEST_F(WarmBootJournalTest, replayChanges) {
+  apply(addRoute(state_, IPAddress("10.10.0.0"), 16));
+  apply(addRoute(state_, IPAddress("2401:db00:10::"), 48));
+  apply(bringAllPortsUp(state_));
+  apply(delRoute(state_, IPAddress("10.10.0.0"), 16));
+
+  auto newState = state_->clone();
+  newState->getVlans()->modify(&newState)->removeNode(VlanID(55));
+  newState->setDefaultVlan(VlanID(1));
+  apply(newState);
+
+  journal_->sync();
+  checkReplay(path_, state_);
+}
+
+TEST_F(WarmBootJournalTest, compaction) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_warm_boot_journal_compact_mb = 0;
+
+  // Compaction completes in the background, while changes keep coming. It
+  // is picked up by the next change or sync.
+  auto compacted = false;
+  for (auto i = 0; i < 200; ++i) {
+    auto size = journal_->size();
+    apply(addRoute(state_, IPAddress(folly::sformat("10.{}.0.0", i)), 16));
+    compacted |= journal_->size() < size;
+  }
+  auto size = journal_->size();
+  journal_->sync();
+  compacted |= journal_->size() < size;
+  EXPECT_TRUE(compacted);
+  checkReplay(path_, state_);
+}
+
+TEST_F(WarmBootJournalTest, replayVlanTables) {
+  const VlanID kVlan(1);
+  const InterfaceID kIntf(1);
+  const PortDescriptor kPort(PortID(1));
+  auto newState = state_->clone();
+  auto arpTable = newState->getVlans()->getVlan(kVlan)->getArpTable()->modify(
+      kVlan, &newState);
+  arpTable->addEntry(
+      folly::IPAddressV4("10.0.0.2"),
+      folly::MacAddress("02:00:00:00:00:02"),
+      kPort,
+      kIntf);
+  arpTable->addEntry(
+      folly::IPAddressV4("10.0.0.3"),
+      folly::MacAddress("02:00:00:00:00:03"),
+      kPort,
+      kIntf);
+  auto ndpTable = newState->getVlans()->getVlan(kVlan)->getNdpTable()->modify(
+      kVlan, &newState);
+  ndpTable->addEntry(
+      folly::IPAddressV6("2401:db00:2110:3001::2"),
+      folly::MacAddress("02:00:00:00:00:02"),
+      kPort,
+      kIntf);
+  auto macTable = newState->getVlans()->getVlan(kVlan)->getMacTable()->modify(
+      kVlan, &newState);
+  macTable->addEntry(std::make_shared<MacEntry>(
+      folly::MacAddress("02:00:00:00:00:04"), kPort));
+  apply(newState);
+
+  // Change the VLAN itself, which keeps its tables
+  newState = state_->clone();
+  newState->getVlans()->getVlan(kVlan)->modify(&newState)->setName("renamed");
+  apply(newState);
+
+  newState = state_->clone();
+  arpTable = newState->getVlans()->getVlan(kVlan)->getArpTable()->modify(
+      kVlan, &newState);
+  arpTable->removeEntry(folly::IPAddressV4("10.0.0.2"));
+  apply(newState);
+
+  journal_->sync();
+  checkReplay(path_, state_);
+}
+
+TEST_F(WarmBootJournalTest, incompleteRecord) {
+  apply(addRoute(state_, IPAddress("10.10.0.0"), 16));
+  auto complete = state_;
+  apply(addRoute(state_, IPAddress("10.11.0.0"), 16));
+  auto size = journal_->size();
+  journal_.reset();
+
+  // Cut the last change short, as if the agent crashed while writing it
+  ASSERT_EQ(truncate(path_.c_str(), size - 1), 0);
+  checkReplay(path_, complete);
+}
+
+TEST_F(WarmBootJournalTest, noJournal) {
+  EXPECT_THROW(
+      WarmBootJournal::replay(WarmBootJournal::path("/nonexistent")),
+      FbossError);
+}
+
+TEST_F(WarmBootJournalTest, appendBeforeCheckpoint) {
+  WarmBootJournal journal(WarmBootJournal::path(tmpDir_.path().string()));
+  EXPECT_THROW(
+      journal.append(
+          StateDelta(state_, addRoute(state_, IPAddress("10.10.0.0"), 16))),
+      FbossError);
+}
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/small_vector.h>
+
+namespace facebook::fboss {
+/*
+ * Interner hands out a single shared, immutable copy of every distinct value
+ * it is given. Values that compare equal are backed by the same object, so
+ * interned values can be compared by pointer, and many owners of equal
+ * values (e.g. routes sharing an ECMP next hop set) pay for a single copy.
+ *
+ * A value is dropped from the interner once the last reference to it goes
+ * away. Interner is thread safe. Since interned values may outlive any
+ * particular scope, interners are meant to be process wide singletons
+ * created with Interner::get().
+ */
+template <typename T, typename Hash = std::hash<T>>
+class Interner {
+ public:
+  using Ptr = std::shared_ptr<const T>;
+
+  Interner() {}
+  Interner(const Interner& other) = delete;
+  Interner& operator=(const Interner& other) = delete;
+
+  /*
+   * Leaked singleton, so values released during static destruction still
+   * find their interner.
+   */
+  static Interner* get() {
+    static auto* interner = new Interner();
+    return interner;
+  }
+
+  Ptr intern(T value) {
+    auto hash = Hash()(value);
+    auto locked = entries_.lock();
+    auto& bucket = (*locked)[hash];
+    for (auto& entry : bucket) {
+      if (*entry.value == value) {
+        // The value may be on its way out, with its deleter waiting for
+        // the lock. It then gets replaced below.
+        if (auto existing = entry.ref.lock()) {
+          return existing;
+        }
+      }
+    }
+    auto raw = new T(std::move(value));
+    Ptr ptr(raw, [this, hash](const T* v) { release(hash, v); });
+    for (auto& entry : bucket) {
+      if (*entry.value == *raw) {
+        entry = Entry{raw, ptr};
+        return ptr;
+      }
+    }
+    bucket.push_back(Entry{raw, ptr});
+    return ptr;
+  }
+
+  size_t size() const {
+    size_t count = 0;
+    auto locked = entries_.lock();
+    for (const auto& bucket : *locked) {
+      count += bucket.second.size();
+    }
+    return count;
+  }
+
+ private:
+  struct Entry {
+    const T* value;
+    std::weak_ptr<const T> ref;
+  };
+
+  void release(size_t hash, const T* v) {
+    {
+      auto locked = entries_.lock();
+      auto itr = locked->find(hash);
+      if (itr != locked->end()) {
+        auto& bucket = itr->second;
+        for (auto entry = bucket.begin(); entry != bucket.end(); ++entry) {
+          // Only drop the entry if it wasn't already replaced
+          if (entry->value == v) {
+            bucket.erase(entry);
+            break;
+          }
+        }
+        if (bucket.empty()) {
+          locked->erase(itr);
+        }
+      }
+    }
+    delete v;
+  }
+
+  folly::Synchronized<
+      folly::F14FastMap<size_t, folly::small_vector<Entry, 1>>,
+      std::mutex>
+      entries_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/Interner.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace facebook::fboss;
+
+namespace {
+// Send every value to the same bucket to exercise collisions
+struct CollidingHash {
+  size_t operator()(const std::string& /* s */) const {
+    return 0;
+  }
+};
+} // namespace
+
+TEST(Interner, equalValuesShared) {
+  Interner<std::string> interner;
+  auto a1 = interner.intern("a");
+  auto a2 = interner.intern("a");
+  auto b = interner.intern("b");
+  EXPECT_EQ(a1, a2);
+  EXPECT_NE(a1, b);
+  EXPECT_EQ(*a1, "a");
+  EXPECT_EQ(interner.size(), 2);
+}
+
+TEST(Interner, releasedWithLastRef) {
+  Interner<std::string> interner;
+  auto a1 = interner.intern("a");
+  auto a2 = interner.intern("a");
+  a1.reset();
+  EXPECT_EQ(interner.size(), 1);
+  a2.reset();
+  EXPECT_EQ(interner.size(), 0);
+  auto a3 = interner.intern("a");
+  EXPECT_EQ(*a3, "a");
+  EXPECT_EQ(interner.size(), 1);
+}
+
+TEST(Interner, hashCollisions) {
+  Interner<std::string, CollidingHash> interner;
+  auto a = interner.intern("a");
+  auto b = interner.intern("b");
+  EXPECT_NE(a, b);
+  EXPECT_EQ(interner.intern("a"), a);
+  EXPECT_EQ(interner.intern("b"), b);
+  a.reset();
+  EXPECT_EQ(interner.size(), 1);
+  EXPECT_EQ(interner.intern("b"), b);
+}